@@ -28,12 +28,27 @@ using namespace Schnapsen;
 
 #include "debug.h"
 #include "Util.cxx"
+#include "Config.cxx"
+#include "Log.cxx"
+#include "Trace.cxx"
+#include "Animator.cxx"
+#include "Idle.cxx"
 #include "CardImage.cxx"
 #include "Card.cxx"
 #include "Cards.cxx"
 #include "GameBook.cxx"
-#include "Unittest.cxx"
+#include "StatsStore.cxx"
+#include "EngineParams.cxx"
+#include "EngineStats.cxx"
 #include "Engine.cxx"
+#include "GameLog.cxx"
+#include "SelfPlay.cxx"
+#include "Solver.cxx"
+#include "Review.cxx"
+#include "GameFlow.cxx"
+#include "GameFile.cxx"
+#include "GameRecord.cxx"
+#include "GameIndex.cxx"
 #include "Welcome.cxx"
 #include "Selector.cxx"
 #include "Alert.cxx"
@@ -53,6 +68,7 @@ int main(int argc_, char *argv_[])
 #ifdef _WIN32
 	Console console;	// output goes to command window (if started from there)
 #endif
+	Fl::lock(); // enable Fl::awake() from worker threads
 	Fl::keyboard_screen_scaling(0); // disable keyboard scaling - we do that ourselves
 	fl_message_title_default(Util::message(TITLE).c_str());
 	fl_message_hotspot(0);
@@ -60,11 +76,17 @@ int main(int argc_, char *argv_[])
 	Fl::background(240, 240, 240); // brighter color for message background
 	srand(time(nullptr));
 	Util::load_config();
-	Util::load_stats();
 	if (Args::parse(argc_, argv_) == false)
 	{
 		exit(EXIT_FAILURE);
 	}
+	std::string trace = Util::config("trace");
+	if (trace.size())
+	{
+		Util::config("trace", std::string()); // don't save trace request!
+		Trace::start(trace);
+	}
+	Idle::init();
 	LOG(Args::arg0 << " " << VERSION << " [" << Util::home_dir() << "]\n");
 	fl_message_title_default(Util::message(TITLE).c_str()); // redo ... maybe language changed
 	try
@@ -76,12 +98,12 @@ int main(int argc_, char *argv_[])
 		if (Fl::get_key(FL_Control_L)) // reset config file by pressing 'Ctrl' key at startup
 		{
 			Util::config().clear();
+			Config::sync();
 			WNG("configuration reset\n");
 		}
 		if (Fl::screen_scale(deck.screen_num()) != 1)
 			Fl::screen_scale(deck.screen_num(), 1);
-		std::optional welcome = Util::config_value("welcome");
-		if ((!welcome || atoi(welcome.value().c_str())) && game_to_load.empty())
+		if (Config::as_bool(Config::WELCOME) && game_to_load.empty())
 		{
 			deck.welcome();
 		}
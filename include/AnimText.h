@@ -1,23 +1,37 @@
 #pragma once
 
+#include <chrono>
 #include <string>
+#include <vector>
 
 class UI;
 
+//
+// Text that appears character by character (UTF-8 and markup aware).
+// The byte length of the text at each step is computed once, a step
+// then just appends the next characters. All instances are advanced
+// by one shared timer, that only runs while some text is appearing.
+//
 class AnimText
 {
 public:
+	typedef std::chrono::steady_clock Clock;
 	AnimText(const std::string &m_, UI &ui_, double speed_ = 1./60);
 	~AnimText();
-	static void cb_anim(void *d_) { (static_cast<AnimText *>(d_))->on_animate(); }
-	void on_animate();
 	std::string &text();
 	bool done() const;
+	const std::vector<size_t> &offsets() const { return _offsets; }	// (for tests)
+private:
+	static void cb_anim(void *d_);
+	bool on_animate(Clock::time_point now_);
 private:
 	std::string _m;
 	UI &_ui;
 	double _speed;
+	Clock::time_point _start;
 	size_t _display_len;
-	bool _needs_update;
+	std::vector<size_t> _offsets;	// byte length of text by display length
 	std::string _res;
+	static std::vector<AnimText *> _running;
+	static double _interval;	// of shared timer
 };
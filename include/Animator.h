@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//
+// Animation scheduler driven by a monotonic clock.
+// Each animation has a start (optional delay), a duration and an
+// easing curve, any number of them may run at the same time.
+// frame() samples the clock once per frame, so all animations of
+// a frame use the same time and progress does not depend on how
+// long drawing takes: a slow frame just skips intermediate frames.
+//
+class Animator
+{
+public:
+	typedef std::chrono::steady_clock Clock;
+	enum class Easing { LINEAR, EASE_IN_OUT, EASE_OUT };
+	struct Stats
+	{
+		uint64_t frames = 0;
+		uint64_t skipped = 0;		// frames missed due to slow frames
+		double frame_time = 0.;		// sum of frame intervals (s)
+		double max_frame_time = 0.;
+	};
+	explicit Animator(double interval_ = 1./60) : _interval(interval_), _next_id(0), _in_run(false) {}
+	size_t add(double duration_, Easing easing_ = Easing::EASE_IN_OUT, double delay_ = 0.)
+	{
+		return add(Clock::now(), duration_, easing_, delay_);
+	}
+	size_t add(Clock::time_point start_, double duration_, Easing easing_ = Easing::EASE_IN_OUT, double delay_ = 0.);
+	void frame() { frame(Clock::now()); }
+	void frame(Clock::time_point now_);
+	double progress(size_t id_) const;
+	bool running() const;
+	void clear();
+	double interval() const { return _interval; }
+	const Stats &stats() const { return _stats; }
+	void reset_stats() { _stats = {}; }
+	static double ease(Easing easing_, double t_);
+private:
+	struct Anim
+	{
+		size_t id;
+		Clock::time_point start;
+		double duration;
+		Easing easing;
+		double progress;	// eased, at last frame
+		bool done;		// reached end at last frame (removed at next)
+	};
+	double _interval;		// target frame interval (s)
+	size_t _next_id;
+	std::vector<Anim> _anims;
+	Clock::time_point _last_frame;	// (of running animations)
+	bool _in_run;
+	Stats _stats;
+};
@@ -33,9 +33,11 @@ public:
 	explicit Card(CardFace f_, CardSuite s_);
 	Card& load(bool force_ = false);
 	Card& reload() { return load(true); }
-	auto image(int w_ = 0, int h_ = 0) { load(); return _images.image(name(), w_, h_); }
-	auto rot90_image() { load(); return _images.rot90_image(name()); }
-	auto skewed_image() { load(); return _images.skewed_image(name()); }
+	auto image(int w_ = 0, int h_ = 0) { load(); return _images.image(w_, h_); }
+	auto rot90_image() { load(); return _images.rot90_image(); }
+	auto rot90_image(int w_, int h_) { load(); return _images.rot90_image(w_, h_); }
+	auto skewed_image() { load(); return _images.skewed_image(); }
+	auto highlighted_image() { load(); return _images.highlighted_image(); }
 	Card& rect(const Rect &rect_) { _rect = rect_; return *this; }
 	CardSuite suite() const { return _s; }
 	CardFace face() const { return _f; }
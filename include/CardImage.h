@@ -1,24 +1,158 @@
 #pragma once
 
 class Fl_RGB_Image;
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
+//
+// Images of cards (and card backs, shadows...).
+// The source images are loaded once per id. The images for
+// drawing are cached per (id, load generation, variant, pixel size)
+// with LRU eviction within a memory budget (config 'image-cache' in MB).
+// Eviction is done by trim() only, so the returned images stay valid
+// until then (called at begin of drawing).
+// prerender() queues SVG images to a pool of worker threads, that
+// parse and rasterize them into plain pixel buffers (the images for
+// drawing are made by the main thread). Until an image is ready a
+// placeholder is returned. The windows are redrawn when it has arrived
+// and it is taken into the cache by trim() (only if still of the
+// current size).
+// Derived variants (skewed, rotated, highlighted, grayout) are built
+// once per size from the scaled image and cached like it, so drawing
+// a frame does not allocate images once all variants are in the cache.
+//
 class CardImage
 {
 public:
+	enum class Variant : uint8_t { SCALED, SKEWED, ROT90, ROT90_SIZED, HIGHLIGHTED, GRAYOUT };
+	struct Stats
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t evictions = 0;
+		uint64_t placeholders = 0;
+		uint64_t prerendered = 0;
+		size_t entries = 0;
+		size_t bytes = 0;
+	};
+	CardImage() : _id(NONE) {}
 	CardImage& image(const std::string &id_, const std::string &pathname_, bool data_ = false);
 	Fl_RGB_Image *image(const std::string &id_, int w_ = 0, int h_ = 0) const;
-	Fl_RGB_Image *image() const;
+	Fl_RGB_Image *image(int w_ = 0, int h_ = 0) const;
 	Fl_RGB_Image *skewed_image(const std::string &id_);
 	Fl_RGB_Image *rot90_image(const std::string &id_);
 	Fl_RGB_Image *rot90_image();
+	Fl_RGB_Image *rot90_image(int w_, int h_);
 	Fl_RGB_Image *skewed_image();
+	Fl_RGB_Image *highlighted_image();
+	Fl_RGB_Image *grayout_image(int w_, int h_);
+	CardImage& declare(const std::string &id_, const std::string &pathname_, bool data_ = false);
+	bool loaded() const { return _id != NONE && _sources[_id].generation; }
+	bool find(const std::string &id_);
 	CardImage &set_pixel_size(int w_, int h_);
+	static void prerender(const std::vector<std::string> &ids_, int w_, int h_);
+	static void collect();
+	static void trim();
+	static void clear();
+	static const Stats &stats() { return _stats; }
+	static void rotate_90_CCW(const uint8_t *src_, uint8_t *dst_, int w_, int h_, int d_, int ld_ = 0);
+private:
+	struct Key
+	{
+		uint32_t id;
+		uint32_t generation;
+		uint16_t w;
+		uint16_t h;
+		Variant variant;
+		bool operator == (const Key &) const = default;
+	};
+	struct KeyHash
+	{
+		size_t operator () (const Key &k_) const
+		{
+			uint64_t v = ((uint64_t)k_.id << 32 | k_.generation) ^
+			             ((uint64_t)k_.w << 40 | (uint64_t)k_.h << 16 | (uint64_t)k_.variant) * 0x9E3779B97F4A7C15ull;
+			return std::hash<uint64_t>()(v);
+		}
+	};
+	struct Entry
+	{
+		Key key;
+		Fl_RGB_Image *image;
+		size_t bytes;
+	};
+	struct Source
+	{
+		std::string name;
+		std::string pathname;		// (or SVG data)
+		Fl_RGB_Image *image = nullptr;
+		uint32_t generation = 0;	// 0 = not declared
+		bool data = false;
+	};
+	struct Job
+	{
+		uint32_t id;
+		uint32_t generation;
+		std::string name;
+		std::string pathname;		// (or SVG data)
+		bool data;
+		int w;
+		int h;
+		// results: RGBA pixels (nullptr if not rasterized)
+		std::unique_ptr<uint8_t[]> scaled;
+		std::unique_ptr<uint8_t[]> rot90;
+	};
+	static constexpr uint32_t NONE = ~0u;
+	static uint32_t intern(const std::string &id_);
+	static Fl_RGB_Image *load(const std::string &id_, std::string &pathname_, bool data_);
+	static Fl_RGB_Image *rotate_90_CCW(const Fl_RGB_Image &svg_);
+	static Fl_RGB_Image *rasterize(const Fl_RGB_Image &source_, int w_, int h_);
+	static Fl_RGB_Image *placeholder(int w_, int h_);
+	static bool ready(uint32_t id_);
+	static bool pending(const Key &key_);
+	static bool pending_source(uint32_t id_);
+	static void render(Job &job_);
+	static void work();
+	static void stop_workers();
+	static Fl_RGB_Image *rgb_image(std::unique_ptr<uint8_t[]> &pixels_, int w_, int h_);
+	static void take(Job &job_);
+	static Fl_RGB_Image *cached(const Key &key_);
+	static Fl_RGB_Image *insert(const Key &key_, Fl_RGB_Image *image_);
+	static Fl_RGB_Image *scaled(uint32_t id_, int w_, int h_);
+	static Fl_RGB_Image *skewed(uint32_t id_);
+	static Fl_RGB_Image *rot90(uint32_t id_);
+	static Fl_RGB_Image *rot90(uint32_t id_, int w_, int h_);
+	static Fl_RGB_Image *highlighted(uint32_t id_);
+	static Fl_RGB_Image *grayout(uint32_t id_, int w_, int h_);
+	static void drop(uint32_t id_);
 private:
 	static int _W;
 	static int _H;
-	std::string _last_id;
-	static std::unordered_map<std::string, Fl_RGB_Image *> _images;
-	std::string _pathname;
+	uint32_t _id;
+	static std::unordered_map<std::string, uint32_t> _ids;
+	static std::vector<Source> _sources;		// by id
+	static std::list<Entry> _lru;			// most recently used first
+	static std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> _cache;
+	static uint32_t _generation;
+	static Stats _stats;
+	static std::unordered_set<Key, KeyHash> _jobs;	// images being prerendered
+	static int _prerender_w;			// size of current prerender()
+	static int _prerender_h;
+	// worker pool (the queue and results are shared with the workers)
+	static std::mutex _mutex;
+	static std::condition_variable _wakeup;
+	static std::deque<std::unique_ptr<Job>> _queue;
+	static std::vector<std::unique_ptr<Job>> _done;
+	static std::vector<std::thread> _workers;
+	static bool _stopping;
 };
@@ -14,9 +14,13 @@ class Cards : public Cards_
 {
 public:
 	Cards();
+	Cards(const Cards &cards_);
+	Cards(Cards &&cards_);
 	Cards(const Cards_ &cards_);
 	explicit Cards(const Card &card_);
 	explicit Cards(const std::string &s_);
+	Cards& operator = (const Cards &c_) = default;
+	Cards& operator = (Cards &&c_) = default;
 	Cards operator = (const std::string &s_);
 	Cards operator += (const Cards &c_);
 	Cards operator + (const Cards &c_) const;
@@ -44,5 +48,6 @@ public:
 	Cards& sort_by_value(bool high_to_low = true);
 	int value() const;
 	static Cards fullcards(CardSuite suite_ = CardSuite::ANY_SUITE);
+	static size_t &constructed(); // Cards objects constructed by this thread
 	virtual std::ostream &printOn(std::ostream &os_) const;
 };
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+//
+// Typed registry of the config values that are read often.
+// Each key is declared once (name, type, default). The value is
+// parsed when it is set (via Util::config()) and kept in a table,
+// so reading is an array access. Listeners are notified of changes.
+// All other config values are only kept as strings in Util::config().
+//
+class Config
+{
+public:
+	enum Key
+	{
+		LOGLEVEL,
+		LOGFILE,
+		FAST,
+		LANG,
+		STRICT,
+		ANIMATE,
+		TRUMP_SORT,
+		TEXT_SHADOW,
+		WELCOME,
+		FULLSCREEN,
+		IMAGE_CACHE,
+		IDLE_TIME,
+		KEYS
+	};
+	enum class Type { INT, BOOL, STRING };
+	typedef std::function<void(Key)> Listener;
+
+	static int as_int(Key key_) { return values()[key_].i; }
+	static bool as_bool(Key key_) { return values()[key_].i != 0; }
+	static const std::string &as_string(Key key_) { return values()[key_].str; }
+	static const char *name(Key key_);
+	static void update(const std::string &name_);
+	static void sync();
+	static size_t listen(const Listener &listener_);
+	static void unlisten(size_t id_);
+private:
+	struct Value
+	{
+		std::string str;
+		int i;
+	};
+	struct Decl
+	{
+		const char *name;
+		Type type;
+		const char *def;
+	};
+	static const Decl decls[KEYS];
+	static Value *values();
+	static bool parse(Key key_);
+};
@@ -4,6 +4,9 @@
 #include "Cards.h"
 #include "Deck.h"
 #include "GameBook.h"
+#include "EngineParams.h"
+#include "EngineStats.h"
+#include <utility>
 #include <vector>
 
 struct PlayerData
@@ -115,12 +118,19 @@ public:
 	Move default_move() const { return default_move(_ai.cards); }
 	Engine& sort_cards(Cards &cards_);
 	Player check_trick(Player move_);
+	void score_trick();
+	Result test_end() const;
+	std::pair<int, int> game_points(int strictness_) const;
 	void do_close(PlayerData &player_);
-	bool unit_tests();
 	Suites possible_marriages() const;
 	bool marriage_possible(CardSuite s_) const;
 	bool marriage_40_possible() const;
 	void init();
+	const EngineParams &params() const { return _params; }
+	void params(const EngineParams &params_) { _params = params_; }
+	const Decision &decision() const { return _decision; }
+private:
+	void choose(const Move &move_, const char *branch_);
 private:
 	GameData &_game;
 	PlayerData &_player;
@@ -128,4 +138,6 @@ private:
 	UI &_ui;
 	Move _move;
 	Cards _exclude_cards;
+	EngineParams _params;
+	Decision _decision;
 };
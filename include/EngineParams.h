@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Util.h"
+#include <string>
+#include <vector>
+
+//
+// Tunable thresholds of the AI heuristics.
+// Stored in config as "engine-<name>=<value>".
+//
+struct EngineParams
+{
+	EngineParams();
+	explicit EngineParams(const string_map &values_) : EngineParams() { load(values_); }
+	int safe_score;         // score that saves from losing 2/3 game points
+	int low_card;           // don't waste a trump on cards up to this value
+	int pull_before_40;     // try to pull trumps before 40, if score + this < 66
+	int pull_trump;         // min. trump value to pull trumps with before 40
+	int close_trick_gain;   // expected gain per highest card when testing to close
+	int closed_lead_danger; // player score (incl. gain) to defend before pack clear
+	int high_card;          // rather trick than give away a card of this value
+	int tear_marriage;      // score that allows to tear a 20/40 for a trick
+	int lead_low;           // max. value of a "safe" non trump card to lead
+	int pull_value;         // min. value of a trump to pull first in end game
+
+	struct Param
+	{
+		const char *name;
+		int EngineParams::*value;
+		int min;
+		int max;
+	};
+	static const std::vector<Param>& list();
+	void load(const string_map &values_);
+	void save(string_map &values_) const;
+	std::string to_string() const;
+	bool operator == (const EngineParams &) const = default;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <map>
+#include <string>
+
+//
+// Instrumentation of a single AI decision (Engine::ai_move()).
+//
+struct Decision
+{
+	Decision() : branch(""), us(0), cards(0), calls(0), depth(0), level(0) {}
+	const char *branch; // branch that made the final choice
+	double us;          // wall time
+	size_t cards;       // Cards objects constructed (each allocates)
+	int    calls;       // calls of decision routines
+	int    depth;       // max. nesting of decision routines
+	int    level;       // current nesting
+};
+
+//
+// Counters and histograms over many decisions (headless runs).
+//
+class EngineStats
+{
+public:
+	EngineStats() : _decisions(0), _us(0), _cards(0), _calls(0), _max_depth(0), _time{}, _alloc{} {}
+	void add(const Decision &d_);
+	void merge(const EngineStats &s_);
+	size_t decisions() const { return _decisions; }
+	std::string to_string() const;
+private:
+	static size_t bucket(double value_);
+private:
+	size_t _decisions;
+	double _us;
+	size_t _cards;
+	size_t _calls;
+	int _max_depth;
+	std::map<std::string, size_t> _branches;
+	std::array<size_t, 16> _time;   // log2 buckets of µs
+	std::array<size_t, 16> _alloc;  // log2 buckets of Cards constructions
+};
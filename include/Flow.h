@@ -0,0 +1,245 @@
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+//
+// Game flow as C++20 coroutines.
+// A Task starts when it is awaited (or by start()) and resumes the
+// awaiting coroutine when it has finished, so a flow is written like
+// nested function calls. A coroutine suspends on Resumer::wait() and
+// continues when the resumer is triggered (by a timer or an event),
+// so no event loop has to spin while the flow waits.
+//
+class Flow
+{
+public:
+	template <typename T = void>
+	class Task;
+
+	class Resumer
+	{
+	public:
+		struct Awaiter
+		{
+			Resumer &resumer;
+			bool await_ready() const noexcept { return false; }
+			void await_suspend(std::coroutine_handle<> h_) noexcept { resumer._handle = h_; }
+			void await_resume() const noexcept {}
+		};
+		Awaiter wait() { return Awaiter{ *this }; }
+		bool waiting() const { return (bool)_handle; }
+		void resume()
+		{
+			// continue suspended coroutine (if any)
+			if (std::coroutine_handle<> h = std::exchange(_handle, nullptr))
+				h.resume();
+		}
+	private:
+		std::coroutine_handle<> _handle;
+	};
+
+	//
+	// Synchronous code (e.g. the engine, which calls the UI) run within
+	// a flow: run() executes it on its own thread, strictly alternating
+	// with the flow. A call of suspend() from that code hands a task to
+	// the flow and blocks until the flow has awaited it, so UI calls
+	// stay plain function calls for the code, but are awaited (not run
+	// in nested event loops) by the flow.
+	//
+	class Fiber
+	{
+	public:
+		Task<void> run(std::function<void()> fn_);
+		void suspend(std::function<Task<void>()> task_);
+		bool inside() const { return _id == std::this_thread::get_id(); }
+	private:
+		struct Cancelled {};
+		std::mutex _mutex;
+		std::condition_variable _cond;
+		bool _fiber_turn = false;	// fiber runs (flow blocked) or vice versa
+		bool _done = false;
+		bool _cancelled = false;	// flow destroyed while awaiting a task
+		std::function<Task<void>()> _task;
+		std::exception_ptr _exception;	// of awaited task (rethrown in fiber)
+		std::thread::id _id;
+	};
+private:
+	template <typename T>
+	struct Promise;
+	struct PromiseBase
+	{
+		struct FinalAwaiter
+		{
+			bool await_ready() const noexcept { return false; }
+			template <typename P>
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h_) noexcept
+			{
+				// continue with awaiting coroutine (if any)
+				std::coroutine_handle<> c = h_.promise().continuation;
+				return c ? c : std::noop_coroutine();
+			}
+			void await_resume() const noexcept {}
+		};
+		std::suspend_always initial_suspend() const noexcept { return {}; }
+		FinalAwaiter final_suspend() const noexcept { return {}; }
+		void unhandled_exception() { exception = std::current_exception(); }
+		std::coroutine_handle<> continuation;
+		std::exception_ptr exception;
+	};
+};
+
+template <typename T>
+struct Flow::Promise : Flow::PromiseBase
+{
+	Task<T> get_return_object();
+	void return_value(T value_) { value = std::move(value_); }
+	T result()
+	{
+		if (exception) std::rethrow_exception(exception);
+		return std::move(*value);
+	}
+	std::optional<T> value;
+};
+
+template <>
+struct Flow::Promise<void> : Flow::PromiseBase
+{
+	Task<void> get_return_object();
+	void return_void() {}
+	void result()
+	{
+		if (exception) std::rethrow_exception(exception);
+	}
+};
+
+template <typename T>
+class Flow::Task
+{
+public:
+	typedef Flow::Promise<T> promise_type;
+	explicit Task(std::coroutine_handle<promise_type> h_) : _handle(h_) {}
+	Task(Task &&t_) noexcept : _handle(std::exchange(t_._handle, nullptr)) {}
+	Task &operator = (Task &&t_) noexcept
+	{
+		if (this != &t_)
+		{
+			if (_handle) _handle.destroy();
+			_handle = std::exchange(t_._handle, nullptr);
+		}
+		return *this;
+	}
+	Task(const Task &) = delete;
+	~Task() { if (_handle) _handle.destroy(); }
+	void start() { _handle.resume(); }	// (top level task)
+	bool done() const { return !_handle || _handle.done(); }
+	T result() { return _handle.promise().result(); }
+	bool await_ready() const noexcept { return false; }
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> c_) noexcept
+	{
+		_handle.promise().continuation = c_;
+		return _handle;
+	}
+	T await_resume() { return _handle.promise().result(); }
+private:
+	std::coroutine_handle<promise_type> _handle;
+};
+
+template <typename T>
+inline Flow::Task<T> Flow::Promise<T>::get_return_object()
+{
+	return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Flow::Task<void> Flow::Promise<void>::get_return_object()
+{
+	return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+inline Flow::Task<void> Flow::Fiber::run(std::function<void()> fn_)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	std::exception_ptr exception;
+	_fiber_turn = true;
+	_done = false;
+	_cancelled = false;
+	std::thread thread([this, &fn_, &exception]()
+	{
+		std::unique_lock<std::mutex> lock(_mutex);	// (until the flow waits)
+		lock.unlock();
+		try
+		{
+			fn_();
+		}
+		catch (const Cancelled &)
+		{
+		}
+		catch (...)
+		{
+			exception = std::current_exception();
+		}
+		lock.lock();
+		_done = true;
+		_fiber_turn = false;
+		_cond.notify_all();
+	});
+	_id = thread.get_id();
+	struct Join
+	{
+		// (also when the flow is destroyed while awaiting a task)
+		Fiber &fiber;
+		std::thread &thread;
+		~Join()
+		{
+			std::unique_lock<std::mutex> lock(fiber._mutex);
+			if (!fiber._done)
+			{
+				fiber._cancelled = true;
+				fiber._fiber_turn = true;
+				fiber._cond.notify_all();
+			}
+			lock.unlock();
+			thread.join();
+			fiber._id = std::thread::id();
+		}
+	} join{ *this, thread };
+	for (;;)
+	{
+		_cond.wait(lock, [this]() { return !_fiber_turn; });
+		if (_done) break;
+		std::function<Task<void>()> task = std::exchange(_task, nullptr);
+		lock.unlock();
+		try
+		{
+			co_await task();
+		}
+		catch (...)
+		{
+			_exception = std::current_exception();
+		}
+		lock.lock();
+		_fiber_turn = true;
+		_cond.notify_all();
+	}
+	lock.unlock();
+	if (exception) std::rethrow_exception(exception);
+}
+
+inline void Flow::Fiber::suspend(std::function<Task<void>()> task_)
+{
+	// (called by the code run by the fiber)
+	std::unique_lock<std::mutex> lock(_mutex);
+	_task = std::move(task_);
+	_fiber_turn = false;
+	_cond.notify_all();
+	_cond.wait(lock, [this]() { return _fiber_turn; });
+	if (_cancelled) throw Cancelled();
+	if (std::exception_ptr e = std::exchange(_exception, nullptr))
+		std::rethrow_exception(e);
+}
@@ -20,7 +20,7 @@ public:
 	std::string str() const;
 	std::vector<std::pair<int, int>> to_value(const std::string &str_);
 	GameBook& from_str(const std::string &str_);
-	GameBook& history(const std::string &history_);
+	GameBook& history(const std::deque<std::vector<std::pair<int, int>>> &gamebooks_);
 	void draw(Rect r_);
 	void reset_current() { _current = 0; }
 	GameBook& next_current();
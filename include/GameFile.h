@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Engine.h"
+#include <string>
+
+//
+// Position file (.scg) handling.
+// Optional annotations for test suites:
+//   best_move:  expected move(s) of the side to move
+//   avoid_move: move(s) that must not be played
+//
+struct Annotation
+{
+	Cards best;
+	Cards avoid;
+};
+
+class GameFile
+{
+public:
+	static bool load(const std::string &name_, GameData &game_, PlayerData &player_, PlayerData &ai_,
+	                 Annotation *annotation_ = nullptr);
+	static bool save(const std::string &name_, const GameData &game_, const PlayerData &player_,
+	                 const PlayerData &ai_);
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Engine.h"
+#include "Flow.h"
+#include "GameLog.h"
+#include "Review.h"
+#include "UI.h"
+#include <vector>
+
+//
+// The flow of a game (deal, moves, tricks) as coroutine, that uses
+// the UI for all input, output and timing. The UI's delay() and
+// player_move() suspend the flow, run() executes the synchronous
+// engine calls (with their animations), so the same flow runs in
+// the Deck window and headless (with an injected clock).
+//
+class GameFlow
+{
+public:
+	GameFlow(GameData &game_, PlayerData &player_, PlayerData &ai_, Engine &engine_,
+	         GameLog &log_, std::vector<ReviewMove> &moves_, UI &ui_);
+	Flow::Task<> deal(Player playout_);
+	Flow::Task<bool> play();
+	Flow::Task<bool> game(Player playout_);
+	void reset();
+private:
+	void collect();
+	void deal_cards();
+	void give_cards(size_t cards_);
+	void fillup_cards();
+	void check_trick(Player move_);
+	void ai_move();
+	void record_move();
+	Flow::Task<bool> check_end();
+private:
+	GameData &_game;
+	PlayerData &_player;
+	PlayerData &_ai;
+	Engine &_engine;
+	GameLog &_log;
+	std::vector<ReviewMove> &_moves;
+	UI &_ui;
+};
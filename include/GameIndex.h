@@ -0,0 +1,80 @@
+#pragma once
+
+#include "GameRecord.h"
+#include "EngineParams.h"
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+//
+// Secondary index of a game record file ('<file>.idx'), one fixed size
+// entry per record. Loaded into bitmaps per key, so queries (like "AI
+// lost after closing") are answered by combining bitmaps, without
+// reading the records.
+//
+// File:  "SCGI" <version> { <entry> }
+// Entry: <offset:48> <build:32> <result:8> <closed:8> <trump:8>
+//        <20/40:8> <points:2*8>  (16 bytes, little endian)
+//
+class GameIndex
+{
+public:
+	enum Key
+	{
+		RESULT,                     // + Result
+		CLOSED = RESULT + 9,        // + Closed (who closed)
+		TRUMP = CLOSED + 4,         // + CardSuite
+		PLAYER_WINS = TRUMP + 4,
+		AI_WINS,
+		PLAYER_20,
+		AI_20,
+		PLAYER_40,
+		AI_40,
+		PLAYER_POINTS,              // + game points - 1 (1..3)
+		AI_POINTS = PLAYER_POINTS + 3,
+		KEYS = AI_POINTS + 3
+	};
+	struct Entry
+	{
+		uint64_t  offset;           // of record in record file
+		uint32_t  build;            // engine profile that played
+		Result    result;
+		Closed    closed;
+		CardSuite trump;
+		uint8_t   s20_40;           // declared suites PLAYER (bits 0-3) / AI (bits 4-7)
+		uint8_t   points[2];
+	};
+	struct Stats
+	{
+		Stats() : games(0), wins{ 0, 0 }, points{ 0, 0 } {}
+		size_t games;
+		size_t wins[2];
+		int    points[2];
+	};
+	typedef std::vector<uint64_t> Bitmap;
+
+	static Entry entry(const GameRecord &rec_, uint64_t offset_, uint32_t build_);
+	static uint32_t build(const EngineParams &params_);
+	static std::string file(const std::string &rec_file_) { return rec_file_ + ".idx"; }
+	static bool append(const std::string &name_, const Entry &entry_);
+	static size_t rebuild(const std::string &rec_file_, uint32_t build_ = 0);
+	static std::optional<int> key(const std::string &spec_);
+
+	bool load(const std::string &name_);
+	size_t size() const { return _entries.size(); }
+	const Entry &operator[](size_t i_) const { return _entries[i_]; }
+	Bitmap select(const std::vector<int> &keys_, std::optional<uint32_t> build_ = {}) const;
+	Stats stats(const Bitmap &selection_) const;
+	static constexpr char MAGIC[] = "SCGI";
+	static constexpr uint8_t VERSION = 1;
+	static constexpr size_t ENTRY_SIZE = 16;
+private:
+	void add(size_t n_, const Entry &entry_);
+	static void set(Bitmap &bitmap_, size_t n_) { bitmap_[n_ / 64] |= 1ull << (n_ % 64); }
+private:
+	std::vector<Entry> _entries;
+	std::vector<Bitmap> _keys;      // indexed by Key
+	std::map<uint32_t, Bitmap> _builds;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Engine.h"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+//
+// Compact log of a game: the position after the deal and one small
+// event per action. Any ply is restored by replaying the events
+// from the deal (undo/redo, jump to ply).
+//
+class GameLog
+{
+public:
+	enum class Type : uint8_t
+	{
+		TURN,       // player to move (stop for undo/redo)
+		PLAY,       // card played
+		MARRIAGE,   // 20/40 declared
+		EXCHANGE,   // trump jack exchanged
+		CLOSE,      // game closed
+		TRICK,      // trick decided ('side' led)
+		DRAW,       // cards drawn from pack
+		CLAIM       // remaining tricks claimed
+	};
+	struct Event
+	{
+		Type    type;
+		uint8_t side;   // Player
+		uint8_t value;  // card index (PLAY) or suite (MARRIAGE)
+	};
+	GameLog() : _ply(0) {}
+	void start(const GameData &game_, const PlayerData &player_, const PlayerData &ai_);
+	void add(Type type_, Player side_, uint8_t value_ = 0);
+	void add_move(Player side_, const Card &trump_card_, Closed closed_,
+	              const GameData &game_, const PlayerData &pd_);
+	size_t size() const { return _events.size(); }
+	size_t ply() const { return _ply; }
+	const std::vector<Event> &events() const { return _events; }
+	const GameData &start_game() const { return _game; }
+	const PlayerData &start_player() const { return _player; }
+	const PlayerData &start_ai() const { return _ai; }
+	size_t plays(size_t ply_) const;
+	std::optional<size_t> turn_ply(size_t ply_) const;
+	std::optional<size_t> undo_ply() const;
+	std::optional<size_t> redo_ply() const;
+	bool replay(size_t ply_, GameData &game_, PlayerData &player_, PlayerData &ai_);
+	bool step(GameData &game_, PlayerData &player_, PlayerData &ai_, Engine &engine_, UI &ui_);
+	static uint8_t index(const Card &c_) { return (uint8_t)((int)c_.suite() * 5 + (int)c_.face()); }
+	static Card card(uint8_t index_) { return Card(CardFace(index_ % 5), CardSuite(index_ / 5)); }
+private:
+	static void copy_position(GameData &to_, const GameData &from_);
+	static void copy_position(PlayerData &to_, const PlayerData &from_);
+	static void apply(const Event &e_, GameData &game_, PlayerData &player_, PlayerData &ai_,
+	                  Engine &engine_, UI &ui_);
+private:
+	GameData _game;     // position after deal
+	PlayerData _player;
+	PlayerData _ai;
+	std::vector<Event> _events;
+	size_t _ply;        // events applied to current position
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "GameLog.h"
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+//
+// Binary record of a finished game: start position (the deal is
+// stored as rank of the card permutation), the events of the game
+// and its result. Records are appended to a file one per game and
+// read back one at a time, so any number of records can be processed
+// with constant memory.
+//
+// File:   "SCGR" <version> { <size:16> <record> }
+// Record: <rank:64> <segment sizes:5*8> <flags:16> <scores:6*8> <20/40:8>
+//         <result:8> <points:2*8> <count:16> { <type|side<<4:8> <value:8> }
+// (all values little endian)
+//
+struct GameRecord
+{
+	GameRecord() : result(Result::NO_WIN), points{ 0, 0 } {}
+	GameData   game;        // start position
+	PlayerData player;
+	PlayerData ai;
+	std::vector<GameLog::Event> events;
+	Result     result;
+	int        points[2];   // game points of PLAYER/AI
+
+	void from_log(const GameLog &log_, Result result_, const std::pair<int, int> &points_);
+	void to_log(GameLog &log_) const;
+	bool replay(size_t ply_, GameData &game_, PlayerData &player_, PlayerData &ai_) const;
+	void encode(std::string &buf_) const;
+	bool decode(const uint8_t *data_, size_t size_);
+	static uint64_t rank(const std::vector<uint8_t> &perm_);
+	static std::vector<uint8_t> unrank(uint64_t rank_, size_t n_);
+	static constexpr char MAGIC[] = "SCGR";
+	static constexpr uint8_t VERSION = 1;
+};
+
+class GameRecordWriter
+{
+public:
+	explicit GameRecordWriter(const std::string &name_, uint32_t build_ = 0) :
+		_name(name_), _build(build_) {}
+	bool write(const GameRecord &rec_);
+private:
+	std::string _name;
+	uint32_t _build;    // engine profile (for index)
+	std::string _buf;
+};
+
+class GameRecordReader
+{
+public:
+	explicit GameRecordReader(const std::string &name_);
+	bool good() const { return _good; }
+	bool next(GameRecord &rec_);
+	bool find(size_t number_, GameRecord &rec_);
+	bool read_at(uint64_t offset_, GameRecord &rec_);
+	size_t count() const { return _count; }
+	uint64_t offset() const { return _offset; }  // of last read record
+private:
+	std::ifstream _ifs;
+	std::vector<uint8_t> _buf;
+	bool _good;
+	size_t _count;
+	uint64_t _offset;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+
+//
+// Power saving while the player does not interact.
+// Decorative animations (welcome screen, sleepy face...) run by
+// repeat() timers, which are suspended after no input for
+// 'idle-time' seconds and resumed by the next input. Together with
+// the timer driven game flow the process then does not wake up at all.
+// Every pass of the event loop is counted as a wakeup.
+//
+class Idle
+{
+public:
+	typedef void (*Callback)(void *);
+	typedef std::chrono::steady_clock Clock;
+	struct Stats
+	{
+		uint64_t wakeups = 0;
+		double rate = 0.;		// wakeups/s (of last measured second)
+		double max_rate = 0.;
+		uint64_t suspended = 0;		// timers suspended by idle
+	};
+	static void init();
+	static void repeat(double interval_, Callback cb_, void *data_);
+	static void remove(Callback cb_, void *data_);
+	static bool has_repeat(Callback cb_, void *data_);
+	static void input();
+	static bool idle();
+	static const Stats &stats();
+	static void reset_stats();
+private:
+	struct Ticker
+	{
+		Callback cb;
+		void *data;
+		double interval;
+		bool suspended;
+	};
+	static void cb_tick(void *d_);
+	static void cb_check(void *d_);
+	static std::list<Ticker> _tickers;
+	static Clock::time_point _last_input;
+	static Clock::time_point _rate_start;	// of current rate measurement
+	static uint64_t _rate_wakeups;
+	static Stats _stats;
+};
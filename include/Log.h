@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Util.h"
+#include "Config.h"
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// compile-time log level: messages above are compiled out (0=warnings only .. 3=all)
+#ifndef LOG_LEVEL
+#define LOG_LEVEL 3
+#endif
+
+//
+// Asynchronous log backend.
+// A message is only formatted when its level is enabled (console
+// level 'loglevel' or log file level 'logfile'), into a buffer of
+// the calling thread. The text is pushed into a lock-free ring buffer
+// (safe for any number of threads) and written to the log file and
+// console by a background writer thread. Messages pushed while the
+// writer finishes at exit are written by stop() or their producer.
+//
+class Log
+{
+public:
+	enum Level
+	{
+		WARNING,
+		INFO,
+		DEBUG,
+		DEVEL
+	};
+	static constexpr bool compiled(Level level_) { return level_ <= LOG_LEVEL; }
+	static bool enabled(Level level_)
+	{
+		return (level_ <= Config::as_int(Config::LOGLEVEL) ||
+		        level_ <= Config::as_int(Config::LOGFILE)) && !Util::quiet();
+	}
+	static std::ostream &begin();
+	static void end(Level level_);
+	static void flush();
+	explicit Log(const std::string &name_);	// (own instances only for tests)
+	~Log() { stop(); }
+	void push(Level level_, std::string &&text_);
+	void stop();
+private:
+	static Log &instance();
+	static std::ostringstream &buffer();
+	void write(Level level_, bool console_, bool file_, const std::string &text_);
+	uint64_t write_slots();
+	void drain();
+	void run();
+private:
+	struct Slot
+	{
+		std::atomic<uint64_t> seq;
+		Level level;
+		bool console;
+		bool file;
+		std::string text;
+	};
+	static constexpr size_t SLOTS = 4096;	// power of 2
+	Slot _slots[SLOTS];
+	alignas(64) std::atomic<uint64_t> _head;	// next slot to write (producers)
+	alignas(64) std::atomic<uint64_t> _tail;	// next slot to read (writer thread)
+	std::atomic<uint64_t> _written;			// slots written and flushed
+	std::atomic<uint32_t> _pending;			// wakeup of writer thread
+	std::atomic<bool> _stopping;		// exit: writer thread drains and finishes
+	std::atomic<bool> _stopped;		// writer thread finished: producers drain
+	std::mutex _mutex;				// (of writes after stop)
+	std::string _name;
+	std::ofstream _ofs;
+	std::thread _thread;
+	static inline std::atomic<Log *> _log = nullptr;	// set when writer is running
+};
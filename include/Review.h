@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Solver.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+struct ReviewMove
+{
+	Solver::Position position;  // position before move
+	int              card;      // card played (Solver::index) or -1
+};
+
+struct ReviewResult
+{
+	ReviewResult() : analyzed(false), played(0), best(0), best_card(-1) {}
+	bool analyzed;
+	int  played;                // game points of move played
+	int  best;                  // game points of best move
+	int  best_card;
+	std::vector<std::pair<int, int>> values;
+};
+
+class Review
+{
+public:
+	explicit Review(int strictness_ = 0) : _strictness(strictness_) {}
+	std::vector<ReviewResult> run(const std::vector<ReviewMove> &moves_) const;
+	std::string report(const std::vector<ReviewMove> &moves_, const std::vector<ReviewResult> &results_) const;
+private:
+	ReviewResult analyze(const ReviewMove &move_) const;
+private:
+	int _strictness;
+};
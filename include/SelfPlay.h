@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Engine.h"
+#include "EngineParams.h"
+#include "EngineStats.h"
+#include "GameLog.h"
+#include "UI.h"
+#include <cstdint>
+#include <utility>
+
+//
+// Headless game of two engines. The engine for the PLAYER side
+// sees the game mirrored (its own hand as "ai").
+//
+class SelfPlay
+{
+public:
+	struct Match
+	{
+		Match() : deals(0), points{ 0, 0 }, games_won{ 0, 0 } {}
+		size_t deals;       // each deal is played twice with swapped sides
+		int    points[2];   // game points of first/second profile
+		int    games_won[2];
+		EngineStats stats;  // decisions of both profiles
+		double score() const { return deals ? (double)(points[0] - points[1]) / (2 * deals) : 0.; }
+	};
+	explicit SelfPlay(const EngineParams &player_, const EngineParams &ai_, int strictness_ = 0);
+	std::pair<int, int> game(uint64_t seed_, Player first_);
+	const EngineStats &stats() const { return _stats; }
+	const GameLog &log() const { return _log; }
+	const GameData &game() const { return _game; }
+	const PlayerData &player() const { return _player; }
+	const PlayerData &ai() const { return _ai; }
+	static Match match(const EngineParams &a_, const EngineParams &b_, size_t deals_,
+	                   uint64_t seed_ = 0, int strictness_ = 0);
+private:
+	void deal();
+	void fillup_cards();
+	void move(Player side_);
+	void check_trick(Player lead_);
+	void mirror();
+private:
+	GameData _game;
+	PlayerData _player;
+	PlayerData _ai;
+	UI _ui;
+	Engine _player_engine;
+	Engine _ai_engine;
+	int _strictness;
+	EngineStats _stats;
+	GameLog _log;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Engine.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+//
+// Exact (double dummy) solver for end game positions.
+// Cards are kept as bitmasks (bit = suite * 5 + face), both hands are known.
+// Values are game points (1..3) from the view of the side to move,
+// negative for a lost game.
+//
+class Solver
+{
+public:
+	struct Position
+	{
+		uint32_t  hand[2];          // indexed by Player
+		int       score[2];
+		int       score_closed[2];
+		int       pending[2];
+		bool      tricks[2];        // has made at least one trick
+		CardSuite trump;
+		Closed    closed;
+		Player    move;             // side to move
+		int       table;            // card led by opponent or -1
+	};
+	explicit Solver(int strictness_ = 0) : _strictness(strictness_), _nodes(0) {}
+	static Position position(const GameData &game_, const PlayerData &player_, const PlayerData &ai_);
+	static bool solvable(const Position &pos_) { return pos_.closed != Closed::NOT; }
+	static int index(const Card &c_) { return (int)c_.suite() * 5 + (int)c_.face(); }
+	static Card card(int index_) { return Card(CardFace(index_ % 5), CardSuite(index_ / 5)); }
+	std::vector<std::pair<int, int>> evaluate(const Position &pos_) const;
+	int solve(const Position &pos_) const;
+	size_t nodes() const { return _nodes; }
+private:
+	static int value(int index_) { return card_values[index_ % 5]; }
+	static uint32_t suite_mask(CardSuite suite_) { return 0x1fu << ((int)suite_ * 5); }
+	int search(const Position &pos_, int alpha_, int beta_) const;
+	int play(const Position &pos_, int card_, int alpha_, int beta_) const;
+	int result(const Position &pos_) const;
+	uint32_t legal_moves(const Position &pos_) const;
+private:
+	static constexpr int card_values[] = { 10, 2, 3, 4, 11 };
+	int _strictness;
+	mutable size_t _nodes;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+//
+// Persistent game statistics: typed counters and the last gamebooks.
+// Changes are appended to a journal ('<file>.<generation>'), so each
+// finished game costs a single short write and survives a crash.
+// Compaction writes a new snapshot atomically (temp. file + rename)
+// and starts the journal of the next generation.
+//
+class StatsStore
+{
+public:
+	enum Counter
+	{
+		PLAYER_GAMES_WON,
+		AI_GAMES_WON,
+		PLAYER_MATCHES_WON,
+		AI_MATCHES_WON,
+		COUNTERS
+	};
+	typedef std::vector<std::pair<int, int>> Gamebook;
+	explicit StatsStore(const std::string &name_);
+	bool load();
+	bool compact();
+	void add(Counter counter_, int64_t n_ = 1);
+	void add(const Gamebook &gamebook_);
+	int64_t counter(Counter counter_) const { return _counters[counter_]; }
+	const std::deque<Gamebook> &gamebooks() const { return _gamebooks; }
+	size_t journal_size() const { return _journal_size; }
+	static constexpr size_t GAMEBOOKS = 10;   // last gamebooks kept
+	static constexpr size_t COMPACT = 64;     // journal entries to trigger compaction
+private:
+	bool apply(const std::string &line_);
+	void append(const std::string &line_);
+	std::string journal() const { return _name + "." + std::to_string(_generation); }
+	static std::string to_string(const Gamebook &gamebook_);
+	static Gamebook to_gamebook(const std::string &str_);
+	static const char *name(Counter counter_);
+private:
+	std::string _name;
+	int64_t _counters[COUNTERS];
+	std::deque<Gamebook> _gamebooks;  // oldest first
+	uint64_t _generation;
+	size_t _journal_size;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Engine.h"
+#include "EngineParams.h"
+#include "GameFile.h"
+#include "Util.h"
+#include <string>
+#include <vector>
+
+//
+// Regression suite of annotated positions (.scg files with
+// best_move/avoid_move), solved headless by the engine.
+//
+struct SuiteEntry
+{
+	std::string name;
+	GameData    game;
+	PlayerData  player;
+	PlayerData  ai;
+	Annotation  annotation;
+};
+
+struct SuiteResult
+{
+	SuiteResult() : passed(false), us(0) {}
+	bool     passed;
+	Card     move;
+	double   us;        // decision time (best of some runs)
+	Decision decision;
+};
+
+class Suite
+{
+public:
+	explicit Suite(const EngineParams &params_ = EngineParams()) : _params(params_) {}
+	size_t load(const std::string &dir_);
+	std::vector<SuiteResult> run() const;
+	std::string report(const std::vector<SuiteResult> &results_, const string_map &baseline_,
+	                   int *regressions_ = nullptr) const;
+	string_map baseline(const std::vector<SuiteResult> &results_) const;
+private:
+	SuiteResult run(const SuiteEntry &entry_) const;
+private:
+	EngineParams _params;
+	std::vector<SuiteEntry> _entries;
+};
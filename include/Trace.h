@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+//
+// Event tracing: scoped spans are written as Chrome trace events
+// (JSON, view with chrome://tracing or ui.perfetto.dev).
+// Enabled by command line option '--trace {file}'. When disabled a
+// span costs a single branch (relaxed atomic load).
+//
+class Trace
+{
+public:
+	class Span
+	{
+	public:
+		explicit Span(const char *name_) :
+			_name(enabled() ? name_ : nullptr),
+			_start(_name ? now() : 0)
+		{}
+		~Span() { if (_name) end(_name, _start, _detail); }
+		Span(const Span &) = delete;
+		Span &operator = (const Span &) = delete;
+		void detail(const std::string &detail_) { _detail = detail_; }
+	private:
+		const char *_name;
+		int64_t _start;
+		std::string _detail;
+	};
+	static bool enabled() { return _enabled.load(std::memory_order_relaxed); }
+	static bool start(const std::string &file_);
+	static void stop();
+	static void instant(const char *name_);
+private:
+	static int64_t now()
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+	static void end(const char *name_, int64_t start_, const std::string &detail_);
+	static void write(const char *ph_, const char *name_, int64_t ts_, int64_t dur_, const std::string &detail_);
+	static inline std::atomic<bool> _enabled = false;	// (read by all threads)
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+// scoped span (until end of block)
+#define TRACE(name) Trace::Span TRACE_CONCAT(trace_span_, __LINE__)(name)
+// scoped span with detail text (only evaluated when tracing)
+#define TRACE_DETAIL(name, x) TRACE(name); if (Trace::enabled()) TRACE_CONCAT(trace_span_, __LINE__).detail(x)
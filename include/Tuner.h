@@ -0,0 +1,23 @@
+#pragma once
+
+#include "EngineParams.h"
+#include <cstdint>
+#include <vector>
+
+//
+// SPSA tuning of the engine parameters by self play
+// against a base profile.
+//
+class Tuner
+{
+public:
+	explicit Tuner(const EngineParams &base_, size_t deals_ = 1000, int strictness_ = 0) :
+		_base(base_), _deals(deals_), _strictness(strictness_) {}
+	EngineParams run(int iterations_, uint64_t seed_ = 1);
+private:
+	EngineParams params(const std::vector<double> &theta_) const;
+private:
+	EngineParams _base;
+	size_t _deals;
+	int _strictness;
+};
@@ -1,29 +1,40 @@
 #pragma once
 
 #include "messages.h"
+#include "Flow.h"
+#include <functional>
 
 enum class Player;
+class AnimText;
 
 class UI
 {
 public:
 	UI() : _playing(true) {}
 	virtual void update() {}
+	virtual void update_text([[maybe_unused]]const AnimText &text_) { update(); }
 	virtual void animate_move() {}
 	virtual void animate_shuffle() {}
 	virtual void animate_trick() {}
 	virtual void animate_close() {}
 	virtual void animate_deal([[maybe_unused]] Player player_, [[maybe_unused]] size_t cards_ = 1) {}
+	virtual void animate_deal_both([[maybe_unused]] Player first_, [[maybe_unused]] size_t cards_ = 1, [[maybe_unused]] double delay_ = 0.05) {}
 	virtual void animate_change([[maybe_unused]]bool from_hand_ = false) {}
 	virtual void wait([[maybe_unused]]double s_) {}
 	virtual void message([[maybe_unused]]Message m_, [[maybe_unused]]bool bell_ = false) {}
 	virtual void bell([[maybe_unused]]Message m_ = NO_MESSAGE, [[maybe_unused]]bool visual_ = true) {}
 	virtual void prepare_game() {}
-	virtual void player_move() {}
-	virtual void ai_move() {}
 	virtual void show_win_msg() {}
 	virtual void show_lost_msg() {}
 	virtual bool playing() { return _playing; }
+
+	// game flow (GameFlow)
+	virtual void message([[maybe_unused]]Player player_, [[maybe_unused]]Message m_, [[maybe_unused]]bool bell_ = false) {}
+	virtual void busy([[maybe_unused]]bool busy_) {}
+	virtual void game_won([[maybe_unused]]Player winner_) {}
+	virtual Flow::Task<> delay([[maybe_unused]]double s_) { co_return; }
+	virtual Flow::Task<> run(std::function<void()> fn_) { fn_(); co_return; }
+	virtual Flow::Task<bool> player_move() { co_return false; }
 private:
 	bool _playing;
 };
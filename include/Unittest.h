@@ -1,18 +1,34 @@
 #pragma once
 
 #include "Engine.h"
+#include "Flow.h"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
 
 class Unittest
 {
 public:
 	explicit Unittest(GameData &game_, PlayerData &player_, PlayerData &ai_, Engine &engine_) :
-		_game(game_), _player(player_), _ai(ai_), _engine(engine_)
+		_game(game_), _player(player_), _ai(ai_), _engine(engine_), _failed(0)
 	{
 	}
 	bool run();
+	bool properties(size_t iterations_);
+	void benchmarks();
+	int failed() const { return _failed; }
+private:
+	bool check(bool ok_, const char *expr_, int line_);
+	static void random_end_game(std::mt19937 &gen_, GameData &game_, PlayerData &player_, PlayerData &ai_);
+	static size_t anim_text_length(const std::string &m_, size_t display_len_);
+	static void rotate_pixelwise(const std::vector<uint8_t> &src_, std::vector<uint8_t> &dst_, int w_, int h_, int d_);
+	static Flow::Task<int> flow_step(Flow::Resumer &resumer_, int value_);
+	static Flow::Task<int> flow_steps(Flow::Resumer &resumer_, int n_);
 private:
 	GameData &_game;
 	PlayerData &_player;
 	PlayerData &_ai;
 	Engine &_engine;
+	int _failed;
 };
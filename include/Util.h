@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <map>
@@ -32,29 +34,36 @@ class Fl_Window;
 class Util
 {
 public:
+	struct TextCacheStats
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		size_t entries = 0;
+	};
+	struct SymbolStats
+	{
+		uint64_t rasterized = 0;	// symbol images rasterized into atlases
+		size_t sizes = 0;		// atlases (symbol sizes) kept
+		size_t bytes = 0;
+	};
 	static const std::string& home_dir();
 	static std::string rsc_dir();
 	static std::string cfg_file();
 	static std::string sta_file();
+	static std::string rec_file();
 	static std::string cardset_dir(std::string name_ = "");
 	static string_map& config();
-	static string_map& stats();
 
 	static const std::string& config(const std::string &id_);
 	static std::optional<const std::string> config_value(const std::string &id_);
 	static int config_as_int(const std::string &id_);
 	static void config(const std::string &id_, const std::string &value_);
-	static const std::string& stats(const std::string &id_);
-	static int stats_as_int(const std::string &id_);
-	static void stats(const std::string &id_, const std::string &value_);
 
 	static void load_values_from_file(std::ifstream &if_, string_map &values_, const std::string& id_);
 	static void load_config();
-	static void load_stats();
 
 	static void save_values_to_file(std::ofstream &of_, const string_map &values_, const std::string &id_);
 	static void save_config();
-	static void save_stats();
 
 	static const std::string& message(const Message m_);
 
@@ -65,10 +74,13 @@ public:
 	static void draw_string(int w_, const std::string &text, int x_, int y_, bool shadow_ = false);
 	static int string_size(const std::string &text_, int &w_, int &h_);
 	static int string_width(const std::string &text_);
+	static void clear_text_cache();
+	static const TextCacheStats &text_cache_stats();
+	static const SymbolStats &symbol_stats();
 
 	static Fl_Shared_Image *get_shared_image(const std::string &name_, int w_ = 0, int h_ = 0, bool proportional_ = false);
 
-	static std::ostream& logstream();
+	static bool& quiet();
 
 	static std::string filename(const std::string &pathname_);
 	static std::string dirname(const std::string &pathname_, bool absolute_ = false);
@@ -1,6 +1,7 @@
 #pragma once
 
-#include "Util.h"
+#include "Log.h"
+#include "Trace.h"
 
 #include <cstdlib>
 #include <iostream>
@@ -12,9 +13,12 @@ constexpr auto LOG_PREFIX = "\033[1m";         // bold
 constexpr auto WNG_PREFIX = "\033[38;5;196m";  // bright red
 constexpr auto RESET_ATTR = "\033[0m";
 #undef OUT
-#define OUT(x) { std::cout << x; }
-#define LOG(x) { if (Util::logstream().good()) Util::logstream() << x; if (Util::config_as_int("loglevel") > 0) std::cout << LOG_PREFIX << x << RESET_ATTR; }
-#define DBG(x) { if (Util::logstream().good()) Util::logstream() << x; if (Util::config_as_int("loglevel") > 1) std::cout << DBG_PREFIX << x << RESET_ATTR; }
-#define DEV(x) { if (Util::config_as_int("loglevel") > 2) { Util::logstream().good() && Util::logstream() << x; std::cout << DBG_PREFIX << x << RESET_ATTR; } }
-#define WNG(x) { if (Util::logstream().good()) Util::logstream() << "!" << x << "\n"; std::cerr << WNG_PREFIX << x << RESET_ATTR << "\n"; }
+#define OUT(x) { Log::flush(); std::cout << x; }
+// NOTE: Util::quiet() disables logging for the calling thread
+// x is only evaluated if the level is enabled (and compiled in, see LOG_LEVEL)
+#define LOG_AT(level, x) { if constexpr (Log::compiled(level)) { if (Log::enabled(level)) { Log::begin() << x; Log::end(level); } } }
+#define LOG(x) LOG_AT(Log::INFO, x)
+#define DBG(x) LOG_AT(Log::DEBUG, x)
+#define DEV(x) LOG_AT(Log::DEVEL, x)
+#define WNG(x) LOG_AT(Log::WARNING, x)
 #define IMP(x) { if (Schnapsen::debug) { WNG(x) } }
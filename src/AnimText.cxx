@@ -9,6 +9,7 @@
 #include "AnimText.h"
 #include <FL/Fl.H>
 #include <FL/fl_utf8.h> // fl_utf8len1()
+#include <algorithm>
 
 #ifdef STANDALONE
 class UI
@@ -16,92 +17,126 @@ class UI
 public:
 	UI() {}
 	virtual void update() {}
+	virtual void update_text([[maybe_unused]]const AnimText &text_) { update(); }
 };
 #endif
 
-AnimText::AnimText(const std::string &m_, UI &ui_, double speed_/* = 1./60*/) :
-	_m(m_), _ui(ui_), _speed(speed_), _display_len(0), _needs_update(true)
-{
-	Fl::add_timeout(_speed, cb_anim, this);
-}
-
-AnimText::~AnimText()
-{
-	Fl::remove_timeout(cb_anim, this);
-}
-
-void AnimText::on_animate()
-{
-	if (!done())
-	{
-		_display_len++;
-		Fl::repeat_timeout(_speed, cb_anim, this);
-		_needs_update = true;
-		_ui.update();
-	}
-}
+/*static*/
+std::vector<AnimText *> AnimText::_running;
+/*static*/
+double AnimText::_interval = 1.;
 
-std::string &AnimText::text()
+AnimText::AnimText(const std::string &m_, UI &ui_, double speed_/* = 1./60*/) :
+	_m(m_), _ui(ui_), _speed(speed_), _start(Clock::now()), _display_len(0)
 {
-	if (_needs_update == false)
-		return _res; // string already "cached"
-
+	//
+	// Mask markup: ^|xxx| and ^n sequences are replaced by '~'
+	// (incomplete sequences are truncated), then the display lengths
+	// are mapped to the byte offsets after the n-th UTF-8 character,
+	// skipping masked characters.
+	//
 	std::string m(_m);
-	// replace all ^|xxx| seq. with '~'
-	size_t pos = m.find("^|");
-	while (pos != std::string::npos)
+	size_t pos = 0;
+	while ((pos = m.find("^|", pos)) != std::string::npos)
 	{
 		size_t end = m.find('|', pos + 2);
 		if (end == std::string::npos)
 		{
 			m.erase(pos);
+			break;
 		}
-		else
-		{
-			m.erase(pos, end - pos + 1);
-			m.insert(pos, std::string(end - pos + 1, '~'));
-		}
-		pos = m.find("^|");
+		std::fill(m.begin() + pos, m.begin() + end + 1, '~');
+		pos = end + 1;
 	}
-	// replace all ^n seq. with '~'
-	pos = m.find('^');
-	while (pos != std::string::npos)
+	pos = 0;
+	while ((pos = m.find('^', pos)) != std::string::npos)
 	{
 		if (pos + 1 == m.size())
-			m.erase(pos);
-		else
 		{
-			m[pos] = '~';
-			m[pos + 1] = '~';
+			m.erase(pos);
+			break;
 		}
-		pos = m.find('^');
+		m[pos] = m[pos + 1] = '~';
+		pos += 2;
+	}
+	auto skip_masked = [&](size_t pos_)
+	{
+		while (pos_ < m.size() && m[pos_] == '~')
+			pos_++;
+		return pos_;
+	};
+	_offsets.push_back(skip_masked(0));
+	pos = 0;	// (a masked begin counts as first character)
+	while (pos < m.size())
+	{
+		pos = skip_masked(pos + fl_utf8len1(m[pos]));
+		_offsets.push_back(pos);
 	}
-	// calc. utf8 length of _display_len
-	size_t utf8_len = 0;
-	size_t len = _display_len;
-	while (len > 0 && utf8_len < m.size())
+	_res = _m.substr(0, _offsets[0]);
+	if (done()) return;
+	if (_running.empty() || _speed < _interval)
 	{
-		utf8_len += fl_utf8len1(m[utf8_len]);
-		while (m[utf8_len] == '~')
-			utf8_len++;
-		len--;
+		// (re)start shared timer with the fastest speed
+		Fl::remove_timeout(cb_anim);
+		_interval = _speed;
+		Fl::add_timeout(_interval, cb_anim);
 	}
-	while (m[utf8_len] == '~')
-		utf8_len++;
-
-	_res = _m.substr(0, utf8_len);
-	_needs_update = false;
-	return _res;
+	_running.push_back(this);
 }
 
-bool AnimText::done() const
+AnimText::~AnimText()
 {
-	return _display_len >= _m.size();
+	std::erase(_running, this);
+	if (_running.empty())
+		Fl::remove_timeout(cb_anim);
 }
 
+/*static*/
+void AnimText::cb_anim(void *)
+{
+	//
+	// Shared timer: advance all appearing texts (by their time).
+	//
+	Clock::time_point now = Clock::now();
+	std::vector<AnimText *> running(_running);
+	double interval = 1.;
+	for (AnimText *text : running)
+	{
+		if (std::find(_running.begin(), _running.end(), text) == _running.end())
+			continue;	// (deleted meanwhile)
+		if (text->on_animate(now))
+			interval = std::min(interval, text->_speed);
+		else
+			std::erase(_running, text);
+	}
+	_interval = interval;
+	if (_running.size())
+		Fl::repeat_timeout(_interval, cb_anim);
+}
 
+bool AnimText::on_animate(Clock::time_point now_)
+{
+	// returns false when done
+	size_t len = std::chrono::duration<double>(now_ - _start).count() / _speed;
+	len = std::min(std::max(len, _display_len + 1), _offsets.size() - 1);
+	if (len != _display_len)
+	{
+		_res.append(_m, _offsets[_display_len], _offsets[len] - _offsets[_display_len]);
+		_display_len = len;
+		_ui.update_text(*this);
+	}
+	return !done();
+}
 
+std::string &AnimText::text()
+{
+	return _res;
+}
 
+bool AnimText::done() const
+{
+	return _display_len + 1 >= _offsets.size();
+}
 
 #ifdef STANDALONE
 #undef STANDALONE
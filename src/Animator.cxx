@@ -0,0 +1,87 @@
+//
+// Part of "Schnapsen for 2" card game.
+//
+// (c) 2026 Christian Grabner
+//
+// Animation scheduler driven by a monotonic clock.
+//
+#include "Animator.h"
+#include <algorithm>
+#include <cmath>
+
+size_t Animator::add(Clock::time_point start_, double duration_, Easing easing_/* = Easing::EASE_IN_OUT*/, double delay_/* = 0.*/)
+{
+	auto delay = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(delay_));
+	_anims.push_back({ ++_next_id, start_ + delay, std::max(duration_, 1e-6), easing_, 0., false });
+	return _next_id;
+}
+
+void Animator::frame(Clock::time_point now_)
+{
+	//
+	// Sample time for all animations: those that reached their end
+	// at the last frame are removed, the others are advanced.
+	//
+	std::erase_if(_anims, [](const Anim &a_) { return a_.done; });
+	if (_anims.empty())
+	{
+		_in_run = false;
+		return;
+	}
+	if (_in_run)
+	{
+		double dt = std::chrono::duration<double>(now_ - _last_frame).count();
+		_stats.frame_time += dt;
+		_stats.max_frame_time = std::max(_stats.max_frame_time, dt);
+		long missed = std::lround(dt / _interval) - 1;
+		if (missed > 0)
+			_stats.skipped += missed;
+	}
+	_stats.frames++;
+	_last_frame = now_;
+	_in_run = true;
+	for (auto &a : _anims)
+	{
+		double t = std::chrono::duration<double>(now_ - a.start).count() / a.duration;
+		t = std::clamp(t, 0., 1.);
+		a.progress = ease(a.easing, t);
+		a.done = t >= 1.;
+	}
+}
+
+double Animator::progress(size_t id_) const
+{
+	// eased progress 0..1 at last frame (1 if finished or unknown)
+	for (auto &a : _anims)
+	{
+		if (a.id == id_)
+			return a.progress;
+	}
+	return 1.;
+}
+
+bool Animator::running() const
+{
+	return std::any_of(_anims.begin(), _anims.end(), [](const Anim &a_) { return !a_.done; });
+}
+
+void Animator::clear()
+{
+	_anims.clear();
+	_in_run = false;
+}
+
+/*static*/
+double Animator::ease(Easing easing_, double t_)
+{
+	switch (easing_)
+	{
+		case Easing::LINEAR:
+			return t_;
+		case Easing::EASE_IN_OUT:
+			return t_ * t_ * (3. - 2. * t_);
+		case Easing::EASE_OUT:
+			return 1. - (1. - t_) * (1. - t_);
+	}
+	return t_;
+}
@@ -109,6 +109,8 @@ bool process(const std::string &arg_, const std::string &value_)
 		{ "font", "\t{fontfile-name}\tuse this custom font" },
 		{ "background", "{name/number}\tset background image or color [imagepath/[0-255]]" },
 		{ "loglevel", "{level}\t\tset loglevel [0-2]" },
+		{ "replay", "{number}\treplay journaled game [0=last]" },
+		{ "trace", "{file}\t\twrite Chrome trace events (chrome://tracing, ui.perfetto.dev)" },
 		{ "lang", "\t{id}\t\tset language [de,en]" }
 	};
 	static const string_map short_args =
@@ -38,9 +38,11 @@ Card::Card(CardFace f_, CardSuite s_) :
 Card& Card::load(bool force_/* = false*/)
 {
 	if (face() == NO_FACE) return *this;
-	if (force_ || !_images.image(name()))
+	if (force_ || !_images.loaded())
 	{
+		if (!force_ && _images.find(name())) return *this;	// loaded by another card object
 		std::string pathname = Util::cardset_dir() + filename();
+		TRACE_DETAIL("Card::load", pathname);
 		DBG("load '" << pathname << "'\n");
 		_images.image(name(), pathname);
 	}
@@ -54,7 +56,9 @@ bool Card::operator == (const Card c_)
 
 int Card::value() const
 {
-	return card_value[face()];
+	// NOTE: no operator[] - must not insert, engine may run in several threads
+	auto it = card_value.find(face());
+	return it != card_value.end() ? it->second : 0;
 }
 
 std::string Card::face_name() const
@@ -208,6 +212,9 @@ constexpr char APPLICATION[] = "Card-Test";
 #include <iostream>
 #include "CardImage.cxx"
 #include "Util.cxx"
+#include "Config.cxx"
+#include "Log.cxx"
+#include "Trace.cxx"
 
 using enum CardSuite;
 using enum CardFace;
@@ -7,80 +7,221 @@
 //
 
 #include "CardImage.h"
+#include "Config.h"
+#include "Trace.h"
 
+#include <FL/Fl.H>
+#include <FL/Fl_Window.H>
 #include <FL/Fl_RGB_Image.H>
 #include <FL/Fl_SVG_Image.H>
 #include <FL/Fl_PNG_Image.H>
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <sstream>
 #include <stdexcept>
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
 
-Fl_RGB_Image *rotate_90_CCW(const Fl_RGB_Image &svg_)
+namespace {
+
+constexpr int ROTATE_BLOCK = 32;	// pixels (cache blocking)
+
+template <int D>
+void rotate_pixels(const uchar *src_, size_t sstride_, uchar *dst_, size_t dstride_, int h_,
+                   int x0_, int x1_, int y0_, int y1_)
+{
+	// dst(h_ - 1 - y, x) = src(x, y) for the area x0_..x1_, y0_..y1_
+	for (int y = y0_; y < y1_; y++)
+	{
+		const uchar *s = src_ + y * sstride_ + x0_ * D;
+		uchar *d = dst_ + x0_ * dstride_ + (h_ - 1 - y) * D;
+		for (int x = x0_; x < x1_; x++, s += D, d += dstride_)
+			memcpy(d, s, D);
+	}
+}
+
+#if defined(__AVX2__)
+#define ROTATE_TILE 8
+inline void rotate_tile(const uchar *src_, size_t sstride_, uchar *dst_, size_t dstride_)
+{
+	//
+	// 8x8 RGBA pixels: transpose of the rows in reverse order
+	// (dst_ is the first pixel of the destination tile).
+	//
+	__m256i r[8];
+	for (int i = 0; i < 8; i++)
+		r[i] = _mm256_loadu_si256((const __m256i *)(src_ + (7 - i) * sstride_));
+	__m256i t[8];
+	for (int i = 0; i < 8; i += 2)
+	{
+		t[i] = _mm256_unpacklo_epi32(r[i], r[i + 1]);
+		t[i + 1] = _mm256_unpackhi_epi32(r[i], r[i + 1]);
+	}
+	__m256i u[8];
+	for (int i = 0; i < 8; i += 4)
+	{
+		u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+		u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+		u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+		u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+	}
+	for (int i = 0; i < 4; i++)
+	{
+		_mm256_storeu_si256((__m256i *)(dst_ + i * dstride_), _mm256_permute2x128_si256(u[i], u[i + 4], 0x20));
+		_mm256_storeu_si256((__m256i *)(dst_ + (i + 4) * dstride_), _mm256_permute2x128_si256(u[i], u[i + 4], 0x31));
+	}
+}
+#elif defined(__SSE2__) || defined(_M_X64)
+#define ROTATE_TILE 4
+inline void rotate_tile(const uchar *src_, size_t sstride_, uchar *dst_, size_t dstride_)
+{
+	//
+	// 4x4 RGBA pixels: transpose of the rows in reverse order
+	// (dst_ is the first pixel of the destination tile).
+	//
+	__m128i a = _mm_loadu_si128((const __m128i *)(src_ + 3 * sstride_));
+	__m128i b = _mm_loadu_si128((const __m128i *)(src_ + 2 * sstride_));
+	__m128i c = _mm_loadu_si128((const __m128i *)(src_ + sstride_));
+	__m128i d = _mm_loadu_si128((const __m128i *)src_);
+	__m128i t0 = _mm_unpacklo_epi32(a, b);
+	__m128i t1 = _mm_unpacklo_epi32(c, d);
+	__m128i t2 = _mm_unpackhi_epi32(a, b);
+	__m128i t3 = _mm_unpackhi_epi32(c, d);
+	_mm_storeu_si128((__m128i *)dst_, _mm_unpacklo_epi64(t0, t1));
+	_mm_storeu_si128((__m128i *)(dst_ + dstride_), _mm_unpackhi_epi64(t0, t1));
+	_mm_storeu_si128((__m128i *)(dst_ + 2 * dstride_), _mm_unpacklo_epi64(t2, t3));
+	_mm_storeu_si128((__m128i *)(dst_ + 3 * dstride_), _mm_unpackhi_epi64(t2, t3));
+}
+#endif
+
+void rotate_block_rgba(const uchar *src_, size_t sstride_, uchar *dst_, size_t dstride_, int h_,
+                       int x0_, int x1_, int y0_, int y1_)
+{
+#ifdef ROTATE_TILE
+	int tx1 = x0_ + (x1_ - x0_) / ROTATE_TILE * ROTATE_TILE;
+	int ty1 = y0_ + (y1_ - y0_) / ROTATE_TILE * ROTATE_TILE;
+	for (int y = y0_; y < ty1; y += ROTATE_TILE)
+	{
+		for (int x = x0_; x < tx1; x += ROTATE_TILE)
+			rotate_tile(src_ + y * sstride_ + x * 4, sstride_,
+			            dst_ + x * dstride_ + (h_ - ROTATE_TILE - y) * 4, dstride_);
+	}
+	// remaining pixels at right and bottom of block
+	rotate_pixels<4>(src_, sstride_, dst_, dstride_, h_, tx1, x1_, y0_, y1_);
+	rotate_pixels<4>(src_, sstride_, dst_, dstride_, h_, x0_, tx1, ty1, y1_);
+#else
+	rotate_pixels<4>(src_, sstride_, dst_, dstride_, h_, x0_, x1_, y0_, y1_);
+#endif
+}
+
+}; // namespace
+
+/*static*/
+void CardImage::rotate_90_CCW(const uint8_t *src_, uint8_t *dst_, int w_, int h_, int d_, int ld_/* = 0*/)
+{
+	//
+	// Rotate image src_ (w_ x h_, depth 3 or 4) into dst_ (h_ x w_).
+	// The source is walked in blocks, so that the destination lines
+	// written stay in cache. RGBA blocks are rotated by SIMD tile
+	// transposes (SSE2 or AVX2, if enabled by the compiler flags).
+	//
+	assert(d_ == 3 || d_ == 4);
+	size_t sstride = ld_ ? ld_ : (size_t)w_ * d_;
+	size_t dstride = (size_t)h_ * d_;
+	for (int by = 0; by < h_; by += ROTATE_BLOCK)
+	{
+		int y1 = std::min(by + ROTATE_BLOCK, h_);
+		for (int bx = 0; bx < w_; bx += ROTATE_BLOCK)
+		{
+			int x1 = std::min(bx + ROTATE_BLOCK, w_);
+			if (d_ == 4)
+				rotate_block_rgba(src_, sstride, dst_, dstride, h_, bx, x1, by, y1);
+			else
+				rotate_pixels<3>(src_, sstride, dst_, dstride, h_, bx, x1, by, y1);
+		}
+	}
+}
+
+/*static*/
+Fl_RGB_Image *CardImage::rotate_90_CCW(const Fl_RGB_Image &svg_)
 {
 	int w = svg_.data_w();
 	int h = svg_.data_h();
 	DBG("rotate " << w << "x" << h << "\n");
 	int d = svg_.d();
 	assert(w > 0 && h > 0 && d >= 3);
-	uchar alpha = 0;
 	uchar *rot_data = new uchar[w * h * d];
-
-	const auto data = svg_.data()[0];
-	for (int y = 0; y < h; y++)
-	{
-		for (int x = 0; x < w; x++)
-		{
-			auto get_offset = [](int w, [[maybe_unused]]int h, int x, int y, int d) -> size_t
-			{
-				return w * y * d + x * d;
-			};
-			size_t offset = get_offset(w, h, x, y, d);
-			unsigned char r = data[offset];
-			unsigned char g = data[offset + 1];
-			unsigned char b = data[offset + 2];
-			if (d > 3)
-				alpha = data[offset + 3];
-
-			offset = get_offset(h, w, h - y - 1, x, d);
-			rot_data[offset]     = r;
-			rot_data[offset + 1] = g;
-			rot_data[offset + 2] = b;
-			if (d > 3)
-				rot_data[offset + 3] = alpha;
-		}
-	}
+	rotate_90_CCW((const uchar *)svg_.data()[0], rot_data, w, h, d, svg_.ld());
 	Fl_RGB_Image *rotated_image = new Fl_RGB_Image(rot_data, h, w, d);
 	rotated_image->alloc_array = 1;
 	return rotated_image;
 }
 
-CardImage& CardImage::image(const std::string &id_, const std::string &pathname_, bool data_/* = false*/)
+namespace {
+
+void card_images_ready(void *)
 {
-	auto image = _images.find(id_);
+	// (called in main thread via Fl::awake)
+	for (Fl_Window *win = Fl::first_window(); win; win = Fl::next_window(win))
+		win->redraw();
+}
+
+}; // namespace
+
+/*static*/
+uint32_t CardImage::intern(const std::string &id_)
+{
+	auto it = _ids.find(id_);
+	if (it != _ids.end())
+		return it->second;
+	uint32_t id = _sources.size();
+	_sources.emplace_back();
+	_sources.back().name = id_;
+	_ids.emplace(id_, id);
+	return id;
+}
+
+bool CardImage::find(const std::string &id_)
+{
+	// use image with id_, if it is already declared (e.g. by another card object)
+	auto it = _ids.find(id_);
+	if (it == _ids.end() || !_sources[it->second].generation)
+		return false;
+	_id = it->second;
+	return true;
+}
+
+/*static*/
+void CardImage::drop(uint32_t id_)
+{
+	// remove cached images of id_ (e.g. after change of cardset)
+	for (auto it = _lru.begin(); it != _lru.end();)
 	{
-		if (image != _images.end())
-		{
-			delete image->second;
-			_images.erase(image);
-		}
-		image = _images.find(id_ + "_skewed");
-		if (image != _images.end())
+		if (it->key.id != id_)
 		{
-			delete image->second;
-			_images.erase(image);
-		}
-		image = _images.find(id_ + "_quer");
-		if (image != _images.end())
-		{
-			delete image->second;
-			_images.erase(image);
+			++it;
+			continue;
 		}
+		_stats.bytes -= it->bytes;
+		_cache.erase(it->key);
+		delete it->image;
+		it = _lru.erase(it);
 	}
-	std::string pathname(pathname_);
+	_stats.entries = _lru.size();
+}
+
+/*static*/
+Fl_RGB_Image *CardImage::load(const std::string &id_, std::string &pathname_, bool data_)
+{
+	//
+	// Parse SVG (or PNG) image, nullptr if failed.
+	//
 	Fl_RGB_Image *img = nullptr;
 	if (data_ == false)
-		img = new Fl_SVG_Image(pathname.c_str());
+		img = new Fl_SVG_Image(pathname_.c_str());
 	else
 		img = new Fl_SVG_Image(id_.c_str(), pathname_.c_str());
 	if ((!img || img->w() <= 0 || img->h() <= 0))
@@ -88,94 +229,551 @@ CardImage& CardImage::image(const std::string &id_, const std::string &pathname_
 		delete img;
 		img = nullptr;
 		// try as PNG image
-		if (data_ == false && pathname.size() > 4 && pathname.at(pathname.size() - 4) == '.')
+		if (data_ == false && pathname_.size() > 4 && pathname_.at(pathname_.size() - 4) == '.')
 		{
-			pathname.erase(pathname.size() - 3);
-			pathname.append("png");
-			img = new Fl_PNG_Image(pathname.c_str());
+			pathname_.erase(pathname_.size() - 3);
+			pathname_.append("png");
+			img = new Fl_PNG_Image(pathname_.c_str());
 		}
 	}
 	if ((!img || img->w() <= 0 || img->h() <= 0))
+	{
+		delete img;
+		return nullptr;
+	}
+	if (img->as_svg_image())
+		img->as_svg_image()->proportional = false;
+	return img;
+}
+
+CardImage& CardImage::declare(const std::string &id_, const std::string &pathname_, bool data_/* = false*/)
+{
+	//
+	// Set image source without loading it (done by prerender() or
+	// on first use).
+	//
+	_id = intern(id_);
+	Source &source = _sources[_id];
+	if (source.generation && source.pathname == pathname_)
+		return *this;
+	drop(_id);
+	delete source.image;
+	source.image = nullptr;
+	source.pathname = pathname_;
+	source.data = data_;
+	source.generation = ++_generation;
+	return *this;
+}
+
+CardImage& CardImage::image(const std::string &id_, const std::string &pathname_, bool data_/* = false*/)
+{
+	declare(id_, pathname_, data_);
+	if (!ready(_id))
 	{
 		std::ostringstream os;
-		os << "Card image '" << pathname << "' not found!";
+		os << "Card image '" << pathname_ << "' not found!";
 		throw std::runtime_error(os.str());
 	}
-	_pathname = pathname;
-	assert(img && img->w() > 0 && img->h() > 0);
+	return *this;
+}
+
+/*static*/
+bool CardImage::ready(uint32_t id_)
+{
+	// make sure source image is loaded
+	Source &source = _sources[id_];
+	if (source.image)
+		return true;
+	if (source.pathname.empty())
+		return false;
+	TRACE_DETAIL("CardImage::image", source.name);
+	std::string pathname(source.pathname);
+	source.image = load(source.name, pathname, source.data);
+	return source.image;
+}
+
+/*static*/
+void CardImage::prerender(const std::vector<std::string> &ids_, int w_, int h_)
+{
+	//
+	// Queue the images ids_ for pixel size w_ x h_ (scaled and
+	// rotated) to the worker threads. Queued jobs for other sizes
+	// are cancelled.
+	//
+	if (w_ <= 0 || h_ <= 0) return;
+	TRACE("CardImage::prerender");
+	collect();
+	_prerender_w = w_;
+	_prerender_h = h_;
+	size_t queued = 0;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		for (auto it = _queue.begin(); it != _queue.end();)
+		{
+			const Job &job = **it;
+			if (job.w == w_ && job.h == h_)
+			{
+				++it;
+				continue;
+			}
+			_jobs.erase(Key{ job.id, job.generation, (uint16_t)job.w, (uint16_t)job.h, Variant::SCALED });
+			_jobs.erase(Key{ job.id, job.generation, (uint16_t)job.w, (uint16_t)job.h, Variant::ROT90 });
+			it = _queue.erase(it);
+		}
+		for (auto &name : ids_)
+		{
+			auto it = _ids.find(name);
+			if (it == _ids.end()) continue;
+			uint32_t id = it->second;
+			const Source &source = _sources[id];
+			if (!source.generation) continue;
+			Key key{ id, source.generation, (uint16_t)w_, (uint16_t)h_, Variant::SCALED };
+			Key rot90_key{ id, source.generation, (uint16_t)w_, (uint16_t)h_, Variant::ROT90 };
+			if ((_cache.contains(key) && _cache.contains(rot90_key)) || _jobs.contains(key)) continue;
+			auto job = std::make_unique<Job>();
+			job->id = id;
+			job->generation = source.generation;
+			job->name = source.name;
+			job->pathname = source.pathname;
+			job->data = source.data;
+			job->w = w_;
+			job->h = h_;
+			_jobs.insert(key);
+			_jobs.insert(rot90_key);
+			_queue.push_back(std::move(job));
+			queued++;
+		}
+	}
+	if (!queued) return;
+	if (_workers.empty())
+	{
+		// started once, run until exit
+		unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+		for (unsigned i = 0; i < workers; i++)
+			_workers.emplace_back(work);
+		std::atexit(stop_workers);
+	}
+	DBG("prerender " << queued << " images " << w_ << "x" << h_ << " in " << _workers.size() << " threads\n");
+	_wakeup.notify_all();
+}
+
+/*static*/
+void CardImage::render(Job &job_)
+{
+	//
+	// Parse and rasterize SVG image (worker thread) by an own
+	// Fl_SVG_Image, that is never drawn. Parsing runs in parallel,
+	// rasterizing is done holding the FLTK lock (FLTK uses one
+	// rasterizer for all SVG images), so it only runs while the main
+	// thread waits for events. Other images are left to the main thread.
+	//
+	std::unique_ptr<Fl_SVG_Image> svg(job_.data ?
+		new Fl_SVG_Image(job_.name.c_str(), job_.pathname.c_str()) :
+		new Fl_SVG_Image(job_.pathname.c_str()));
+	if (svg->w() <= 0 || svg->h() <= 0) return;
+	svg->proportional = false;
+	size_t line = (size_t)job_.w * 4;
+	{
+		Fl::lock();
+		svg->resize(job_.w, job_.h);
+		svg->normalize();
+		if (svg->d() == 4 && svg->data_w() == job_.w && svg->data_h() == job_.h && svg->data())
+		{
+			const uint8_t *src = (const uint8_t *)svg->data()[0];
+			size_t ld = svg->ld() ? svg->ld() : line;
+			job_.scaled.reset(new uint8_t[line * job_.h]);
+			for (int y = 0; y < job_.h; y++)
+				memcpy(job_.scaled.get() + y * line, src + y * ld, line);
+		}
+		svg.reset();
+		Fl::unlock();
+	}
+	if (!job_.scaled) return;
+	job_.rot90.reset(new uint8_t[line * job_.h]);
+	rotate_90_CCW(job_.scaled.get(), job_.rot90.get(), job_.w, job_.h, 4);
+}
+
+/*static*/
+void CardImage::work()
+{
+	//
+	// Worker thread: rasterize queued jobs, hand over the
+	// results to the main thread.
+	//
+	for (;;)
+	{
+		std::unique_ptr<Job> job;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wakeup.wait(lock, []() { return _stopping || !_queue.empty(); });
+			if (_stopping) return;
+			job = std::move(_queue.front());
+			_queue.pop_front();
+		}
+		TRACE_DETAIL("CardImage::render", job->name);
+		render(*job);
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_done.push_back(std::move(job));
+		}
+		Fl::awake(card_images_ready, nullptr);
+	}
+}
+
+/*static*/
+void CardImage::stop_workers()
+{
+	// (at exit) running jobs are finished, queued ones dropped
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+		_queue.clear();
+	}
+	_wakeup.notify_all();
+	Fl::unlock();	// (a running job may wait for the FLTK lock of the main thread)
+	for (auto &worker : _workers)
+		worker.join();
+	Fl::lock();
+	_workers.clear();
+}
+
+/*static*/
+Fl_RGB_Image *CardImage::rgb_image(std::unique_ptr<uint8_t[]> &pixels_, int w_, int h_)
+{
+	// image owning the pixels
+	Fl_RGB_Image *img = new Fl_RGB_Image(pixels_.release(), w_, h_, 4);
+	img->alloc_array = 1;
+	return img;
+}
+
+/*static*/
+void CardImage::take(Job &job_)
+{
+	// move results of a finished job into the cache (if still current)
+	Key key{ job_.id, job_.generation, (uint16_t)job_.w, (uint16_t)job_.h, Variant::SCALED };
+	Key rot90_key{ job_.id, job_.generation, (uint16_t)job_.w, (uint16_t)job_.h, Variant::ROT90 };
+	_jobs.erase(key);
+	_jobs.erase(rot90_key);
+	bool current = _sources[job_.id].generation == job_.generation &&
+	               job_.w == _prerender_w && job_.h == _prerender_h;
+	if (!current || !job_.scaled) return;
+	if (!_cache.contains(key))
+	{
+		insert(key, rgb_image(job_.scaled, job_.w, job_.h));
+		_stats.prerendered++;
+	}
+	if (!_cache.contains(rot90_key))
+		insert(rot90_key, rgb_image(job_.rot90, job_.h, job_.w));
+}
+
+/*static*/
+void CardImage::collect()
+{
+	// take the results of finished jobs
+	std::vector<std::unique_ptr<Job>> done;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		done.swap(_done);
+	}
+	for (auto &job : done)
+		take(*job);
+}
+
+/*static*/
+bool CardImage::pending(const Key &key_)
+{
+	// is image being prerendered? (finished jobs are taken by collect())
+	return _jobs.contains(key_);
+}
+
+/*static*/
+bool CardImage::pending_source(uint32_t id_)
+{
+	// is the image in card size not yet ready? (derived variants are built from it)
+	return pending(Key{ id_, _sources[id_].generation, (uint16_t)_W, (uint16_t)_H, Variant::SCALED });
+}
+
+/*static*/
+Fl_RGB_Image *CardImage::placeholder(int w_, int h_)
+{
+	//
+	// Plain card (white with grey border) shown until the
+	// prerendered image is ready.
+	//
+	static const uint32_t id = intern("#placeholder");
+	_stats.placeholders++;
+	Key key{ id, 0, (uint16_t)w_, (uint16_t)h_, Variant::SCALED };
+	if (Fl_RGB_Image *img = cached(key))
+		return img;
+	uchar *data = new uchar[w_ * h_ * 4];
+	for (int y = 0; y < h_; y++)
+	{
+		for (int x = 0; x < w_; x++)
+		{
+			bool border = x == 0 || y == 0 || x == w_ - 1 || y == h_ - 1;
+			uchar *p = data + (y * w_ + x) * 4;
+			p[0] = p[1] = p[2] = border ? 160 : 250;
+			p[3] = 255;
+		}
+	}
+	Fl_RGB_Image *img = new Fl_RGB_Image(data, w_, h_, 4);
+	img->alloc_array = 1;
+	return insert(key, img);
+}
+
+/*static*/
+Fl_RGB_Image *CardImage::cached(const Key &key_)
+{
+	auto it = _cache.find(key_);
+	if (it == _cache.end())
+	{
+		_stats.misses++;
+		return nullptr;
+	}
+	_stats.hits++;
+	_lru.splice(_lru.begin(), _lru, it->second);
+	return it->second->image;
+}
+
+/*static*/
+Fl_RGB_Image *CardImage::insert(const Key &key_, Fl_RGB_Image *image_)
+{
+	size_t bytes = (size_t)key_.w * key_.h * (image_->d() ? image_->d() : 4);
+	_lru.push_front({ key_, image_, bytes });
+	_cache[key_] = _lru.begin();
+	_stats.bytes += bytes;
+	_stats.entries = _lru.size();
+	return image_;
+}
+
+/*static*/
+void CardImage::trim()
+{
+	//
+	// Take prerendered images, then evict least recently
+	// used images until within budget.
+	//
+	collect();
+	size_t budget = (size_t)Config::as_int(Config::IMAGE_CACHE) << 20;
+	while (_stats.bytes > budget && _lru.size())
+	{
+		Entry &e = _lru.back();
+		_stats.bytes -= e.bytes;
+		_stats.evictions++;
+		_cache.erase(e.key);
+		delete e.image;
+		_lru.pop_back();
+	}
+	_stats.entries = _lru.size();
+}
+
+/*static*/
+void CardImage::clear()
+{
+	for (auto &e : _lru)
+		delete e.image;
+	_lru.clear();
+	_cache.clear();
+	_stats.bytes = 0;
+	_stats.entries = 0;
+}
+
+/*static*/
+Fl_RGB_Image *CardImage::rasterize(const Fl_RGB_Image &source_, int w_, int h_)
+{
+	// copy of source image in pixel size w_ x h_ (SVG images are rasterized in this size)
+	Fl_RGB_Image *img = static_cast<Fl_RGB_Image *>(source_.copy());
 	if (img->as_svg_image())
+	{
 		img->as_svg_image()->proportional = false;
-	_images[id_] = img;
-	_last_id = id_;
-	return *this;
+		img->as_svg_image()->resize(w_, h_);
+		img->normalize();
+	}
+	else
+	{
+		Fl_RGB_Image *copy = static_cast<Fl_RGB_Image *>(img->copy(w_, h_));
+		delete img;
+		img = copy;
+	}
+	return img;
 }
 
-Fl_RGB_Image *CardImage::image(const std::string &id_, int w_/* = 0*/, int h_/* = 0*/) const
+/*static*/
+Fl_RGB_Image *CardImage::scaled(uint32_t id_, int w_, int h_)
 {
-	auto image = _images.find(id_);
-	if (image == _images.end())
+	Source &source = _sources[id_];
+	if (w_ <= 0 || h_ <= 0)
+		return ready(id_) ? source.image : nullptr;
+	Key key{ id_, source.generation, (uint16_t)w_, (uint16_t)h_, Variant::SCALED };
+	if (Fl_RGB_Image *img = cached(key))
+		return img;
+	if (pending(key))
+		return placeholder(w_, h_);
+	if (!ready(id_))
 		return nullptr;
-	image->second->scale(w_ ? w_ :_W , h_ ? h_ : _H, 0, 1);
-	return image->second;
+	return insert(key, rasterize(*source.image, w_, h_));
 }
 
-Fl_RGB_Image *CardImage::image() const
+/*static*/
+Fl_RGB_Image *CardImage::skewed(uint32_t id_)
 {
-	assert(_last_id.size());
-	return image(_last_id);
+	assert(_W != 0 && _H != 0);
+	Source &source = _sources[id_];
+	Key key{ id_, source.generation, (uint16_t)_W, (uint16_t)_H, Variant::SKEWED };
+	if (Fl_RGB_Image *img = cached(key))
+		return img;
+	if (pending_source(id_))
+		return placeholder(_W, _H / 3);
+	TRACE("CardImage::skewed_image");
+	Fl_RGB_Image *svg = scaled(id_, _W, _H);
+	assert(svg && svg->w() > 0 && svg->h() > 0);
+	Fl_RGB_Image *skewed_image = static_cast<Fl_RGB_Image *>(svg->copy());
+	skewed_image->scale(_W, _H / 3, 0, 1);
+	return insert(key, skewed_image);
 }
 
-Fl_RGB_Image *CardImage::skewed_image(const std::string &id_)
+/*static*/
+Fl_RGB_Image *CardImage::rot90(uint32_t id_)
 {
-	Fl_RGB_Image *svg = image(id_);
+	assert(_W != 0 && _H != 0);
+	Source &source = _sources[id_];
+	Key key{ id_, source.generation, (uint16_t)_W, (uint16_t)_H, Variant::ROT90 };
+	if (Fl_RGB_Image *img = cached(key))
+		return img;
+	if (pending(key))
+		return placeholder(_H, _W);
+	TRACE("CardImage::rot90_image");
+	Fl_RGB_Image *svg = scaled(id_, _W, _H);
 	assert(svg && svg->w() > 0 && svg->h() > 0);
+	Fl_RGB_Image *rot90_image = rotate_90_CCW(*svg);
+	DBG("rotate image '" << source.name << "' size (before scale): " << rot90_image->w() << "x" << rot90_image->h() << "\n");
+	rot90_image->scale(_H, _W, 0, 1);
+	return insert(key, rot90_image);
+}
+
+/*static*/
+Fl_RGB_Image *CardImage::rot90(uint32_t id_, int w_, int h_)
+{
+	// rotated image resized to w_ x h_ (e.g. squeezed for closing animation)
+	Source &source = _sources[id_];
+	Key key{ id_, source.generation, (uint16_t)w_, (uint16_t)h_, Variant::ROT90_SIZED };
+	if (Fl_RGB_Image *img = cached(key))
+		return img;
+	if (pending(Key{ id_, source.generation, (uint16_t)_W, (uint16_t)_H, Variant::ROT90 }))
+		return placeholder(w_, h_);
+	Fl_RGB_Image *rot90_image = rot90(id_);
+	if (rot90_image->w() == w_ && rot90_image->h() == h_)
+		return rot90_image;
+	return insert(key, static_cast<Fl_RGB_Image *>(rot90_image->copy(w_, h_)));
+}
+
+/*static*/
+Fl_RGB_Image *CardImage::highlighted(uint32_t id_)
+{
+	// card tinted yellow (e.g. card just drawn from pack)
+	assert(_W != 0 && _H != 0);
+	Source &source = _sources[id_];
+	Key key{ id_, source.generation, (uint16_t)_W, (uint16_t)_H, Variant::HIGHLIGHTED };
+	if (Fl_RGB_Image *img = cached(key))
+		return img;
+	if (pending_source(id_))
+		return placeholder(_W, _H);
+	TRACE("CardImage::highlighted_image");
+	Fl_RGB_Image *highlighted_image = static_cast<Fl_RGB_Image *>(scaled(id_, _W, _H)->copy());
+	highlighted_image->color_average(FL_YELLOW, 0.9);
+	return insert(key, highlighted_image);
+}
+
+/*static*/
+Fl_RGB_Image *CardImage::grayout(uint32_t id_, int w_, int h_)
+{
+	//
+	// Overlay of size w_ x h_ tiled with the inner half of the (shadow)
+	// image in card size, so that "graying out" a window is a single draw.
+	//
 	assert(_W != 0 && _H != 0);
-	Fl_RGB_Image *skewed_image = _images[id_ + "_skewed"];
-	if (svg->as_svg_image())
-		svg->as_svg_image()->resize(_W, _H);
-	if (!skewed_image
-		|| skewed_image->w() != _W || skewed_image->h() != _H / 3)
+	Source &source = _sources[id_];
+	Key key{ id_, source.generation, (uint16_t)w_, (uint16_t)h_, Variant::GRAYOUT };
+	if (Fl_RGB_Image *img = cached(key))
+		return img;
+	if (pending_source(id_))
+		return nullptr;
+	TRACE("CardImage::grayout_image");
+	Fl_RGB_Image *tile = scaled(id_, _W, _H);
+	int d = tile->d();
+	int tw = std::max(tile->data_w() / 2, 1);
+	int th = std::max(tile->data_h() / 2, 1);
+	int x0 = tile->data_w() / 4;
+	int y0 = tile->data_h() / 4;
+	size_t ld = tile->ld() ? tile->ld() : (size_t)tile->data_w() * d;
+	const uchar *src = (const uchar *)tile->data()[0];
+	uchar *data = new uchar[(size_t)w_ * h_ * d];
+	for (int y = 0; y < h_; y++)
 	{
-		delete skewed_image;
-		skewed_image = static_cast<Fl_RGB_Image *>(svg->copy());
-		_images[id_ + "_skewed"] = skewed_image;
+		const uchar *row = src + (y0 + y % th) * ld + x0 * d;
+		uchar *dst = data + (size_t)y * w_ * d;
+		for (int x = 0; x < w_; x += tw)
+			memcpy(dst + x * d, row, std::min(tw, w_ - x) * d);
 	}
-	assert(skewed_image);
-	skewed_image->scale(_W, _H / 3, 0, 1);
-	return skewed_image;
+	Fl_RGB_Image *grayout_image = new Fl_RGB_Image(data, w_, h_, d);
+	grayout_image->alloc_array = 1;
+	return insert(key, grayout_image);
+}
+
+Fl_RGB_Image *CardImage::image(const std::string &id_, int w_/* = 0*/, int h_/* = 0*/) const
+{
+	auto it = _ids.find(id_);
+	if (it == _ids.end())
+		return nullptr;
+	return scaled(it->second, w_ ? w_ : _W, h_ ? h_ : _H);
+}
+
+Fl_RGB_Image *CardImage::image(int w_/* = 0*/, int h_/* = 0*/) const
+{
+	assert(_id != NONE);
+	return scaled(_id, w_ ? w_ : _W, h_ ? h_ : _H);
+}
+
+Fl_RGB_Image *CardImage::skewed_image(const std::string &id_)
+{
+	_id = intern(id_);
+	return skewed(_id);
 }
 
 Fl_RGB_Image *CardImage::rot90_image(const std::string &id_)
 {
-	Fl_RGB_Image *svg = image(id_);
-	assert(svg && svg->w() > 0 && svg->h() > 0);
-	assert(_W != 0 && _H != 0);
-	Fl_RGB_Image *rot90_image = _images[id_ + "_quer"];
-	if (svg->as_svg_image())
-		svg->as_svg_image()->resize(_W, _H);
-	if (!rot90_image
-		|| rot90_image->w() != _H || rot90_image->h() != _W)
-	{
-		delete rot90_image;
-		rot90_image = rotate_90_CCW(*svg);
-		_images[id_ + "_quer"] = rot90_image;
-		DBG("rotate image '" << id_ << "' size (before scale): " << rot90_image->w() << "x" << rot90_image->h() << "\n");
-	}
-	assert(rot90_image);
-	rot90_image->scale(_H, _W, 0, 1);
-	return rot90_image;
+	_id = intern(id_);
+	return rot90(_id);
 }
 
 Fl_RGB_Image *CardImage::rot90_image()
 {
-	assert(_last_id.size());
-	return rot90_image(_last_id);
+	assert(_id != NONE);
+	return rot90(_id);
+}
+
+Fl_RGB_Image *CardImage::rot90_image(int w_, int h_)
+{
+	assert(_id != NONE);
+	return rot90(_id, w_, h_);
 }
 
 Fl_RGB_Image *CardImage::skewed_image()
 {
-	assert(_last_id.size());
-	return skewed_image(_last_id);
+	assert(_id != NONE);
+	return skewed(_id);
+}
+
+Fl_RGB_Image *CardImage::highlighted_image()
+{
+	assert(_id != NONE);
+	return highlighted(_id);
+}
+
+Fl_RGB_Image *CardImage::grayout_image(int w_, int h_)
+{
+	assert(_id != NONE);
+	return grayout(_id, w_, h_);
 }
 
 CardImage& CardImage::set_pixel_size(int w_, int h_)
@@ -187,4 +785,18 @@ CardImage& CardImage::set_pixel_size(int w_, int h_)
 
 /*static*/ int CardImage::_W = 0;
 /*static*/ int CardImage::_H = 0;
-/*static*/ std::unordered_map<std::string, Fl_RGB_Image *> CardImage::_images;
+/*static*/ std::unordered_map<std::string, uint32_t> CardImage::_ids;
+/*static*/ std::vector<CardImage::Source> CardImage::_sources;
+/*static*/ std::list<CardImage::Entry> CardImage::_lru;
+/*static*/ std::unordered_map<CardImage::Key, std::list<CardImage::Entry>::iterator, CardImage::KeyHash> CardImage::_cache;
+/*static*/ uint32_t CardImage::_generation = 0;
+/*static*/ CardImage::Stats CardImage::_stats;
+/*static*/ std::unordered_set<CardImage::Key, CardImage::KeyHash> CardImage::_jobs;
+/*static*/ int CardImage::_prerender_w = 0;
+/*static*/ int CardImage::_prerender_h = 0;
+/*static*/ std::mutex CardImage::_mutex;
+/*static*/ std::condition_variable CardImage::_wakeup;
+/*static*/ std::deque<std::unique_ptr<CardImage::Job>> CardImage::_queue;
+/*static*/ std::vector<std::unique_ptr<CardImage::Job>> CardImage::_done;
+/*static*/ std::vector<std::thread> CardImage::_workers;
+/*static*/ bool CardImage::_stopping = false;
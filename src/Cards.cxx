@@ -14,15 +14,29 @@
 #include <utility>
 #include <random>
 
-Cards::Cards() {}
+Cards::Cards()
+{
+	constructed()++;
+}
+
+Cards::Cards(const Cards &cards_) : Cards_(cards_)
+{
+	constructed()++;
+}
+
+Cards::Cards(Cards &&cards_) : Cards_(std::move(cards_))
+{
+	constructed()++;
+}
 
-Cards::Cards(const Cards_ &cards_)
+Cards::Cards(const Cards_ &cards_) : Cards_(cards_)
 {
-	*this = cards_;
+	constructed()++;
 }
 
 Cards::Cards(const Card &card_)
 {
+	constructed()++;
 	this->clear();
 	this->push_back(card_);
 }
@@ -30,6 +44,7 @@ Cards::Cards(const Card &card_)
 /*explicit*/
 Cards::Cards(const std::string &s_)
 {
+	constructed()++;
 	*this = from_string(s_);
 }
 
@@ -348,6 +363,14 @@ int Cards::value() const
 	return value;
 }
 
+/*static*/
+size_t &Cards::constructed()
+{
+	// NOTE: per thread, used by the decision statistics of the engine
+	thread_local size_t count = 0;
+	return count;
+}
+
 /*static*/
 Cards Cards::fullcards(CardSuite suite_/* = ANY_SUITE*/)
 {
@@ -357,8 +380,7 @@ Cards Cards::fullcards(CardSuite suite_/* = ANY_SUITE*/)
 		if (suite_ != ANY_SUITE && s != suite_) continue;
 		for (auto f : { JACK, QUEEN, KING, TEN, ACE } )
 		{
-			cards.emplace_back(f, s);
-			cards.back().load();
+			cards.emplace_back(f, s); // NOTE: images are loaded on demand
 		}
 	}
 	assert(cards.size() == (suite_ == ANY_SUITE ? 20 : 5));
@@ -0,0 +1,126 @@
+//
+// Part of "Schnapsen for 2" card game.
+//
+// (c) 2026 Christian Grabner
+//
+// Typed registry of often used config values.
+//
+
+#include "Config.h"
+#include "Util.h"
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+/*static*/
+const Config::Decl Config::decls[KEYS] = {
+	{ "loglevel",    Type::INT,    "0" },
+	{ "logfile",     Type::INT,    "2" },
+	{ "fast",        Type::BOOL,   "1" },
+	{ "lang",        Type::STRING, ""  },
+	{ "strict",      Type::INT,    "0" },
+	{ "animate",     Type::INT,    "2" },
+	{ "trump-sort",  Type::BOOL,   "0" },
+	{ "text-shadow", Type::BOOL,   "0" },
+	{ "welcome",     Type::BOOL,   "1" },
+	{ "fullscreen",  Type::BOOL,   "0" },
+	{ "image-cache", Type::INT,    "64" },	// MB
+	{ "idle-time",   Type::INT,    "60" }	// s (0 = never idle)
+};
+
+static std::vector<std::pair<size_t, Config::Listener>> &config_listeners()
+{
+	static std::vector<std::pair<size_t, Config::Listener>> listeners;
+	return listeners;
+}
+
+/*static*/
+Config::Value *Config::values()
+{
+	// defaults until config is loaded
+	static Value values[KEYS];
+	static bool init = []()
+	{
+		for (int k = 0; k < KEYS; k++)
+		{
+			values[k].str = decls[k].def;
+			values[k].i = atoi(decls[k].def);
+		}
+		return true;
+	}();
+	(void)init;
+	return values;
+}
+
+/*static*/
+const char *Config::name(Key key_)
+{
+	return decls[key_].name;
+}
+
+/*static*/
+bool Config::parse(Key key_)
+{
+	// returns true if value changed
+	auto it = Util::config().find(decls[key_].name);
+	const std::string &str = it != Util::config().end() && it->second.size() ? it->second : decls[key_].def;
+	Value &v = values()[key_];
+	if (v.str == str) return false;
+	v.str = str;
+	v.i = decls[key_].type == Type::STRING ? 0 : atoi(str.c_str());
+	return true;
+}
+
+/*static*/
+void Config::update(const std::string &name_)
+{
+	//
+	// Called when a config value was set.
+	//
+	for (int k = 0; k < KEYS; k++)
+	{
+		if (name_ != decls[k].name) continue;
+		if (parse(Key(k)))
+		{
+			for (auto &[id, listener] : config_listeners())
+				listener(Key(k));
+		}
+		break;
+	}
+}
+
+/*static*/
+void Config::sync()
+{
+	//
+	// Parse all values (after config was loaded or changed as a whole).
+	//
+	for (int k = 0; k < KEYS; k++)
+	{
+		if (parse(Key(k)))
+		{
+			for (auto &[id, listener] : config_listeners())
+				listener(Key(k));
+		}
+	}
+}
+
+/*static*/
+size_t Config::listen(const Listener &listener_)
+{
+	static size_t id = 0;
+	config_listeners().emplace_back(++id, listener_);
+	return id;
+}
+
+/*static*/
+void Config::unlisten(size_t id_)
+{
+	auto &listeners = config_listeners();
+	for (auto it = listeners.begin(); it != listeners.end(); ++it)
+	{
+		if (it->first != id_) continue;
+		listeners.erase(it);
+		break;
+	}
+}
@@ -13,6 +13,15 @@
 #include "Alert.h"
 #include "FontLoader.h"
 #include "AnimText.h"
+#include "Review.h"
+#include "GameLog.h"
+#include "GameRecord.h"
+#include "GameIndex.h"
+#include "GameFlow.h"
+#include "StatsStore.h"
+#include "Animator.h"
+#include "Flow.h"
+#include "Idle.h"
 
 #include <FL/Fl_Double_Window.H>
 #include <FL/Fl_Box.H>
@@ -23,6 +32,7 @@
 #include <FL/Fl_Input.H>
 #include <FL/Fl_File_Chooser.H>
 #include <FL/fl_draw.H>
+#include <FL/platform.H>
 
 #include <string>
 #include <vector>
@@ -146,12 +156,17 @@ class Deck : public Fl_Double_Window, public UI
 private:
 	struct CardAnimParams
 	{
-		CardAnimParams(DeckMemberFn func_ = nullptr) :
-			func(func_), cards(1), steps(5), closing(0) {}
-		DeckMemberFn func;
+		typedef void (Deck::*DrawFn)(const CardAnimParams &);
+		CardAnimParams(DrawFn func_ = nullptr) :
+			func(func_), cards(1), duration(0.1), easing(Animator::Easing::EASE_IN_OUT),
+			delay(0.), closing(0), id(0) {}
+		DrawFn func;
 		size_t cards;
-		int steps;
+		double duration;	// s
+		Animator::Easing easing;
+		double delay;		// s
 		int closing;
+		size_t id;		// in _animator
 		int src_X;
 		int src_Y;
 		int dest_X;
@@ -159,19 +174,58 @@ private:
 		int X;
 		int Y;
 	};
-	struct GameState
+	struct Layer
 	{
-		GameState(PlayerData &player_, PlayerData &ai_, GameData &game_) :
-			player(player_), ai(ai_), game(game_) {}
-		PlayerData player;
-		PlayerData ai;
-		GameData   game;
+		//
+		// Offscreen copy of a part of the scene, kept until
+		// window size or stamp (state it was drawn from) changes.
+		//
+		~Layer()
+		{
+			if (offscreen)
+				fl_delete_offscreen(offscreen);
+		}
+		bool begin(int w_, int h_, uint64_t stamp_)
+		{
+			// returns true (and starts drawing into offscreen) if layer must be drawn
+			if (offscreen && valid && w == w_ && h == h_ && stamp == stamp_)
+				return false;
+			if (offscreen && (w != w_ || h != h_))
+			{
+				fl_delete_offscreen(offscreen);
+				offscreen = 0;
+			}
+			if (!offscreen)
+				offscreen = fl_create_offscreen(w_, h_);
+			w = w_;
+			h = h_;
+			stamp = stamp_;
+			valid = true;
+			fl_begin_offscreen(offscreen);
+			return true;
+		}
+		void end() { fl_end_offscreen(); }
+		void draw() const { fl_copy_offscreen(0, 0, w, h, offscreen, 0, 0); }
+		void invalidate() { valid = false; }
+		Fl_Offscreen offscreen = 0;
+		int w = 0;
+		int h = 0;
+		uint64_t stamp = 0;
+		bool valid = false;
+	};
+	struct DamageStats
+	{
+		uint64_t frames = 0;
+		uint64_t full_frames = 0;
+		uint64_t pixels = 0;		// pixels redrawn
+		uint64_t window_pixels = 0;	// pixels of window (at each frame)
 	};
 public:
 	Deck() : Fl_Double_Window(800, 600),
 		_engine(_game, _player, _ai, *this),
+		_stats(Util::sta_file()),
 		_error_message(NO_MESSAGE),
-		_disabled(false),
+		_delaying(false),
 		_redeal(false),
 		_CW(w() / 8),
 		_CH(1.5 * w()),
@@ -182,32 +236,42 @@ public:
 		_welcome(nullptr),
 		_selector(nullptr),
 		_grayout(false),
-		_strictness(Util::config_as_int("strict")),
-		_animation_level(Util::config("animate").empty() ? 2 : Util::config_as_int("animate")),
+		_anim_scene(0),
+		_strictness(Config::as_int(Config::STRICT)),
+		_animation_level(Config::as_int(Config::ANIMATE)),
 		_show_ai_cards(false),
 		_restart(false),
+		_replaying(false),
+		_resume_flow(false),
+		_replay_speed(Util::config("replay-speed").empty() ? 1. : atof(Util::config("replay-speed").c_str())),
+		_game_flow(_game, _player, _ai, _engine, _log, _moves, *this),
 		_card_scale(1.0),
 		_player_anim_text(nullptr),
-		_ai_anim_text(nullptr)
+		_ai_anim_text(nullptr),
+		_logged_cards(0),
+		_logged_hands(0),
+		_damage_pixels(0)
 	{
 		// NOTE: FLTK (1.4) currently does not allow to update the internal font list after
 		// initial the Fl::set_fonts(). Therefore all maybe used fonts must be loaded at once.
 		FontLoader::load_dir(Util::rsc_dir().c_str());
 		load_font();
-		_game.trump_sort = Util::config_as_int("trump-sort");
-		_player.games_won = Util::stats_as_int("player_games_won");
-		_ai.games_won = Util::stats_as_int("ai_games_won");
-		_player.matches_won = Util::stats_as_int("player_matches_won");
-		_ai.matches_won = Util::stats_as_int("ai_matches_won");
+		_game.trump_sort = Config::as_bool(Config::TRUMP_SORT);
+		_engine.params(EngineParams(Util::config()));
+		_stats.load();
+		_player.games_won = _stats.counter(StatsStore::PLAYER_GAMES_WON);
+		_ai.games_won = _stats.counter(StatsStore::AI_GAMES_WON);
+		_player.matches_won = _stats.counter(StatsStore::PLAYER_MATCHES_WON);
+		_ai.matches_won = _stats.counter(StatsStore::AI_MATCHES_WON);
 		copy_label(Util::message(TITLE).c_str());
 		fl_register_images();
-		_shadow.image("card_shadow", Card::shadow_svg(), true);
-		_outline.image("card_outline", Card::outline_svg(), true);
-		_empty.image("card_empty", Card::empty_svg(), true);
+		_shadow.declare("card_shadow", Card::shadow_svg(), true);
+		_outline.declare("card_outline", Card::outline_svg(), true);
+		_empty.declare("card_empty", Card::empty_svg(), true);
+		declare_images();
 		_game.cards = Cards::fullcards();
 		assert(_game.cards.check());
 		_card_template = _game.cards[0];
-		_engine.unit_tests();
 		default_cursor(FL_CURSOR_HAND);
 		Fl_RGB_Image *icon = Card(QUEEN, HEART).image();
 		icon->normalize();
@@ -251,20 +315,42 @@ public:
 		{
 			static_cast<Deck *>(wgt_->window())->winning_claim();
 		});
-		if (Util::config("fullscreen") == "1")
+		if (Config::as_bool(Config::FULLSCREEN))
 		{
 			toggle_fullscreen();
 		}
+		Config::listen([this](Config::Key key_) { config_changed(key_); });
 		LOG("strictness: " << _strictness << ", animation_level: " << _animation_level << "\n");
-		_game.book.history(Util::stats("gamebook"));
+		_game.book.history(_stats.gamebooks());
 		apply_selections();
 	}
 
+	bool in_flow(const std::function<void()> &fn_)
+	{
+		// UI call of the game logic run by _fiber: done by the game flow
+		if (!_fiber.inside()) return false;
+		_fiber.suspend([&fn_]() -> Flow::Task<> { fn_(); co_return; });
+		return true;
+	}
+
 	void update() override
 	{
+		if (in_flow([this]() { update(); })) return;
+		debug();
 		redraw();
 	}
 
+	void update_text(const AnimText &text_) override
+	{
+		// next characters of message appear
+		if (&text_ == _ai_anim_text)
+			redraw_rect(message_area(AI));
+		else if (&text_ == _player_anim_text)
+			redraw_rect(message_area(PLAYER));
+		else
+			update();
+	}
+
 	bool test_change()
 	{
 		if (_game.cards.size() && _game.cards.back().face() != JACK &&
@@ -280,8 +366,12 @@ public:
 			_player.move_state = NONE;
 			_player.cards.push_back(_player.card);
 			_engine.sort_cards(_player.cards);
-			_engine.test_change(_player, true);
-			_player.last_drawn = c;
+			player_action([this, c]()
+			{
+				_engine.test_change(_player, true);
+				_player.last_drawn = c;
+				_log.add(GameLog::Type::EXCHANGE, PLAYER);
+			});
 			return true;
 		}
 		bell(NO_CHANGE);
@@ -301,7 +391,11 @@ public:
 			else
 			{
 				// do close
-				_engine.do_close(_player);
+				player_action([this]()
+				{
+					_engine.do_close(_player);
+					_log.add(GameLog::Type::CLOSE, PLAYER);
+				});
 				return true;
 			}
 		}
@@ -386,6 +480,7 @@ public:
 	{
 		bool player_deck_info = _player.deck_info;
 		bool ai_deck_info = _ai.deck_info;
+		Marriage marriage = _game.marriage;
 		if (_player.move_state != NONE && _ai.move_state == NONE)
 		{
 			if (_game.move == PLAYER)
@@ -400,15 +495,52 @@ public:
 			_ai.deck_info = _ai.deck.size() &&
 			                _ai.deck.front().rect().includes(Fl::event_x(), Fl::event_y());
 		}
-		if (_game.marriage != NO_MARRIAGE || _player.move_state == MOVING ||
+		if (_game.marriage != marriage)
+		{
+			redraw();
+		}
+		else if (_player.move_state == MOVING ||
 		    _player.deck_info || _ai.deck_info ||
 		    (_player.deck_info != player_deck_info) ||
 		    (_ai.deck_info != ai_deck_info))
 		{
-			redraw();
+			// only the items following the mouse changed
+			redraw_rect(_mouse_rect);
+			redraw_rect(mouse_rect());
 		}
 	}
 
+	void redraw_rect(Rect r_)
+	{
+		//
+		// Redraw only area r_: the damaged areas are collected by FLTK
+		// until the next draw(), which is then clipped to them.
+		//
+		if (!r_.defined()) return;
+		damage(FL_DAMAGE_USER1, r_.x, r_.y, r_.w, r_.h);
+		_damage_pixels += (uint64_t)r_.w * r_.h;
+	}
+
+	Rect mouse_rect() const
+	{
+		// area of items following the mouse (moving card with shadow and 20/40 blob, deck info)
+		int x = Fl::event_x();
+		int y = Fl::event_y();
+		if (_player.move_state == MOVING)
+			return Rect(x - _CW / 2, y - _CH / 2, _CW + _CW / 12, _CH + _CW / 12).inset(-2);
+		if (_player.deck_info || _ai.deck_info)
+			return Rect(x, y, _CW, _CH).inset(-2);
+		return Rect();
+	}
+
+	Rect anim_rect(const CardAnimParams &anim_) const
+	{
+		// area of animated cards (with shadow)
+		if (!_anim_scene) return Rect();
+		return Rect(anim_.X - _CW / 2, anim_.Y - _CH / 2,
+		            _CW + (anim_.cards - 1) * (_CW / 4) + _CW / 12, _CH + _CW / 12).inset(-2);
+	}
+
 	void change_card_scale(bool up_)
 	{
 		if (up_)
@@ -432,9 +564,51 @@ public:
 		redraw();
 	}
 
+	void config_changed(Config::Key key_)
+	{
+		// config value changed at runtime (e.g. by command 'set')
+		switch (key_)
+		{
+			case Config::STRICT:
+				_strictness = Config::as_int(Config::STRICT);
+				break;
+			case Config::ANIMATE:
+				_animation_level = Config::as_int(Config::ANIMATE);
+				break;
+			case Config::TRUMP_SORT:
+				_game.trump_sort = Config::as_bool(Config::TRUMP_SORT);
+				_engine.sort_cards(_player.cards);
+				_engine.sort_cards(_ai.cards);
+				break;
+			case Config::LANG:
+				copy_label(Util::message(TITLE).c_str());
+				break;
+			default:
+				return;
+		}
+		redraw();
+	}
+
 	bool handle_key()
 	{
-		if (Fl::event_key('q') && !_disabled && ::debug) // just for testing -> redeal
+		if (_replaying)
+		{
+			if (Fl::event_key(FL_Escape))
+			{
+				_replaying = false;
+				_delaying = false;
+				wake_flow();
+			}
+			else if (Fl::event_key('+') && _replay_speed < 64)
+				_replay_speed *= 2;
+			else if (Fl::event_key('-') && _replay_speed > 1./8)
+				_replay_speed /= 2;
+			else
+				return false;
+			DBG("replay speed: " << _replay_speed << "\n");
+			return true;
+		}
+		if (Fl::event_key('q') && !disabled() && ::debug) // just for testing -> redeal
 		{
 			redeal();
 		}
@@ -542,6 +716,7 @@ public:
 			std::string dir = Util::dirname(custom_font);
 			std::string font_path = dir.size() ? custom_font : Util::rsc_dir() + custom_font;
 			CustomFont = FontLoader::load(font_path.c_str(), fontName.c_str());
+			Util::clear_text_cache();
 			DBG("CustomFont: #" << CustomFont << "\n");
 			redraw();
 		}
@@ -554,6 +729,7 @@ public:
 			// clear font
 			Util::config("font", "");
 			CustomFont = FL_HELVETICA;
+			Util::clear_text_cache();
 			redraw();
 		}
 		else
@@ -577,12 +753,13 @@ public:
 
 	void handle_click(int x_, int y_)
 	{
-		if (_disabled)
+		if (_delaying)
 		{
-			// terminate wait()
-			_disabled = false;
+			// terminate delay()
+			_delaying = false;
 			return;
 		}
+		if (_player_action) return;	// (not yet done by the game flow)
 
 		_game.marriage = NO_MARRIAGE;
 		if (gamebook_rect().includes(x_, y_) && idle())
@@ -662,6 +839,8 @@ public:
 						_player.score += 40;
 					}
 				}
+				if (_game.marriage != NO_MARRIAGE)
+					_log.add(GameLog::Type::MARRIAGE, PLAYER, (uint8_t)_player.card.suite());
 				bell(PLACE_CARD, false);
 				_player.move_state = ON_TABLE; // _player.card is on table
 				return;
@@ -701,6 +880,10 @@ public:
 			//       during an XWayland session => CPU load 100%!!
 			return 1;
 		}
+		if (e_ == FL_PUSH || e_ == FL_KEYDOWN)
+			Trace::instant("input");
+		if (e_ == FL_PUSH || e_ == FL_KEYDOWN || e_ == FL_MOVE || e_ == FL_MOUSEWHEEL)
+			Idle::input();
 		int ret = Fl_Double_Window::handle(e_);
 		if (e_ == FL_MOVE )
 		{
@@ -724,12 +907,14 @@ public:
 		}
 		else if (e_ == FL_PUSH)
 		{
+			if (_replaying) return 1;	// (replayed game is not playable)
 			error_message(NO_MESSAGE);
 			Fl::remove_timeout(cb_sleep, this);
 			Fl::add_timeout(20., cb_sleep, this);
 			ai_message(NO_MESSAGE);
 			_game.move == AI ? _ai.last_drawn = Card() : _player.last_drawn = Card();
 			handle_click(Fl::event_x(), Fl::event_y());
+			wake_flow();
 			return 1;
 		}
 		else if (e_ == FL_MOUSEWHEEL)
@@ -797,6 +982,13 @@ public:
 		return r;
 	}
 
+	Rect message_area(Player player_) const
+	{
+		// area to redraw for message (text is centered and may be larger than message_rect())
+		Rect r = message_rect(player_);
+		return Rect(0, r.y - r.h / 2, w(), 2 * r.h);
+	}
+
 	Rect move_rect(Player player_) const
 	{
 		int ma = h() / 40 + _CH / 3 + h() / 40 + _CH / 2;
@@ -834,11 +1026,13 @@ public:
 
 	void draw_gamebook()
 	{
+		TRACE("Deck::draw_gamebook");
 		_game.book.draw(gamebook_rect());
 	}
 
 	void draw_deck_info(int x_, int y_, const Cards &deck_, int max_tricks_ = 8)
 	{
+		TRACE("Deck::draw_deck_info");
 		auto put_card = [&](const Card &c_, std::ostringstream &os_)
 		{
 			if (c_.is_red_suite())
@@ -881,16 +1075,19 @@ public:
 
 	void draw_player_deck_info(int x_, int y_)
 	{
+		TRACE("Deck::draw_player_deck_info");
 		draw_deck_info(x_, y_, _player.deck);
 	}
 
 	void draw_ai_deck_info(int x_, int y_)
 	{
+		TRACE("Deck::draw_ai_deck_info");
 		draw_deck_info(x_, y_, _ai.deck, 1);
 	}
 
 	void draw_blob(const char *text_, Fl_Color c_, int x_, int y_)
 	{
+		TRACE("Deck::draw_blob");
 		if (!(_player.move_state != NONE || _ai.move_state == ON_TABLE))
 			return;
 
@@ -913,6 +1110,7 @@ public:
 
 	void draw_suite_symbol(CardSuite suite_, int x_, int y_)
 	{
+		TRACE("Deck::draw_suite_symbol");
 		fl_font(FL_COURIER, _CH / 6);
 		fl_color(FL_BLACK);
 		Card c(ACE, suite_);
@@ -955,13 +1153,21 @@ public:
 
 	void draw_table()
 	{
-		fl_rectf(0, 0, w(), h(), background_color());
-		Fl_Image *bg = Util::get_shared_image(background_image());
-		if (bg && bg->w() && bg->h())
+		TRACE("Deck::draw_table");
+		std::string image = background_image();
+		Fl_Color color = background_color();
+		if (_table_layer.begin(w(), h(), std::hash<std::string>()(image) ^ ((uint64_t)color << 32)))
 		{
-			Fl_Tiled_Image tbg(bg, w(), h());
-			tbg.draw(0, 0, w(), h());
+			fl_rectf(0, 0, w(), h(), color);
+			Fl_Image *bg = Util::get_shared_image(image);
+			if (bg && bg->w() && bg->h())
+			{
+				Fl_Tiled_Image tbg(bg, w(), h());
+				tbg.draw(0, 0, w(), h());
+			}
+			_table_layer.end();
 		}
+		_table_layer.draw();
 	}
 
 	std::string format_message(Message msg_)
@@ -1003,11 +1209,11 @@ public:
 	{
 		Deck *deck = static_cast<Deck *>(d_);
 		deck->error_message(NO_MESSAGE);
-		deck->redraw();
 	}
 
 	void draw_messages()
 	{
+		TRACE("Deck::draw_messages");
 		if (_player.message != NO_MESSAGE)
 		{
 			std::string player_message = Util::message(_player.message);
@@ -1054,6 +1260,7 @@ public:
 
 	void draw_20_40_suites()
 	{
+		TRACE("Deck::draw_20_40_suites");
 #if 0
 		// TESTONLY
 		_player.s20_40.clear();
@@ -1083,6 +1290,7 @@ public:
 
 	void draw_cards()
 	{
+		TRACE("Deck::draw_cards");
 		for (size_t i = 0; i < _ai.cards.size(); i++)
 		{
 			int X = cards_rect(AI).x + i * w() / 20;
@@ -1099,21 +1307,11 @@ public:
 		for (size_t i = 0; i < _player.cards.size(); i++)
 		{
 			Card &c = _player.cards[i];
-			Fl_RGB_Image *image = c.image();
 			int X = cards_rect(PLAYER).x + i * w() / 20;
 			int Y = cards_rect(PLAYER).y;
-			if (_player.last_drawn.face() != NO_FACE &&
-			    _player.last_drawn.name() == c.name())
-			{
-				Fl_Image *temp = image->copy();
-				temp->color_average(FL_YELLOW, 0.9);
-				temp->draw(X, Y);
-				delete temp;
-			}
-			else
-			{
-				image->draw(X, Y);
-			}
+			Fl_RGB_Image *image = _player.last_drawn.face() != NO_FACE &&
+			                      _player.last_drawn.name() == c.name() ? c.highlighted_image() : c.image();
+			image->draw(X, Y);
 			int D = _CH / 20;
 			c.rect(Rect(X, Y + D, i == _player.cards.size() - 1 ? image->w() : w() / 20, _CH - 2 * D));
 		}
@@ -1130,143 +1328,240 @@ public:
 		}, this);
 	}
 
-	void do_animate(bool delete_ = true)
+	void start_animation(CardAnimParams anim_)
 	{
-		assert(_anim_params.func != nullptr);
-		int dx = _anim_params.dest_X - _anim_params.src_X;
-		int dy = _anim_params.dest_Y - _anim_params.src_Y;
+		// add animation (shown with the others by animations())
+		anim_.X = anim_.src_X;
+		anim_.Y = anim_.src_Y;
+		anim_.id = _animator.add(anim_.duration, anim_.easing, anim_.delay);
+		_anims.push_back(anim_);
+	}
 
-		for (int i = 0; i < _anim_params.steps; i++)
+	Flow::Task<> animations(bool static_scene_ = true)
+	{
+		//
+		// Show the started animations until all are finished.
+		// The positions follow the clock, so a slow frame skips
+		// frames, but does not make the animation last longer.
+		// The game flow is suspended between the frames.
+		//
+		TRACE("Deck::animations");
+		static uint64_t scene = 0;
+		_anim_scene = static_scene_ ? ++scene : 0;	// only the animated cards move
+		bool first = true;
+		while (_anims.size())
 		{
-			_anim_params.X = _anim_params.src_X + (floor)(((double)dx / _anim_params.steps) * i);
-			_anim_params.Y = _anim_params.src_Y + (floor)(((double)dy / _anim_params.steps) * i);
-			wait(1./50);
-			redraw();
+			_animator.frame();
+			for (auto &a : _anims)
+			{
+				double p = _animator.progress(a.id);
+				a.X = a.src_X + (int)std::lround((a.dest_X - a.src_X) * p);
+				a.Y = a.src_Y + (int)std::lround((a.dest_Y - a.src_Y) * p);
+				if (a.closing)
+					a.closing = 1 + std::min((int)(p * 4), 3);
+			}
+			if (first || !_anim_scene)
+			{
+				redraw();
+			}
+			else
+			{
+				// cards moved from where they were drawn last
+				for (auto &r : _anim_rects)
+					redraw_rect(r);
+				for (auto &a : _anims)
+					redraw_rect(anim_rect(a));
+			}
+			first = false;
+			if (!_animator.running() || !playing()) break;
+			co_await delay(_animator.interval());
+		}
+		for (auto &r : _anim_rects)
+			redraw_rect(r);
+		_animator.clear();
+		_anims.clear();
+		_anim_scene = 0;
+	}
+
+	int closing_phase() const
+	{
+		// phase 1..4 of closing animation (0 = not closing)
+		for (auto &a : _anims)
+		{
+			if (a.closing)
+				return a.closing;
 		}
-		if (delete_)
-			_anim_params = {};
+		return 0;
+	}
+
+	void animate(std::function<Flow::Task<>()> animation_)
+	{
+		//
+		// Animations of the game logic (run by _fiber) are awaited by
+		// the game flow, while the logic is suspended. Outside of the
+		// flow there is nothing to show them, so they are skipped.
+		//
+		if (_fiber.inside())
+			_fiber.suspend(std::move(animation_));
 	}
 
 	void animate_move() override
 	{
 		if (_animation_level == 0) return;
 
-		_anim_params = { &Deck::draw_animated_move };
-		_anim_params.src_X = cards_rect(_game.move).x + _CW / 2;
-		_anim_params.src_Y = cards_rect(_game.move).center().y;
+		animate([this]() -> Flow::Task<>
+		{
+			CardAnimParams anim(&Deck::draw_animated_move);
+			anim.src_X = cards_rect(_game.move).x + _CW / 2;
+			anim.src_Y = cards_rect(_game.move).center().y;
 
-		_anim_params.dest_X = move_rect(_game.move).center().x;
-		_anim_params.dest_Y = move_rect(_game.move).center().y;
+			anim.dest_X = move_rect(_game.move).center().x;
+			anim.dest_Y = move_rect(_game.move).center().y;
 
-		do_animate();
+			start_animation(anim);
+			co_await animations();
+		});
 	}
 
-	void animate_deal(Player player_, size_t cards_ = 1) override
+	void start_deal(Player player_, size_t cards_ = 1, double delay_ = 0.)
 	{
 		if (_animation_level < 2) return;
 
-		_anim_params = { &Deck::draw_animated_trick };
-		_anim_params.src_X = pack_rect().center().x;
-		_anim_params.src_Y = pack_rect().center().y;
+		CardAnimParams anim(&Deck::draw_animated_trick);
+		anim.src_X = pack_rect().center().x;
+		anim.src_Y = pack_rect().center().y;
 
-		_anim_params.dest_X = cards_rect(player_).center().x;
-		_anim_params.dest_Y = cards_rect(player_).center().y;
+		anim.dest_X = cards_rect(player_).center().x;
+		anim.dest_Y = cards_rect(player_).center().y;
 
-		_anim_params.cards = cards_;
+		anim.cards = cards_;
 		if (cards_ > 1)
-			_anim_params.steps = 10;
+			anim.duration = 0.2;
+		anim.easing = Animator::Easing::EASE_OUT;
+		anim.delay = delay_;
 
-		do_animate();
+		start_animation(anim);
 	}
 
-	void animate_fillup(Player player_)
+	void animate_deal(Player player_, size_t cards_ = 1) override
+	{
+		if (_animation_level < 2) return;
+
+		animate([this, player_, cards_]() -> Flow::Task<>
+		{
+			start_deal(player_, cards_);
+			co_await animations();
+		});
+	}
+
+	void animate_deal_both(Player first_, size_t cards_ = 1, double delay_ = 0.05) override
 	{
-		animate_deal(player_);
+		if (_animation_level < 2) return;
+
+		animate([this, first_, cards_, delay_]() -> Flow::Task<>
+		{
+			start_deal(first_, cards_);
+			start_deal(first_ == PLAYER ? AI : PLAYER, cards_, delay_);
+			co_await animations();
+		});
 	}
 
 	void animate_shuffle() override
 	{
 		if (_animation_level < 2) return;
 
-		Cards save = _game.cards;
-		_game.cards.clear();
+		animate([this]() -> Flow::Task<>
+		{
+			Cards save = _game.cards;
+			_game.cards.clear();
 
-		_anim_params = { &Deck::draw_animated_trick };
+			CardAnimParams anim(&Deck::draw_animated_trick);
 
-		_anim_params.src_X = pack_rect().x;
-		_anim_params.src_Y = pack_rect().y;
+			anim.src_X = pack_rect().x;
+			anim.src_Y = pack_rect().y;
 
-		_anim_params.dest_X = pack_rect().center().x;
-		_anim_params.dest_Y = pack_rect().center().y;
+			anim.dest_X = pack_rect().center().x;
+			anim.dest_Y = pack_rect().center().y;
 
-		static constexpr int step = 3;
+			static constexpr int step = 3;
 
-		for (size_t i = 0; i < save.size(); i += step)
-		{
-			for (int c = 0; c < step; c++)
+			for (size_t i = 0; i < save.size(); i += step)
 			{
-				if (i + c < save.size())
-					_game.cards.push_back(save[i + c]);
+				for (int c = 0; c < step; c++)
+				{
+					if (i + c < save.size())
+						_game.cards.push_back(save[i + c]);
+				}
+				start_animation(anim);
+				co_await animations();
 			}
-			do_animate(false);
-		}
-		assert(_game.cards == save);
-		_game.cards = save;
-		_anim_params = {};
+			assert(_game.cards == save);
+			_game.cards = save;
+		});
 	}
 
 	void animate_trick() override
 	{
 		if (_animation_level == 0) return;
 
-		_anim_params = { &Deck::draw_animated_trick };
-		_anim_params.src_X = move_rect(_game.move).center().x;
-		_anim_params.src_Y = move_rect(_game.move).center().y;
+		animate([this]() -> Flow::Task<>
+		{
+			CardAnimParams anim(&Deck::draw_animated_trick);
+			anim.src_X = move_rect(_game.move).center().x;
+			anim.src_Y = move_rect(_game.move).center().y;
 
-		_anim_params.dest_X = deck_rect(_game.move).center().x;
-		_anim_params.dest_Y = deck_rect(_game.move).center().y;
+			anim.dest_X = deck_rect(_game.move).center().x;
+			anim.dest_Y = deck_rect(_game.move).center().y;
 
-//		_anim_params.cards = 2; // would be correct, but not really visible
+//			anim.cards = 2; // would be correct, but not really visible
 
-		do_animate();
+			start_animation(anim);
+			co_await animations();
+		});
 	}
 
 	void animate_change(bool from_hand_ = false) override
 	{
 		if (_animation_level == 0) return;
 
-		_anim_params = { &Deck::draw_animated_change };
-		_anim_params.src_X = change_rect().center().x;
-		_anim_params.src_Y = change_rect().center().y;
+		animate([this, from_hand_]() -> Flow::Task<>
+		{
+			CardAnimParams anim(&Deck::draw_animated_change);
+			anim.src_X = change_rect().center().x;
+			anim.src_Y = change_rect().center().y;
 
-		_anim_params.dest_X = cards_rect(_game.move).center().x;
-		_anim_params.dest_Y = cards_rect(_game.move).center().y;
+			anim.dest_X = cards_rect(_game.move).center().x;
+			anim.dest_Y = cards_rect(_game.move).center().y;
 
-		if (from_hand_)
-		{
-			std::swap(_anim_params.src_X, _anim_params.dest_X);
-			std::swap(_anim_params.src_Y, _anim_params.dest_Y);
-		}
-		_anim_params.steps = 10;
-		do_animate();
+			if (from_hand_)
+			{
+				std::swap(anim.src_X, anim.dest_X);
+				std::swap(anim.src_Y, anim.dest_Y);
+			}
+			anim.duration = 0.2;
+			start_animation(anim);
+			co_await animations();
+		});
 	}
 
 	void animate_close() override
 	{
 		if (_animation_level == 0) return;
 
-		_anim_params = { &Deck::draw_closing };
-
-		for (_anim_params.closing = 1; _anim_params.closing <= 4; _anim_params.closing++)
+		animate([this]() -> Flow::Task<>
 		{
-			redraw();
-			wait(1./30);
-		}
-		_anim_params = {};
+			CardAnimParams anim(&Deck::draw_closing);
+			anim.closing = 1;
+			anim.duration = 4./30;
+			anim.easing = Animator::Easing::LINEAR;
+			start_animation(anim);
+			co_await animations(false);	// pack changes with closing phase
+		});
 	}
 
 	void draw_pack()
 	{
+		TRACE("Deck::draw_pack");
 		auto card_stack_pos = [&](size_t i) -> double
 		{
 			// Calculate the space between cards on pack for card `i`.
@@ -1288,7 +1583,7 @@ public:
 		{
 			int X = change_rect().x;
 			int Y = change_rect().y;
-			if (_game.closed == NOT && _game.cards.size() != 20 && _player.cards.size() > 3 && !_anim_params.closing)
+			if (_game.closed == NOT && _game.cards.size() != 20 && _player.cards.size() > 3 && !closing_phase())
 			{
 				_game.cards.back().rot90_image()->draw(X, Y);
 				_game.cards.back().rect(Rect(X, Y, _game.cards.back().image()->h(), _game.cards.back().image()->w()));
@@ -1328,7 +1623,7 @@ public:
 			_outline.image()->draw(X, Y);
 		}
 
-		if (_game.closed != NOT && _game.cards.size() && !_anim_params.closing)
+		if (_game.closed != NOT && _game.cards.size() && !closing_phase())
 		{
 			int SW = card_stack_pos(_game.cards.size() - 1); // TEST: shadow size depends on stack size
 			int X = pack_rect().x;
@@ -1346,6 +1641,7 @@ public:
 
 	void draw_decks()
 	{
+		TRACE("Deck::draw_decks");
 		// show played pack
 		auto draw_deck_cards = [&](size_t size_, int x_, int y_)
 		{
@@ -1381,6 +1677,7 @@ public:
 
 	void draw_move()
 	{
+		TRACE("Deck::draw_move");
 		// cards moving or on table
 		if (_ai.move_state == ON_TABLE)
 		{
@@ -1405,6 +1702,7 @@ public:
 
 	void draw_scores()
 	{
+		TRACE("Deck::draw_scores");
 		if (_player.score)
 		{
 			bool show_closed_score = _game.closed == BY_AI && _strictness > 0;
@@ -1427,6 +1725,7 @@ public:
 
 	void draw_version()
 	{
+		TRACE("Deck::draw_version");
 		fl_font(FL_HELVETICA, _CH / 20);
 		fl_color(FL_YELLOW);
 		std::ostringstream os;
@@ -1436,63 +1735,67 @@ public:
 
 	void draw_grayout()
 	{
+		TRACE("Deck::draw_grayout");
 		if (Fl::first_window() != this || _grayout)
 		{
 			// use shadow image to "gray out" deck
-			for (int x = 0; x < w(); x += _CW / 2)
-				for (int y = 0; y < h(); y += _CH / 2)
-					_shadow.image()->draw(x, y, _CW / 2, _CH / 2, _CW / 4, _CH / 4);
+			if (Fl_RGB_Image *image = _shadow.grayout_image(w(), h()))
+				image->draw(0, 0);
 		}
 	}
 
-	void draw_closing()
+	void draw_closing(const CardAnimParams &anim_)
 	{
+		TRACE("Deck::draw_closing");
 		int X = pack_rect().x + pack_rect().w;
 		int Y = change_rect().center().y;
-		int closing = _anim_params.closing;
+		int closing = anim_.closing;
 		if (closing >= 1 && closing <= 4)
 		{
 			Fl_RGB_Image *image = closing <= 2 ? _game.cards.back().rot90_image() : _back.rot90_image();
 			int W = (closing == 1 || closing == 4) ? (image->w() / 3) * 2 : image->w() / 2;
-			Fl_Image *temp = image->copy(W, image->h());
+			int H = image->h();
+			image = closing <= 2 ? _game.cards.back().rot90_image(W, H) : _back.rot90_image(W, H);
 			// NOTE: shadow should be from rotated image, but it is not noticable..
-			Fl_Image *stemp = _shadow.image()->copy(W, image->h());
-			X -= temp->w() / 2;
-			Y -= temp->h() / 2;
-			stemp->draw(X + _CW / 12, Y + _CW / 12);
-			temp->draw(X, Y);
-			delete stemp;
-			delete temp;
+			Fl_RGB_Image *shadow = _shadow.image(W, H);
+			X -= W / 2;
+			Y -= H / 2;
+			shadow->draw(X + _CW / 12, Y + _CW / 12);
+			image->draw(X, Y);
 		}
 	}
 
-	void draw_animated_trick()
+	void draw_animated_trick(const CardAnimParams &anim_)
 	{
-		int X = _anim_params.X - _CW / 2;
-		int Y = _anim_params.Y - _CH / 2;
-		for (size_t i = 0; i < _anim_params.cards; i++)
+		TRACE("Deck::draw_animated_trick");
+		int X = anim_.X - _CW / 2;
+		int Y = anim_.Y - _CH / 2;
+		for (size_t i = 0; i < anim_.cards; i++)
 		{
 			_shadow.image()->draw(X + _CW / 12 + i * (_CW / 4), Y + _CW / 12);
 			_back.image()->draw(X + i * (_CW / 4), Y);
 		}
 	}
 
-	void draw_animated_move()
+	void draw_animated_move(const CardAnimParams &anim_)
 	{
-		int X = _anim_params.X - _CW / 2;
-		int Y = _anim_params.Y - _CH / 2;
+		TRACE("Deck::draw_animated_move");
+		int X = anim_.X - _CW / 2;
+		int Y = anim_.Y - _CH / 2;
 		_shadow.image()->draw(X + _CW / 12, Y + _CW / 12);
 		_game.move == AI ? _ai.card.image()->draw(X, Y) : _player.card.image()->draw(X, Y);
 	}
 
-	void draw_animated_change()
+	void draw_animated_change(const CardAnimParams &anim_)
 	{
+		TRACE("Deck::draw_animated_change");
 		// same as:
-		draw_animated_move();
+		draw_animated_move(anim_);
 	}
 
 	void draw_debug_rects()
 	{
+		TRACE("Deck::draw_debug_rects");
 		auto draw_rect = [&](Rect r, Fl_Color c_ = FL_GREEN) -> void
 		{
 			fl_color(c_);
@@ -1527,12 +1830,41 @@ public:
 
 		draw_rect(on_table_rect(PLAYER));
 		draw_rect(cards_area_rect(), FL_YELLOW);
+
+		draw_debug_decision();
+	}
+
+	void draw_debug_decision()
+	{
+		TRACE("Deck::draw_debug_decision");
+		// instrumentation of last AI decision
+		const Decision &d = _engine.decision();
+		if (!d.calls && !*d.branch) return;
+		fl_font(FL_HELVETICA, _CH / 20);
+		fl_color(FL_YELLOW);
+		std::ostringstream os;
+		os << d.branch << "\n" << (int)d.us << "us, " << d.cards << " Cards, "
+		   << d.calls << " calls, depth " << d.depth;
+		Rect r = message_rect(AI);
+		Util::draw_string(os.str(), r.x, r.y + r.h + fl_height(), true);
+	}
+
+	Rect sleep_rect() const
+	{
+		return Rect(pack_rect().center().x - _CW / 4, pack_rect().y - _CW, _CW / 2, _CW / 2).inset(-2);
+	}
+
+	static void cb_sleepy_face(void *d_)
+	{
+		Deck *deck = static_cast<Deck *>(d_);
+		deck->redraw_rect(deck->sleep_rect());
 	}
 
 	bool check_sleep(bool cancel_)
 	{
 		if (_ai.message != AI_SLEEP)
 		{
+			Idle::remove(cb_sleepy_face, this);
 			Fl::remove_timeout(cb_sleep, this);
 			Fl::add_timeout(20.0, cb_sleep, this);
 		}
@@ -1553,11 +1885,9 @@ public:
 			draw_table();
 			sleepyFace.draw(X, Y, sleepyFace.w(), sleepyFace.h());
 			fl_pop_clip();
-			Fl::add_timeout(1./10, [](void *d_)
-			{
-				Deck *deck = static_cast<Deck *>(d_);
-				deck->redraw();
-			}, this);
+			// (animation stops when idle)
+			if (!Idle::has_repeat(cb_sleepy_face, this))
+				Idle::repeat(1./10, cb_sleepy_face, this);
 			return true;
 		}
 		return false;
@@ -1565,6 +1895,9 @@ public:
 
 	void draw() override
 	{
+		TRACE("Deck::draw");
+		CardImage::trim();	// images of last draw are no longer in use
+		update_damage_stats();
 		// measure a "standard card"
 		double ratio = (double)w() / h();
 		int W = (w() / 8 + (ratio >= 800. / 600 ? h() / 5 : h() / 10)) / 2;
@@ -1578,12 +1911,72 @@ public:
 		_CW = W;
 		_CH = H;
 		_card_template.set_pixel_size(_CW, _CH);
+		if (scale_change)
+			prerender_images();
 		Rect r(cards_rect(PLAYER));
 		W = w() / 20 * (_player.cards.size() - 1) + _CW;
 		_winning_button->resize(r.x, r.y + r.h, W, h() - (r.y + r.h));
 
 		if (check_sleep(scale_change)) return;
 
+		if (_anims.size() && _anim_scene)
+		{
+			// animation frame: static scene is drawn once, then only copied
+			if (_scene_layer.begin(w(), h(), _anim_scene))
+			{
+				uint64_t placeholders = CardImage::stats().placeholders;
+				draw_scene();
+				_scene_layer.end();
+				if (CardImage::stats().placeholders != placeholders)
+					_scene_layer.invalidate();	// draw again with the images
+			}
+			_scene_layer.draw();
+		}
+		else
+		{
+			draw_scene();
+		}
+		_anim_rects.clear();
+		for (auto &a : _anims)
+		{
+			std::invoke(a.func, this, a);
+			_anim_rects.push_back(anim_rect(a));
+		}
+		_mouse_rect = mouse_rect();
+		if (_player.deck_info)
+			draw_player_deck_info(Fl::event_x(), Fl::event_y());
+		if (_ai.deck_info)
+			draw_ai_deck_info(Fl::event_x(), Fl::event_y());
+		draw_version();
+		if (::debug >= 3)
+			draw_debug_rects();
+		if (!disabled())
+			draw_children();
+		draw_grayout();
+	}
+
+	void update_damage_stats()
+	{
+		// partial redraw: only areas given by redraw_rect() (clipped)
+		uint64_t window = (uint64_t)w() * h();
+		bool partial = (damage() & ~FL_DAMAGE_EXPOSE) == FL_DAMAGE_USER1;
+		_damage_stats.frames++;
+		_damage_stats.window_pixels += window;
+		if (partial)
+		{
+			_damage_stats.pixels += std::min(_damage_pixels, window);
+		}
+		else
+		{
+			_damage_stats.full_frames++;
+			_damage_stats.pixels += window;
+		}
+		_damage_pixels = 0;
+	}
+
+	void draw_scene()
+	{
+		TRACE("Deck::draw_scene");
 		draw_table();
 		draw_gamebook();
 		if (_game.trump != NO_SUITE)
@@ -1595,18 +1988,6 @@ public:
 		draw_decks();
 		draw_move();
 		draw_scores();
-		if (_anim_params.func)
-			std::invoke(_anim_params.func, this);
-		if (_player.deck_info)
-			draw_player_deck_info(Fl::event_x(), Fl::event_y());
-		if (_ai.deck_info)
-			draw_ai_deck_info(Fl::event_x(), Fl::event_y());
-		draw_version();
-		if (::debug >= 3)
-			draw_debug_rects();
-		if (!_disabled)
-			draw_children();
-		draw_grayout();
 	}
 
 	bool load_game(const std::string &name_);
@@ -1615,6 +1996,7 @@ public:
 	void onCmd()
 	{
 		onCmd(_cmd);
+		wake_flow();
 	}
 
 	void toggle_fullscreen()
@@ -1673,12 +2055,25 @@ public:
 			cardback = "Card_back_red.svg";
 			Util::config("cardback", cardback);
 		}
-		_back.image("card_back", card_root + "back/" + cardback);
-		for (auto &c : _game.cards) c.reload();
-		for (auto &c : _player.cards) c.reload();
-		for (auto &c : _ai.cards) c.reload();
-		for (auto &c : _player.deck) c.reload();
-		for (auto &c : _ai.deck) c.reload();
+		_back.declare("card_back", card_root + "back/" + cardback);
+		declare_images();
+		prerender_images();
+	}
+
+	void declare_images()
+	{
+		// images of current cardset (all card objects share them)
+		for (auto &c : Cards::fullcards())
+			CardImage().declare(c.name(), Util::cardset_dir() + c.filename());
+	}
+
+	void prerender_images()
+	{
+		// prepare all card images in the current card size (in background)
+		std::vector<std::string> ids{ "card_back", "card_shadow", "card_outline", "card_empty" };
+		for (auto &c : Cards::fullcards())
+			ids.push_back(c.name());
+		CardImage::prerender(ids, _CW, _CH);
 	}
 
 	void selector()
@@ -1696,16 +2091,20 @@ public:
 		redraw();
 	}
 
+	static void cb_flicker(void *d_)
+	{
+		Deck *deck = static_cast<Deck *>(d_);
+		deck->_grayout = false;
+		deck->redraw();
+	}
+
 	void flicker()
 	{
-		for (int i = 0; i < 2; i++)
-		{
-			_grayout = !_grayout;
-			redraw();
-			wait(0.1);
-		}
-		_grayout = false;
+		// gray out shortly (by timer, the caller is not blocked)
+		_grayout = true;
 		redraw();
+		Fl::remove_timeout(cb_flicker, this);
+		Fl::add_timeout(0.1, cb_flicker, this);
 	}
 
 	//
@@ -1714,26 +2113,28 @@ public:
 
 	void debug(bool unconditional_ = false) const
 	{
+		if (!Log::compiled(Log::INFO) || !Log::enabled(Log::INFO)) return;
+
+		// fingerprint of cards (instead of keeping copies)
+		auto hash = [](uint64_t h_, const Cards &cards_)
+		{
+			for (auto &c : cards_)
+				h_ = (h_ ^ ((int)c.face() * 4 + (int)c.suite() + 1)) * 1099511628211ull;
+			return (h_ ^ 0xff) * 1099511628211ull;
+		};
+
 		// log only when change of deck cards
-		static Cards cards;
-		if (unconditional_ == true ||
-			cards != _game.cards)
+		uint64_t cards = hash(14695981039346656037ull, _game.cards);
+		if (unconditional_ == true || cards != _logged_cards)
 		{
-			cards = _game.cards;
-			LOG("cards: " << cards << " (" << cards.size() << ")\n");
+			_logged_cards = cards;
+			LOG("cards: " << _game.cards << " (" << _game.cards.size() << ")\n");
 		}
 		// log only when change of playing cards
-		static Cards player_cards;
-		static Cards ai_cards;
-		static int player_score = 0;
-		static int ai_score = 0;
-		if (unconditional_ == false &&
-			_ai.cards == ai_cards && _player.cards == player_cards &&
-			_ai.score == ai_score && _player.score == player_score) return; // no change
-		player_cards = _player.cards;
-		ai_cards = _ai.cards;
-		player_score = _player.score;
-		ai_score = _ai.score;
+		uint64_t hands = hash(hash(14695981039346656037ull ^ (_player.score << 8 | _ai.score),
+		                           _player.cards), _ai.cards);
+		if (unconditional_ == false && hands == _logged_hands) return; // no change
+		_logged_hands = hands;
 
 		LOG("PL deck: " << _player.deck << " (" << _player.deck.size() << ")\n");
 		LOG("AI deck: " << _ai.deck << " (" << _ai.deck.size() << ")\n");
@@ -1765,198 +2166,15 @@ public:
 		for ([[maybe_unused]]auto s : _player.s20_40)
 			LOG(Card::suite_symbol(s));
 		LOG("\n");
-		Util::logstream().flush();
 	}
 
 	void init2()
 	{
+		_game_flow.reset();
 		player_message(NO_MESSAGE);
 		ai_message(NO_MESSAGE);
 		error_message(NO_MESSAGE);
-		_game.closed = NOT;
-		_game.marriage = NO_MARRIAGE;
-		_game.trump = NO_SUITE;
-		_player.s20_40.clear();
-		_ai.s20_40.clear();
-		_player.score = 0;
-		_player.score_closed = 0;
-		_player.pending = 0;
-		_ai.score = 0;
-		_ai.score_closed = 0;
-		_ai.pending = 0;
-		_ai.display_score = false;
-		_player.message = NO_MESSAGE;
-		_ai.message = NO_MESSAGE;
-		_error_message = NO_MESSAGE;
-		_player.move_state = NONE;
-		_ai.move_state = NONE;
-		_disabled = false;
 		_redeal = false;
-		_player.deck_info = false;
-		_ai.deck_info = false;
-	}
-
-	void init()
-	{
-		collect();
-		init2();
-		_game.cards.shuffle();
-		assert(_game.cards.size() == 20);
-		bell(SHUFFLE);
-		animate_shuffle();
-		debug();
-		deal();
-		assert(_player.cards.size() == 5);
-		assert(_ai.cards.size() == 5);
-		_engine.sort_cards(_player.cards)
-		       .sort_cards(_ai.cards);
-		assert(_player.cards.size() == 5);
-		assert(_ai.cards.size() == 5);
-		redraw();
-		debug();
-	}
-
-	void collect()
-	{
-		LOG("collect\n");
-		for (auto &c : _player.cards)
-			_game.cards.push_front(c);
-		for (auto &c : _player.deck)
-			_game.cards.push_front(c);
-		for (auto &c :_ai.cards)
-			_game.cards.push_front(c);
-		for (auto &c :_ai.deck)
-			_game.cards.push_front(c);
-		_player.cards.clear();
-		_ai.cards.clear();
-		_player.deck.clear();
-		_ai.deck.clear();
-		if (_player.move_state != NONE)
-			_game.cards.push_front(_player.card);
-		if (_ai.move_state != NONE)
-			_game.cards.push_front(_ai.card);
-		if (_game.cards.size() != 20)
-			DBG("#cards: " << _game.cards.size())
-		assert(_game.cards.size() == 20);
-		assert(_game.cards.check());
-	}
-
-	void deal()
-	{
-		LOG("dealer is " << (_game.move == PLAYER ? "AI" : "PLAYER") << "\n");
-		// 3 cards to player
-		animate_deal(_game.move == PLAYER ? PLAYER : AI, 3);
-		for (size_t i = 0; i < 3; i++)
-		{
-			Card c = _game.cards.front();
-			_game.cards.pop_front();
-			_game.move == PLAYER ? _player.cards.push_front(c) : _ai.cards.push_front(c);
-		}
-
-		// 3 cards to ai
-		animate_deal(_game.move == PLAYER ? AI : PLAYER, 3);
-		for (size_t i = 0; i < 3; i++)
-		{
-			Card c = _game.cards.front();
-			_game.cards.pop_front();
-			_game.move == PLAYER ? _ai.cards.push_front(c) : _player.cards.push_front(c);
-		}
-
-		// trump card
-		Card trump = _game.cards.front();
-		_game.cards.pop_front();
-		_game.cards.push_back(trump); // will be the last card (_game.cards.back())
-		_game.trump = trump.suite();
-		LOG("trump: " << Card::suite_symbol(_game.trump) << "\n");
-		redraw();
-
-		// 2 cards to player
-		animate_deal(_game.move == PLAYER ? PLAYER : AI, 2);
-		for (size_t i = 0; i < 2; i++)
-		{
-			Card c = _game.cards.front();
-			_game.cards.pop_front();
-			_game.move == PLAYER ? _player.cards.push_front(c) : _ai.cards.push_front(c);
-		}
-
-		// 2 cards to ai
-		animate_deal(_game.move == PLAYER ? AI : PLAYER, 2);
-		for (size_t i = 0; i < 2; i++)
-		{
-			Card c = _game.cards.front();
-			_game.cards.pop_front();
-			_game.move == PLAYER ? _ai.cards.push_front(c) : _player.cards.push_front(c);
-		}
-
-		if (::debug)
-		{
-			// TEST TEST
-			Suites res;
-			res = _engine.have_40(_player.cards);
-			if (res.size())
-				DBG("player cards contain 40!\n")
-			res = _engine.have_20(_player.cards);
-			if (res.size())
-				DBG("player cards contain " << res.size() << "x20!\n")
-			res = _engine.have_40(_ai.cards);
-			if (res.size())
-				DBG("AI cards contain 40!\n")
-			res = _engine.have_20(_ai.cards);
-			if (res.size())
-				DBG("AI cards contain " << res.size() << "x20!\n")
-			Move i = _engine.find(Card(JACK, _game.cards.back().suite()), _player.cards);
-			if (i)
-				DBG("player cards can change Jack!\n")
-			i = _engine.find(Card(JACK, _game.cards.back().suite()), _ai.cards);
-			if (i)
-				DBG("AI cards can change Jack!\n")
-		}
-	}
-
-	void fillup_cards()
-	{
-		if (_game.closed == NOT && _player.cards.size() < 5 && _ai.cards.size() < 5)
-		{
-			// give cards from pack
-			if (_game.cards.size())
-			{
-				Card c = _game.cards.front();
-				_game.cards.pop_front();
-				_game.move == AI ? _ai.last_drawn = c : _player.last_drawn = c;
-
-				animate_fillup(_game.move == AI ? AI : PLAYER);
-
-				if (_game.move == AI)
-					_ai.cards.push_front(c);
-				else
-					_player.cards.push_front(c);
-			}
-
-			if (_game.cards.size())
-			{
-				Card c = _game.cards.front();
-				_game.move == PLAYER ? _ai.last_drawn = c : _player.last_drawn = c;
-				_game.cards.pop_front();
-
-				animate_fillup(_game.move == AI ? PLAYER : AI);
-
-				if (_game.move == AI)
-					_player.cards.push_front(c);
-				else
-					_ai.cards.push_front(c);
-			}
-			assert(_player.cards.size() == _ai.cards.size());
-			_engine.sort_cards(_player.cards)
-			       .sort_cards(_ai.cards);
-			debug();
-
-			if (_game.cards.empty())
-			{
-				_game.closed = AUTO; // same rules as closing now
-				LOG("*** pack cleared - end game ***\n");
-			}
-		}
-		redraw();
 	}
 
 	void show_win_msg() override
@@ -1983,21 +2201,23 @@ public:
 
 	void save_config() const
 	{
+		TRACE("Deck::save_config");
 		Util::config("cards", std::string()); // don't save cards string!
 		Util::config("width", std::to_string(w()));
 		Util::config("height", std::to_string(h()));
 		Util::config("xpos", std::to_string(x()));
 		Util::config("ypos", std::to_string(y()));
 		Util::config("card_scale", std::to_string(_card_scale));
+		Util::config("replay-speed", std::to_string(_replay_speed));
 #ifdef USE_MINIAUDIO
 		Util::config("volume", std::to_string(_audio.volume()));
 #endif
 		Util::save_config();
 	}
 
-	void save_stats() const
+	void save_stats()
 	{
-		Util::save_stats();
+		_stats.compact();
 	}
 
 	void save_gamebook()
@@ -2006,29 +2226,11 @@ public:
 
 		_game.book.reset_current();
 
-		// append current gamebook to saved gamebooks
-		std::string gb = Util::stats("gamebook");
-
-		// count entries
-		int entries = gb.empty() ? 0 : 1;
-		size_t pos = (size_t)-1;
-		while ((pos = gb.find(';', ++pos)) != std::string::npos) entries++;
-
-		// limit to last 10 entries
-		for (int i = 0; i < entries - 10; i++)
-		{
-			pos = gb.find(';');
-			if (pos == std::string::npos) break;
-			gb.erase(0, pos + 1);
-		}
-		// add current gamebook to back of entries
-		std::string gamebook = gb + (gb.size() ? ";" : "") + _game.book.str();
-
-		// write to file
-		Util::stats("gamebook", gamebook);
+		// append current gamebook to saved gamebooks (last 10 are kept)
+		_stats.add(_game.book);
 
 		// update history display
-		_game.book.history(gamebook);
+		_game.book.history(_stats.gamebooks());
 	}
 
 	bool check_end_match()
@@ -2042,7 +2244,7 @@ public:
 		{
 			LOG("You win match " << pscore << ":" << ascore << "\n");
 			_player.matches_won++;
-			Util::stats("player_matches_won", std::to_string(_player.matches_won));
+			_stats.add(StatsStore::PLAYER_MATCHES_WON);
 			bell(YOU_WIN);
 			show_win_msg();
 			save_gamebook();
@@ -2054,7 +2256,7 @@ public:
 		{
 			LOG("AI wins match " << ascore << ":" << pscore << "\n");
 			_ai.matches_won++;
-			Util::stats("ai_matches_won", std::to_string(_ai.matches_won));
+			_stats.add(StatsStore::AI_MATCHES_WON);
 			bell(YOU_LOST);
 			show_lost_msg();
 			save_gamebook();
@@ -2067,54 +2269,22 @@ public:
 
 	void update_gamebook()
 	{
-		if (_game.closed != NOT && _game.closed != AUTO)
-		{
-			// game was closed, now the closer must have enough points
-			if (_game.closed == BY_PLAYER)
-			{
-				if (_player.score >= 66)
-				{
-					int score = _strictness >= 1 ? _ai.score_closed : _ai.score;
-					_game.book.emplace_back(score < 33 ? score == 0 ? 3 : 2 : 1, 0);
-				}
-				else
-				{
-					// TODO: officially the points are counted at the moment of closing
-					_game.book.emplace_back(0, _player.score < 33 ? _player.score == 0 ? 3 : 2 : 2);
-				}
-			}
-			else
-			{
-				// closed by AI
-				if (_ai.score >= 66)
-				{
-					int score = _strictness >= 1 ? _player.score_closed : _player.score;
-					_game.book.emplace_back(0, score < 33 ? score == 0 ? 3 : 2 : 1);
-				}
-				else
-				{
-					// TODO: officially the points are counted at the moment of closing
-					_game.book.emplace_back(_ai.score < 33 ? _ai.score == 0 ? 3 : 2 : 2, 0);
-				}
-			}
-		}
-		else
-		{
-			// normal game (not closed)
-			if (_game.move == PLAYER)
-			{
-				_game.book.emplace_back(_ai.score < 33 ? _ai.score == 0 ? 3 : 2 : 1, 0);
-			}
-			else
-			{
-				_game.book.emplace_back(0, _player.score < 33 ? _player.score == 0 ? 3 : 2 : 1);
-			}
-		}
+		auto [player_points, ai_points] = _engine.game_points(_strictness);
+		_game.book.emplace_back(player_points, ai_points);
+	}
+
+	void record_game()
+	{
+		GameRecord rec;
+		rec.from_log(_log, _engine.test_end(), _game.book.back());
+		GameRecordWriter(Util::rec_file(), GameIndex::build(_engine.params())).write(rec);
 	}
 
 	virtual void prepare_game() override
 	{
-		_history.clear();
+		if (_moves.size())
+			_last_game_moves = std::move(_moves);
+		_moves.clear();
 		_engine.init();
 		cursor(FL_CURSOR_DEFAULT);
 		_redeal ? _redeal_button->show() : _redeal_button->hide();
@@ -2123,18 +2293,19 @@ public:
 		update();
 	}
 
-	int run()
+	Flow::Task<> play()
 	{
 		Player playout(::first_to_move);
+		co_await replay_requested();
 		while (playing())
 		{
 			_redeal = true;
-			_history.clear();
 			prepare_game();
-			game(playout);
+			co_await game(playout);
 			if (_redeal) continue;
 			playout = playout == PLAYER ? AI : PLAYER;
 			update_gamebook();
+			record_game();
 
 			if (!playing()) break;
 
@@ -2146,13 +2317,49 @@ public:
 			update();
 			check_end_match();
 		}
+	}
+
+	int run()
+	{
+		std::string replay = Util::config("replay");
+		if (replay.size())
+		{
+			Util::config("replay", std::string()); // don't save replay request!
+			_replay_request = atoi(replay.c_str());
+		}
+		//
+		// The game flow is a coroutine, that is resumed by timers and
+		// input from the event loop. Fl::wait() blocks while nothing
+		// happens, so there is no polling between events.
+		// Animations and waits of the engine are awaited by the flow
+		// too (see _fiber). The flow is resumed only here, never from
+		// a nested event loop (dialogs) that may run meanwhile.
+		//
+		Flow::Task<> flow = play();
+		flow.start();
+		while (!flow.done() && Fl::first_window())
+		{
+			Fl::wait();
+			if (std::exchange(_resume_flow, false))
+				_flow.resume();
+		}
+		//
+		// The window was closed: playing() is false now, so the
+		// suspended flow unwinds through the normal end of game
+		// (the game in progress is recorded).
+		//
+		while (!flow.done() && _flow.waiting())
+			_flow.resume();
 		save_config();
 		save_stats();
+		if (flow.done())
+			flow.result();	// (rethrows exception of flow)
 		return 0;
 	}
 
 	void message(Message m_, bool bell_ = false) override
 	{
+		if (in_flow([=, this]() { message(m_, bell_); })) return;
 		if (m_ == CLOSED) m_ = _game.move == AI ? AI_CLOSED : YOU_CLOSED;
 		// NOTE: conflict with Fl_Widget::CHANGED!
 		if (m_ == Message::CHANGED) m_ = _game.move == AI ? AI_CHANGED : YOU_CHANGED;
@@ -2160,9 +2367,32 @@ public:
 		debug();
 	}
 
+	void message(Player player_, Message m_, bool bell_ = false) override
+	{
+		if (in_flow([=, this]() { message(player_, m_, bell_); })) return;
+		player_ == PLAYER ? player_message(m_, bell_) : ai_message(m_, bell_);
+	}
+
+	void busy(bool busy_) override
+	{
+		cursor(busy_ ? FL_CURSOR_WAIT : FL_CURSOR_DEFAULT);
+	}
+
+	void game_won(Player winner_) override
+	{
+		_stats.add(winner_ == PLAYER ? StatsStore::PLAYER_GAMES_WON : StatsStore::AI_GAMES_WON);
+	}
+
+	Flow::Task<> run(std::function<void()> fn_) override
+	{
+		// game logic, that calls the UI (animations, waits)
+		co_await _fiber.run(std::move(fn_));
+	}
+
 	void ai_message(Message m_, bool bell_ = false)
 	{
 		if (bell_) bell(m_);
+		bool sleeping = _ai.message == AI_SLEEP;	// sleepy face is larger than message area
 		_ai.message = m_;
 		std::string m(Util::message(m_));
 		DBG("ai_message(" << m << ")\n")
@@ -2172,7 +2402,7 @@ public:
 		{
 			_ai_anim_text = new AnimText(m, *this);
 		}
-		update();
+		sleeping ? redraw() : redraw_rect(message_area(AI));
 	}
 
 	void player_message(Message m_, bool bell_ = false)
@@ -2187,7 +2417,7 @@ public:
 		{
 			_player_anim_text = new AnimText(m, *this);
 		}
-		update();
+		redraw_rect(message_area(PLAYER));
 	}
 
 	void error_message(Message m_, bool bell_ = false)
@@ -2196,35 +2426,12 @@ public:
 		_error_message = m_;
 		std::string m(Util::message(m_));
 		DBG("error_message(" << m << ")\n")
-		update();
-	}
-
-	bool ai_wins(const std::string &log_, Message player_message_ = NO_MESSAGE)
-	{
-		LOG(log_ + "\n");
-		ai_message(AI_GAME, true);
-		player_message(player_message_);
-		_ai.games_won++;
-		Util::stats("ai_games_won", std::to_string(_ai.games_won));
-		_ai.display_score = true;
-		wait(2.0);
-		return true;
-	}
-
-	bool player_wins(const std::string &log_, Message ai_message_ = NO_MESSAGE)
-	{
-		LOG(log_ + "\n");
-		player_message(YOUR_GAME, true);
-		ai_message(ai_message_);
-		_player.games_won++;
-		Util::stats("player_games_won", std::to_string(_player.games_won));
-		_ai.display_score = true;
-		wait(2.0);
-		return true;
+		redraw_rect(Rect(0, h() - h() / 40, w(), h() / 40));
 	}
 
 	void bell([[maybe_unused]]Message m_ = NO_MESSAGE, [[maybe_unused]]bool visual_ = true) override
 	{
+		if (in_flow([=, this]() { bell(m_, visual_); })) return;
 #ifdef USE_MINIAUDIO
 		std::string snd = sound[m_];
 		if (snd.size())
@@ -2252,116 +2459,13 @@ public:
 			flicker();
 	}
 
-	Result test_end()
-	{
-		auto no_cards_in_play = [&]() -> bool
-		{
-			return _player.cards.empty() && _ai.cards.empty() && _player.move_state == NONE && _ai.move_state == NONE;
-		};
-
-		if (_game.closed == NOT || _game.closed == AUTO)
-		{
-			if (_game.move == PLAYER && _player.score >= 66)
-			{
-				return PLAYER_WINS_BY_SCORE;
-			}
-			else if (_game.move == AI && _ai.score >= 66)
-			{
-				return AI_WINS_BY_SCORE;
-			}
-			else if (no_cards_in_play())
-			{
-				if (_game.move == AI)
-				{
-					return AI_WINS_BY_LAST_TRICK;
-				}
-				else
-				{
-					// _game.move = PLAYER
-					return PLAYER_WINS_BY_LAST_TRICK;
-				}
-			}
-		}
-		else
-		{
-			// closed
-			if (_game.closed == BY_PLAYER && _game.move == PLAYER && _player.score >= 66)
-			{
-				return PLAYER_WINS_CLOSED_GAME;
-			}
-			else if (_game.closed == BY_AI && _game.move == AI && _ai.score >= 66)
-			{
-				return AI_WINS_CLOSED_GAME;
-			}
-			else if (no_cards_in_play())
-			{
-				// closed and last trick done
-				if (_game.closed == BY_PLAYER)
-				{
-					return AI_WINS_PLAYER_CLOSED_NOT_ENOUGH;
-				}
-				else
-				{
-					// _game.closed = BY_AI
-					return PLAYER_WINS_AI_CLOSED_NOT_ENOUGH;
-				}
-			}
-		}
-		return NO_WIN;
-	}
-
-	bool check_end()
-	{
-		debug();
-		Result res = test_end();
-		switch (res)
-		{
-			case PLAYER_WINS_BY_SCORE:             return player_wins("Player wins!");
-			case PLAYER_WINS_BY_LAST_TRICK:        return player_wins("Player wins by last trick!");
-			case PLAYER_WINS_CLOSED_GAME:          return player_wins("Player wins closed game!");
-			case PLAYER_WINS_AI_CLOSED_NOT_ENOUGH: return player_wins("Player wins because AI closed and has not enough!", AI_NOT_ENOUGH);
-
-			case AI_WINS_BY_SCORE:                 return ai_wins("AI wins!");
-			case AI_WINS_BY_LAST_TRICK:            return ai_wins("AI wins by last trick!");
-			case AI_WINS_CLOSED_GAME:              return ai_wins("AI wins closed game!");
-			case AI_WINS_PLAYER_CLOSED_NOT_ENOUGH: return ai_wins("AI wins because player closed and has not enough!", YOU_NOT_ENOUGH);
-			default: break;
-		}
-		return false;
-	}
-
-	void check_trick(Player move_)
-	{
-		_game.marriage = NO_MARRIAGE;
-		_game.move = _engine.check_trick(move_);
-
-		if (_game.move == PLAYER) // player won trick
-		{
-			_player.deck.push_front(_ai.card);
-			_player.deck.push_front(_player.card);
-			_player.score += _player.card.value() + _ai.card.value() + _player.pending;
-			_player.pending = 0;
-			player_message(YOUR_TRICK);
-			ai_message(NO_MESSAGE);
-		}
-		else
-		{
-			_ai.deck.push_back(_player.card);
-			_ai.deck.push_back(_ai.card);
-			_ai.score += _ai.card.value() + _player.card.value() + _ai.pending;
-			_ai.pending = 0;
-			ai_message(AI_TRICK);
-			player_message(NO_MESSAGE);
-		}
-	}
-
 	static void cb_sleep(void *d_)
 	{
 		if (Fl::first_window() == static_cast<Deck *>(d_))
 			(static_cast<Deck *>(d_))->ai_message(AI_SLEEP);
 	}
 
-	void player_move() override
+	Flow::Task<bool> player_move() override
 	{
 		auto estimated_ai_cards_value = [&]() -> int
 		{
@@ -2390,23 +2494,37 @@ public:
 		}
 		while (playing() && _player.move_state != ON_TABLE && _redeal == false && _winning_claim == false)
 		{
-			wait(0.);
+			co_await _flow.wait();	// (woken by wake_flow() on input)
+			if (_player_action)
+				co_await _fiber.run(std::exchange(_player_action, nullptr));
+			co_await replay_requested();
 		}
 		Fl::remove_timeout(cb_sleep, this);
 		_redeal_button->hide();
 		_restart = false;
+		co_return !_redeal;
+	}
+
+	void player_action(std::function<void()> action_)
+	{
+		// change/close of the player (done by the game flow)
+		_player_action = std::move(action_);
+		wake_flow();
 	}
 
 	void redeal()
 	{
 		LOG("***redeal***\n");
 		_redeal = true;
+		wake_flow();
 	}
 
 	void winning_claim()
 	{
 		_player.score = 66;
 		_winning_claim = true;
+		_log.add(GameLog::Type::CLAIM, PLAYER);
+		wake_flow();
 	}
 
 	bool playing() override
@@ -2414,107 +2532,27 @@ public:
 		return Fl::first_window() && _restart == false;
 	}
 
-	void ai_move() override
+	Flow::Task<> game(Player playout_)
 	{
-		cursor(FL_CURSOR_WAIT);
-		wait(2.0);
-		if (!playing()) return;
-		_engine.ai_move();
-	}
-
-	void game(Player playout_)
-	{
-		DBG(std::string(80, '~') << "\n");
-		DBG("new game: " << (playout_ == PLAYER ? "PLAYER" : "AI") << " to lead\n");
-		_game.move = playout_;
-		init();
+		error_message(NO_MESSAGE);
+		_redeal = false;
+		co_await _game_flow.deal(playout_);
 		if (game_to_load.size())
 		{
 			load_game(game_to_load);
 			game_to_load.erase();
 		}
-
-		while (playing() && (_player.cards.size() || _ai.cards.size()))
-		{
-			if (_game.move == PLAYER)
-			{
-				ai_message(NO_MESSAGE);
-				_player.move_state = NONE;
-				if (check_end()) break;
-				player_message(_ai.move_state == NONE ? YOU_LEAD : YOUR_TURN);
-				player_move();
-				ai_message(NO_MESSAGE);
-				if (_redeal) break;
-
-				if (check_end()) break; // if enough from 20/40!!
-
-				if (!playing()) break;
-				if (_ai.move_state == ON_TABLE)
-				{
-					wait(1.5);
-					check_trick(AI);
-
-					if (check_end()) break;
-
-					fillup_cards();
-					wait(1.5);
-				}
-				else
-				{
-					if (check_end()) break;
-					_game.move = AI;
-				}
-			}
-
-			if (_game.move == AI)
-			{
-				player_message(NO_MESSAGE);
-				if (check_end()) break;
-				_ai.move_state = MOVING;
-				ai_message(_player.move_state == NONE ? AI_LEADS : AI_TURN);
-				ai_move();
-
-				if (check_end()) break; // if enough from 20/40!!
-
-				if (_player.move_state == ON_TABLE)
-				{
-					wait(1.5);
-					check_trick(PLAYER);
-
-					if (check_end()) break;
-
-					fillup_cards();
-					wait(1.5);
-				}
-				else
-				{
-					if (check_end()) break;
-					_game.move = PLAYER;
-				}
-			}
-		}
-		if (!playing()) return;
-
-		_game.marriage = NO_MARRIAGE;
-		if (_redeal == true) return;
-
-		wait(2.0);
+		co_await _game_flow.play();
 	}
 
 	bool idle() const
 	{
-		return _player.move_state == NONE && _ai.move_state == NONE &&	_anim_params.func == nullptr;
+		return _player.move_state == NONE && _ai.move_state == NONE &&	_anims.empty();
 	}
 
-	void wait(double s_) override
+	double wait_time(double s_) const
 	{
-		if (!s_)
-		{
-			Fl::wait();
-			return;
-		}
-		std::string fast = Util::config("fast");
-		if ((fast.empty() || fast == "1") && s_ >= 1.0)
+		if (Config::as_bool(Config::FAST) && s_ >= 1.0)
 		{
 			s_ /= 2;
 		}
@@ -2522,19 +2560,57 @@ public:
 		{
 			DBG("wait(" << s_ << ")\n");
 		}
-		_disabled = true;
-		double min_wait = s_ > 1./50 ? 1./50 : s_;
-		std::chrono::time_point<std::chrono::system_clock> start =
-			std::chrono::system_clock::now();
-		while (playing() && _disabled)
+		return s_;
+	}
+
+	bool disabled() const
+	{
+		// within delay()
+		return _delaying;
+	}
+
+	void wait(double s_) override
+	{
+		// waits of the game logic (run by _fiber) are delays of the game flow
+		if (_fiber.inside())
+			_fiber.suspend([this, s_]() { return delay(s_); });
+	}
+
+	static void cb_resume_flow(void *d_)
+	{
+		// (the flow is resumed by the main loop in run())
+		static_cast<Deck *>(d_)->_resume_flow = true;
+	}
+
+	void wake_flow()
+	{
+		// let suspended game flow re-check its state (from main loop)
+		if (!_flow.waiting()) return;
+		Fl::remove_timeout(cb_resume_flow, this);
+		Fl::add_timeout(0., cb_resume_flow, this);
+	}
+
+	Flow::Task<> delay(double s_) override
+	{
+		//
+		// Suspend the game flow for s_ seconds (a click ends it early).
+		// No event loop is run here, the flow is resumed by a timer
+		// from the main loop.
+		//
+		typedef std::chrono::steady_clock Clock;
+		Clock::time_point end = Clock::now() +
+			std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(wait_time(s_)));
+		_delaying = true;
+		while (playing() && _delaying)
 		{
-			Fl::wait(min_wait);
-			std::chrono::time_point<std::chrono::system_clock> end =
-				std::chrono::system_clock::now();
-			std::chrono::duration<double> diff = end - start;
-			if (diff.count() >= s_) break;
+			double left = std::chrono::duration<double>(end - Clock::now()).count();
+			if (left <= 0) break;
+			Fl::remove_timeout(cb_resume_flow, this);
+			Fl::add_timeout(left, cb_resume_flow, this);
+			co_await _flow.wait();
 		}
-		_disabled = false;
+		Fl::remove_timeout(cb_resume_flow, this);
+		_delaying = false;
 	}
 
 	std::string make_stats() const
@@ -2547,32 +2623,91 @@ public:
 
 	void update_history()
 	{
-		GameState h(_player, _ai, _game);
-		_history.push_back(h);
+		_log.add(GameLog::Type::TURN, PLAYER);
 	}
 
-	bool back_history()
+	bool jump_history(std::optional<size_t> ply_)
 	{
-		if (_history.empty()) return false;
-		GameState h = _history.back();
-		if (_history.size() != 1)
-			_history.pop_back();
-		_player = h.player;
-		_ai = h.ai;
-		_game = h.game;
+		// restore position by replay from the deal
+		if (!ply_ || !_log.replay(ply_.value(), _game, _player, _ai)) return false;
+		_moves.resize(_log.plays(ply_.value()));
+		_engine.init(); // NOTE: cards excluded from play are forgotten
+		redraw();
 		return true;
 	}
 
+	bool back_history() { return jump_history(_log.undo_ply()); }
+	bool forward_history() { return jump_history(_log.redo_ply()); }
+
+	Flow::Task<> replay_requested()
+	{
+		// run a requested replay within the game flow (at the player's turn)
+		if (std::optional<size_t> number = std::exchange(_replay_request, std::nullopt))
+			co_await replay_game(number.value());
+	}
+
+	Flow::Task<bool> replay_game(size_t number_)
+	{
+		//
+		// Play back a journaled game (0 = last one) with the animations
+		// of the UI. Speed can be changed by '+'/'-', ESC stops replay.
+		// The current game is restored afterwards.
+		//
+		GameRecordReader reader(Util::rec_file());
+		GameRecord rec;
+		if (!reader.find(number_, rec))
+		{
+			bell();
+			co_return false;
+		}
+		LOG("replay game record #" << reader.count() << " (" << rec.events.size() << " events)\n");
+		GameData game(_game);
+		PlayerData player(_player);
+		PlayerData ai(_ai);
+		GameLog log;
+		rec.to_log(log);
+		log.replay(0, _game, _player, _ai);
+		_engine.init();
+		_replaying = true;
+		bool redeal_button = _redeal_button->visible();
+		bool winning_button = _winning_button->visible();
+		_redeal_button->hide();
+		_winning_button->hide();
+		redraw();
+		co_await delay(1.0 / _replay_speed);
+		bool stepped = true;
+		while (_replaying && Fl::first_window())
+		{
+			co_await _fiber.run([&]() { stepped = log.step(_game, _player, _ai, _engine, *this); });
+			if (!stepped) break;
+			GameLog::Type type = log.events()[log.ply() - 1].type;
+			redraw();
+			co_await delay((type == GameLog::Type::PLAY ? 1.0 : 0.5) / _replay_speed);
+		}
+		if (_replaying)
+			co_await delay(1.5 / _replay_speed);
+		_replaying = false;
+		_game = game;
+		_player = player;
+		_ai = ai;
+		_engine.init(); // NOTE: cards excluded from play are forgotten
+		if (redeal_button) _redeal_button->show();
+		if (winning_button) _winning_button->show();
+		redraw();
+		co_return true;
+	}
+
 private:
 	// Engine
 	PlayerData _player;
 	PlayerData _ai;
 	GameData _game;
 	Engine _engine;
+	StatsStore _stats;
 
 	// UI
 	Message _error_message;
-	bool _disabled;
+	bool _delaying;		// within delay() (reset to end it)
 	bool _redeal;
 	Card _card_template;
 	CardImage _back;
@@ -2588,17 +2723,37 @@ private:
 	Welcome *_welcome;
 	Selector *_selector;
 	bool _grayout;
+	Layer _table_layer;		// background (tiled image)
+	Layer _scene_layer;		// all but animated cards (during animation)
 #ifdef USE_MINIAUDIO
 	Audio _audio;
 #endif
 	std::string _cmd;
-	CardAnimParams _anim_params;
+	Animator _animator;
+	std::vector<CardAnimParams> _anims;	// running animations
+	uint64_t _anim_scene;		// != 0: scene does not change during animations
+	Flow::Resumer _flow;		// suspended game flow
+	Flow::Fiber _fiber;		// game logic run by the flow (engine)
+	std::function<void()> _player_action;	// change/close to be done by the flow
 	int _strictness;
 	int _animation_level;
 	bool _show_ai_cards;
 	bool _restart;
-	std::vector<GameState> _history;
+	bool _replaying;
+	bool _resume_flow;	// resume game flow by main loop
+	std::optional<size_t> _replay_request;	// replay to run by game flow
+	double _replay_speed;	// replay speed factor (keys '+'/'-')
+	GameLog _log;
+	std::vector<ReviewMove> _moves;
+	std::vector<ReviewMove> _last_game_moves;
+	GameFlow _game_flow;
 	double _card_scale;
 	AnimText *_player_anim_text;
 	AnimText *_ai_anim_text;
+	mutable uint64_t _logged_cards;	// fingerprints of last logged state (debug())
+	mutable uint64_t _logged_hands;
+	Rect _mouse_rect;		// area of items following mouse when drawn last
+	std::vector<Rect> _anim_rects;	// area of animated cards when drawn last
+	uint64_t _damage_pixels;	// area given by redraw_rect() since last draw
+	DamageStats _damage_stats;
 };
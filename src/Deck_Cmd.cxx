@@ -12,160 +12,46 @@
 #include "Alert.h"
 #include "messages.h"
 #include "GameBook.h"
+#include "GameFile.h"
 #include <FL/Fl.H>
 #include <FL/fl_ask.H>
 #include <string>
 #include <cstdlib>
 
-// helper
-static Suites suites_from_string(std::string s_)
-{
-	size_t pos;
-	Suites suites;
-	if (s_.size() && s_[0] == '|')
-		s_.erase(0, 1);
-	while ((pos = s_.find('|')) != std::string::npos)
-	{
-		std::string suite_sym = s_.substr(0, pos);
-		s_.erase(0, pos + 1);
-		for (auto &[suite, sym] : ::suite_symbols)
-		{
-			if (sym == suite_sym)
-			{
-				suites.push_back(suite);
-				break;
-			}
-		}
-	}
-	return suites;
-}
-
 bool Deck::load_game(const std::string &name_)
 {
-	std::string line;
-	std::string value;
-	auto parse = [&](const std::string &id_) -> bool
-	{
-		if (line.starts_with(id_ + ":"))
-		{
-			value = line.substr(id_.size() + 1);
-			value.erase(std::remove_if(value.begin(), value.end(), ::isspace), value.end());
-			return true;
-		}
-		return false;
-	};
-	std::string name(name_);
-	if (name.empty() || std::filesystem::exists(name) == false)
-	{
-		WNG("Not existing game file '" << name << "'!");
-		bell();
-		return false;
-	}
-	std::ifstream ifs(name.c_str(), std::ios::binary);
-	if (!ifs.is_open() || ifs.bad())
-	{
-		WNG("Bad game file '" << name << "'!");
-		bell();
-		return false;
-	}
-	// TODO: better way to clear cards/state
-	// NOTE: can't use {} initialization, because games_won, matches_won in PlayerData!
+	// keep copies, so a bad file leaves the current game untouched
+	GameData game(_game);
+	PlayerData player(_player);
+	PlayerData ai(_ai);
 	init2();
-	_player.cards.clear();
-	_player.deck.clear();
-	_ai.cards.clear();
-	_ai.deck.clear();
-	_game.cards.clear();
-	_game.trump = NO_SUITE;
-	bool bad_file(false);
-	while (std::getline(ifs, line))
+	if (GameFile::load(name_, _game, _player, _ai) == false)
 	{
-		std::string orig_line = line;
-		line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());
-		if (line.empty()) continue; // all whitespace
-		else if (line[0] == '#' || line[0] == '/') // comment
-		{
-			IMP(orig_line);
-			continue;
-		}
-		else if (parse("player_cards")) _player.cards = value;
-		else if (parse("player_20_40")) _player.s20_40 = suites_from_string(value);
-		else if (parse("player_card"))
-		{
-			_player.card = Cards("|" + value + "|")[0];
-			_player.move_state = ON_TABLE;
-		}
-		else if (parse("player_deck")) _player.deck = value;
-		else if (parse("player_score")) _player.score = atoi(value.c_str());
-		else if (parse("player_pending")) _player.pending = atoi(value.c_str());
-		else if (parse("ai_cards")) _ai.cards = value;
-		else if (parse("ai_20_40")) _ai.s20_40 = suites_from_string(value);
-		else if (parse("ai_card"))
-		{
-			_ai.card = Cards("|" + value + "|")[0];
-			_ai.move_state = ON_TABLE;
-		}
-		else if (parse("ai_deck")) _ai.deck = value;
-		else if (parse("ai_score")) _ai.score = atoi(value.c_str());
-		else if (parse("ai_pending")) _ai.pending = atoi(value.c_str());
-		else if (parse("cards")) _game.cards = value;
-		else if (parse("closed")) _game.closed = static_cast<Closed>(atoi(value.c_str()));
-		else if (parse("ai_score_closed")) _ai.score_closed = atoi(value.c_str());
-		else if (parse("player_score_closed")) _player.score_closed = atoi(value.c_str());
-		else if (parse("trump")) _game.trump = Cards("|A" + value + "|")[0].suite();
-		else if (parse("move")) _game.move = static_cast<Player>(atoi(value.c_str()));
-		else { bad_file = true; break; }
-	}
-#if 0
-	if (_game.cards.empty()) // cards needs not be specfied, it is then computed from the other cards
-	{
-		_game.cards = Cards::fullcards() - _player.cards - _ai.cards - _player.deck - _ai.deck - _ai.card - _player.card;
-	}
-#endif
-	if (_game.trump == NO_SUITE && _game.cards.size())
-	{
-		// if cards are specified, trump can be determined from back card
-		_game.trump = _game.cards.back().suite();
-	}
-	// Check cards for completeness
-	Cards c = _player.cards + _player.deck + _ai.cards + _ai.deck + _game.cards;
-	if (_player.move_state == ON_TABLE)
-		c += _player.card;
-	if (_ai.move_state == ON_TABLE)
-		c += _ai.card;
-	if (bad_file ||
-	    c.size() != 20 || c.check() == false ||
-		 (_game.trump == NO_SUITE) ||
-		 (_game.move != PLAYER && _game.move != AI) ||
-		 (_game.closed != NOT && _game.closed != BY_PLAYER && _game.closed != BY_AI && _game.closed != AUTO) ||
-	    (_player.move_state == ON_TABLE && _game.move == PLAYER) ||
-	    (_ai.move_state == ON_TABLE && _game.move == AI))
-	{
-		WNG("Corrupt game file '" << name << "'!");
+		_game = game;
+		_player = player;
+		_ai = ai;
 		bell();
-		// TODO: better way to reset cards
-		_game.cards = Cards::fullcards();
-		_player.move_state = NONE;
-		_ai.move_state = NONE;
-		_player.cards.clear();
-		_player.deck.clear();
-		_ai.cards.clear();
-		_ai.deck.clear();
-		init();
 		return false;
 	}
-	else
-	{
-		LOG("Loaded game file '" << name << "' - next to move: " << (_game.move == PLAYER ? "Player": "AI") << "\n");
-		_redeal = false;
-		prepare_game();
-	}
+	LOG("Loaded game file '" << name_ << "' - next to move: " << (_game.move == PLAYER ? "Player": "AI") << "\n");
+	_redeal = false;
+	prepare_game();
+	_log.start(_game, _player, _ai);
 	return true;
 }
 
 void Deck::onCmd(const std::string &cmd_)
 {
 	DBG("Your command: '" << cmd_ << "'\n")
+	if (_replaying && !cmd_.starts_with("replay-speed=") &&
+	    (cmd_.starts_with("replay") || cmd_.starts_with("gb=") || cmd_ == "back" || cmd_ == "forward" ||
+	     cmd_.starts_with("ply") || cmd_.starts_with("save") || cmd_.starts_with("load") ||
+	     cmd_.starts_with("review")))
+	{
+		// replayed game must not be changed
+		bell();
+		return;
+	}
 	if (cmd_.starts_with("animate="))
 	{
 		int value = atoi(cmd_.substr(8).c_str());
@@ -185,7 +71,7 @@ void Deck::onCmd(const std::string &cmd_)
 		int value = atoi(cmd_.substr(9).c_str());
 		if (value >= 0 && value <= 2)
 			Util::config("loglevel", std::to_string(value));
-		OUT("loglevel: " << Util::config_as_int("loglevel") << "\n");
+		OUT("loglevel: " << Config::as_int(Config::LOGLEVEL) << "\n");
 	}
 	else if (cmd_.starts_with("error="))
 	{
@@ -248,56 +134,101 @@ void Deck::onCmd(const std::string &cmd_)
 	}
 	else if (cmd_ == "help")
 	{
-		OUT("animate|back|debug|error|load|save|loglevel|message|ai_message|player_message|gb|cip|quit\n");
+		OUT("animate|back|forward|ply|replay|set|cache|damage|frames|wakeups|debug|error|load|save|loglevel|message|ai_message|player_message|gb|cip|review|quit\n");
+	}
+	else if (cmd_.starts_with("replay-speed="))
+	{
+		double value = atof(cmd_.substr(13).c_str());
+		if (value >= 1./8 && value <= 64)
+			_replay_speed = value;
+		OUT("replay-speed: " << _replay_speed << "\n");
+	}
+	else if (cmd_.starts_with("replay"))
+	{
+		// replay journaled game (number or last one), run by game flow
+		std::string arg = cmd_.substr(6);
+		_replay_request = atoi(arg.c_str());
+	}
+	else if (cmd_ == "cache")
+	{
+		const CardImage::Stats &s = CardImage::stats();
+		OUT("image cache: " << s.entries << " images, " << s.bytes / 1024 << " KB (budget " <<
+		    Config::as_int(Config::IMAGE_CACHE) << " MB), hits: " << s.hits << " misses: " << s.misses <<
+		    " evictions: " << s.evictions << " prerendered: " << s.prerendered <<
+		    " placeholders: " << s.placeholders << "\n");
+		const Util::TextCacheStats &t = Util::text_cache_stats();
+		OUT("text layouts: " << t.entries << ", hits: " << t.hits << " misses: " << t.misses << "\n");
+		const Util::SymbolStats &a = Util::symbol_stats();
+		OUT("symbol atlases: " << a.sizes << ", " << a.bytes / 1024 << " KB, rasterized: " << a.rasterized << "\n");
+	}
+	else if (cmd_ == "damage")
+	{
+		// redraw statistics since last 'damage' command
+		DamageStats &s = _damage_stats;
+		if (s.frames)
+			OUT("redraw: " << s.frames << " frames (" << s.full_frames << " full), " <<
+			    s.pixels / s.frames << " pixels per frame (" <<
+			    (s.window_pixels ? 100 * s.pixels / s.window_pixels : 0) << "% of window)\n");
+		s = {};
+	}
+	else if (cmd_ == "frames")
+	{
+		// animation frame statistics since last 'frames' command
+		const Animator::Stats &s = _animator.stats();
+		OUT("animation: " << s.frames << " frames, " << s.skipped << " skipped, frame time avg " <<
+		    (s.frames ? 1000 * s.frame_time / s.frames : 0.) << " ms, max " << 1000 * s.max_frame_time << " ms\n");
+		_animator.reset_stats();
+	}
+	else if (cmd_ == "wakeups")
+	{
+		// event loop wakeups since last 'wakeups' command
+		const Idle::Stats &s = Idle::stats();
+		OUT("wakeups: " << s.wakeups << ", " << s.rate << "/s (max " << s.max_rate << "/s), " <<
+		    s.suspended << " timers suspended" << (Idle::idle() ? " (idle)" : "") << "\n");
+		Idle::reset_stats();
+	}
+	else if (cmd_.starts_with("set "))
+	{
+		// set config value (registered values take effect immediately)
+		std::string arg = cmd_.substr(4);
+		size_t pos = arg.find('=');
+		if (pos != std::string::npos)
+			Util::config(arg.substr(0, pos), arg.substr(pos + 1));
+		else
+			OUT(arg << "=" << Util::config(arg) << "\n");
 	}
 	else if (cmd_ == "back")
 	{
-		LOG("history size: " << _history.size() << "\n");
+		LOG("history ply: " << _log.ply() << "/" << _log.size() << "\n");
 		if (back_history()) bell();
 		return;
 	}
+	else if (cmd_ == "forward")
+	{
+		LOG("history ply: " << _log.ply() << "/" << _log.size() << "\n");
+		if (forward_history()) bell();
+		return;
+	}
+	else if (cmd_.starts_with("ply"))
+	{
+		// jump to the player's turn at or before given ply
+		std::string arg = cmd_.substr(3);
+		if (arg.empty())
+		{
+			OUT("ply " << _log.ply() << "/" << _log.size() << "\n");
+			return;
+		}
+		if (jump_history(_log.turn_ply(atoi(arg.c_str())))) bell();
+		return;
+	}
 	else if (cmd_.starts_with("save"))
 	{
 		std::string arg = cmd_.substr(4);
 		if (arg.size() && (arg[0] == ' ' || arg[0] == '='))
 			arg.erase(0, 1);
 		std::string name(arg.size() ? arg.c_str() : "game.scg");
-		std::ofstream ofs(name.c_str(), std::ios::binary);
-		ofs << "player_cards:" << _player.cards << "\n";
-		if (_player.move_state == ON_TABLE)
-			ofs << "player_card:" << _player.card << "\n";
-		if (_player.s20_40.size())
-		{
-			ofs << "player_20_40:|";
-			for (auto &s : _player.s20_40)
-				ofs << Card::suite_symbol(s) << "|";
-			ofs << "\n";
-		}
-		if (_player.move_state == ON_TABLE)
-			ofs << "player_card:" << _player.card << "\n";
-		ofs << "player_deck:" << _player.deck << "\n";
-		ofs << "player_score:" << _player.score << "\n";
-		ofs << "player_pending:" << _player.pending << "\n";
-		ofs << "ai_cards:" << _ai.cards << "\n";
-
-		if (_ai.s20_40.size())
-		{
-			ofs << "ai_20_40:|";
-			for (auto &s : _ai.s20_40)
-				ofs << Card::suite_symbol(s) << "|";
-			ofs << "\n";
-		}
-		if (_ai.move_state == ON_TABLE)
-			ofs << "ai_card:" << _ai.card << "\n";
-		ofs << "ai_deck:" << _ai.deck << "\n";
-		ofs << "ai_score:" << _ai.score << "\n";
-		ofs << "ai_pending:" << _ai.pending << "\n";
-		ofs << "cards:" << _game.cards << "\n";
-		ofs << "closed:" << (int)_game.closed << "\n";
-		ofs << "ai_score_closed:" << _ai.score_closed << "\n";
-		ofs << "player_score_closed:" << _player.score_closed << "\n";
-		ofs << "trump:" << Card::suite_symbol(_game.trump) << "\n";
-		LOG("Saved to game file: '" << name << "\n");
+		if (GameFile::save(name, _game, _player, _ai))
+			LOG("Saved to game file: '" << name << "'\n");
 	}
 	else if (cmd_.starts_with("load"))
 	{
@@ -310,6 +241,27 @@ void Deck::onCmd(const std::string &cmd_)
 				_restart = true;
 		}
 	}
+	else if (cmd_.starts_with("review"))
+	{
+		// review current (or last finished) game or a position from game file
+		std::string arg = cmd_.substr(6);
+		if (arg.size() && (arg[0] == ' ' || arg[0] == '='))
+			arg.erase(0, 1);
+		std::vector<ReviewMove> moves;
+		if (arg.size())
+		{
+			if (!load_game(arg)) return;
+			if (_game.move == AI)
+				_restart = true;
+			moves.push_back({ Solver::position(_game, _player, _ai), -1 });
+		}
+		else
+		{
+			moves = _moves.size() ? _moves : _last_game_moves;
+		}
+		Review review(_strictness);
+		OUT(review.report(moves, review.run(moves)));
+	}
 	else if (cmd_ == "quit")
 	{
 		toggle_cmd_input();
@@ -7,8 +7,9 @@
 //
 
 #include "Engine.h"
-#include "Unittest.h"
+#include "Trace.h"
 
+#include <chrono>
 #include <ranges>
 
 using enum Player;
@@ -17,11 +18,19 @@ using enum Message;
 using enum Closed;
 using enum Marriage;
 
-bool Engine::unit_tests()
+// counts calls and nesting of the decision routines
+class DecisionScope
 {
-	Unittest ut(_game, _player, _ai, *this);
-	return ut.run();
-}
+public:
+	explicit DecisionScope(Decision &decision_) : _decision(decision_)
+	{
+		_decision.calls++;
+		_decision.depth = std::max(_decision.depth, ++_decision.level);
+	}
+	~DecisionScope() { _decision.level--; }
+private:
+	Decision &_decision;
+};
 
 void Engine::init()
 {
@@ -48,12 +57,12 @@ Move Engine::best_trick_card(const Card &c_, Cards &tricks_) const
 			break;
 		}
 	}
-	if (!move && _game.closed == NOT && _ai.score < 33)
+	if (!move && _game.closed == NOT && _ai.score < _params.safe_score)
 	{
 		// try to find a trick that pushes score beyond 32
 		for (auto &c : tricks_)
 		{
-			if (c.value() + c_.value() + _ai.score + _ai.pending >= 33)
+			if (c.value() + c_.value() + _ai.score + _ai.pending >= _params.safe_score)
 			{
 				move = find(c, tricks_);
 				break;
@@ -81,7 +90,7 @@ Move Engine::best_trick_card_or_no_move(const Card &c_, Cards &tricks_) const
 		// that was the default move
 		Card c = tricks_[move.value()];
 		// Do not trick with trump a low card
-		if (c.suite() == _game.trump && c_.value() <= 4)
+		if (c.suite() == _game.trump && c_.value() <= _params.low_card)
 		{
 			// with some exceptions:
 			int score = _player.score + _player.pending + c.value() + c_.value();
@@ -94,7 +103,7 @@ Move Engine::best_trick_card_or_no_move(const Card &c_, Cards &tricks_) const
 		// check if jack could be changed for ace, so don't use it to trick,
 		// when queen or king are available
 		Card m = tricks_[move.value()];
-		if (m == Card(JACK, _game.trump) && c_.value() > 4 &&
+		if (m == Card(JACK, _game.trump) && c_.value() > _params.low_card &&
 		    _game.cards.size() >= 4 && _game.closed == NOT && _game.cards.back().value() == 11)
 		{
 			if (tricks_.find(Card(QUEEN, _game.trump)))
@@ -333,10 +342,10 @@ Move Engine::ai_play_20_40()
 		// optimization: if having 40 and player still may have trumps
 		// try first to pull a trump with A or 10
 		Cards highest = highest_cards_in_hand();
-		if (max_trumps_player() && _ai.score + 44 < 66)
+		if (max_trumps_player() && _ai.score + _params.pull_before_40 < 66)
 		{
 			Cards highest_trumps = trumps_in_hand(highest);
-			if (highest_trumps.size() && highest_trumps[0].value() >= 10)
+			if (highest_trumps.size() && highest_trumps[0].value() >= _params.pull_trump)
 			{
 				IMP("***try pull trump before playing 40!\n");
 				move = find(highest_trumps[0], _ai.cards);
@@ -473,7 +482,7 @@ bool Engine::ai_test_close()
 			// test if cards are good enough
 			Cards highest = highest_cards_in_hand();
 			maybe_score += highest.value();
-			maybe_score += highest.size() * 3; // at average expect win of a queen per trick
+			maybe_score += highest.size() * _params.close_trick_gain; // at average expect win of a queen per trick
 			int trumps = (int)trumps_in_hand(_ai.cards).size();
 			int remain_trumps = max_trumps_player();
 			DBG("ai_test_close: trumps: " << trumps << ", remain_trumps: " << remain_trumps << "\n");
@@ -497,7 +506,11 @@ Cards Engine::assumed_player_cards() const
 	if (_game.cards.size())
 		player_cards -= _game.cards.back(); // open trump is certainly not in player cards
 	IMP("exclude_cards: " << _exclude_cards);
-	player_cards -= _exclude_cards;
+	Cards assumed = player_cards - _exclude_cards;
+	if (assumed.size() >= _player.cards.size())
+		player_cards = assumed;
+	else
+		IMP("exclude_cards contradict player cards - ignored");
 	if (_player.move_state == ON_TABLE)
 		player_cards -= _player.card;
 	player_cards.sort();
@@ -826,6 +839,7 @@ Move Engine::ai_play_for_last_trick_lead()
 	//
 
 	assert( _player.cards.size() == 2 && _ai.cards.size() == 2);
+	DecisionScope scope(_decision);
 	Cards player = assumed_player_cards();
 	Cards ai_cards = _ai.cards;
 
@@ -870,6 +884,7 @@ Move Engine::ai_play_for_closed_lead()
 	// Test if it is of advantage to have the lead after
 	// the pack is cleared.
 
+	DecisionScope scope(_decision);
 	if (_player.move_state == ON_TABLE)
 	{
 		// following last trick before pack clear
@@ -951,14 +966,14 @@ Move Engine::ai_play_for_closed_lead()
 		int player_gain = 0;
 		Cards player_claim = cards_to_claim(player_cards, _ai.cards, ANY_SUITE, &player_gain);
 		DBG("player_gain: " << player_gain << "\n");
-		if (check_40(player_cards) || player_gain + _player.pending + _player.score >= 55)
+		if (check_40(player_cards) || player_gain + _player.pending + _player.score >= _params.closed_lead_danger)
 		{
 			IMP("player might win or have 40 if he wins this trick!");
 			Cards highest = highest_cards_in_hand(_ai.cards);
 			if (highest.size())
 			{
 				// so player must either trick with trump or let AI trick
-				highest.sort_by_value(_ai.score < 33); // low->hi, if already "safe"
+				highest.sort_by_value(_ai.score < _params.safe_score); // low->hi, if already "safe"
 				DBG("highest sorted by value: " << highest << "\n");
 				IMP("Use " << highest[0] << " to make player trick or getting 40");
 				return find(highest[0], _ai.cards);
@@ -1034,14 +1049,16 @@ Move Engine::winning_move_follow() const
 void Engine::ai_move_closed_lead()
 {
 	// end game, ai plays out
+	DecisionScope scope(_decision);
 	Move move;
+	const char *branch = "";
 	Cards player_cards = assumed_player_cards();
 
 	Move m = winning_move();
 	if (m)
 	{
 		// this move wins the game..
-		_move = m;
+		choose(m, "closed_lead: winning move");
 		return;
 	}
 	int gain = 0; // gain from claim
@@ -1062,19 +1079,19 @@ void Engine::ai_move_closed_lead()
 			{
 				m = ai_play_20_40();
 				if (m)
-					_move = m;
+					choose(m, "closed_lead: sure win, 40 first");
 			}
 			else
 			{
 				m = ai_play_20_40(claim[0]);
-				_move = m ? m : find(claim[0], _ai.cards);
+				choose(m ? m : find(claim[0], _ai.cards), "closed_lead: sure win, claim");
 			}
 		}
 		else
 		{
 			m = ai_play_20_40();
 			if (m)
-				_move = m;
+				choose(m, "closed_lead: sure win, 20/40");
 		}
 		return;
 	}
@@ -1087,6 +1104,7 @@ void Engine::ai_move_closed_lead()
 		{
 			DBG("ai_play_for_last_trick suggested: " << _ai.cards[m.value()] << "\n");
 			move = m;
+			branch = "closed_lead: play for last trick";
 		}
 	}
 
@@ -1094,19 +1112,21 @@ void Engine::ai_move_closed_lead()
 	if (m)
 	{
 		move = m;
+		branch = "closed_lead: 20/40";
 	}
 	else
 	{
 		Cards highest_trumps = highest_trumps_in_hand();
 		if (highest_trumps.size() > (size_t)max_trumps_player())
 		{
-			_move = find(highest_trumps[0], _ai.cards);
+			choose(find(highest_trumps[0], _ai.cards), "closed_lead: highest trump");
 			return;
 		}
 		Cards hinder = hinder_20_40();
 		if (hinder.size())
 		{
 			move = find(hinder[0], _ai.cards);
+			branch = "closed_lead: hinder 20/40";
 			assert(move);
 			IMP("hinder 20/40 with " << _ai.cards[move.value()] << " from " << hinder);
 		}
@@ -1127,20 +1147,22 @@ void Engine::ai_move_closed_lead()
 			{
 				Cards winning = highest_trumps_in_hand() + highest_non_trump;
 				move = find(winning[0], _ai.cards);
+				branch = "closed_lead: highest cards win";
 			}
 			else if (pull.size() && (int)pull.size() + (int)trump_claim.size() >= max_trumps_player())
 			{
 				Cards player_claim = cards_to_claim(player_cards, _ai.cards) - trumps_in_hand(player_cards);
-				if (pull[0].value() >= 10 && player_claim.empty())
+				if (pull[0].value() >= _params.pull_value && player_claim.empty())
 				{
 					pull += give_trump_cards(_ai.cards, player_cards);
 					pull.sort_by_value(false);
 				}
-				Cards pull_then_claim = pull[0].value() < 10 ? pull + trump_claim : trump_claim + pull;
+				Cards pull_then_claim = pull[0].value() < _params.pull_value ? pull + trump_claim : trump_claim + pull;
 				if (pull_then_claim.size())
 				{
 					DBG("pull_then_claim: " << pull_then_claim << "\n");
 					move = find(pull_then_claim[0], _ai.cards);
+					branch = "closed_lead: pull then claim";
 				}
 			}
 			else if (claim.size())
@@ -1149,6 +1171,7 @@ void Engine::ai_move_closed_lead()
 					claim.sort(_game.trump); // trumps first
 				DBG("claim: " << claim << "\n");
 				move = find(claim[0], _ai.cards);
+				branch = "closed_lead: claim";
 			}
 		}
 	}
@@ -1168,6 +1191,7 @@ void Engine::ai_move_closed_lead()
 					m = c;
 			}
 			move = find(m, _ai.cards);
+			branch = "closed_lead: pull trumps";
 		}
 	}
 
@@ -1175,33 +1199,38 @@ void Engine::ai_move_closed_lead()
 	{
 		Cards no_trick = closed_lead_no_trick(_ai.cards, player_cards);
 		if (no_trick.size())
+		{
 			move = find(no_trick[0], _ai.cards);
+			branch = "closed_lead: no trick";
+		}
 	}
 
 	if (move)
-		_move = move;
+		choose(move, branch);
 }
 
 void Engine::ai_move_closed_follow()
 {
 	// end game, player has moved, ai to follow
+	DecisionScope scope(_decision);
 	Move m = winning_move_follow();
 	if (m)
-		_move = m;
+		choose(m, "closed_follow: winning move");
 	else
-		_move = must_give_color_or_trick(_player.card, _ai.cards);
+		choose(must_give_color_or_trick(_player.card, _ai.cards), "closed_follow: color or trick");
 	assert(_move);
 }
 
 void Engine::ai_move_lead()
 {
 	// normal game, ai plays out
+	DecisionScope scope(_decision);
 	if (test_change(_ai))
 	{
 		test_change(_ai, true); // make change
 		if (_move)	// if we had a default move, it needs to be redone
 		{
-			_move = default_move();
+			choose(default_move(), "lead: lowest card after change");
 			assert(_move);
 			DBG("new default move: " << _ai.cards[_move.value()] << "\n");
 		}
@@ -1212,13 +1241,13 @@ void Engine::ai_move_lead()
 		// special case, before pack clearing
 		Move m = ai_play_for_closed_lead();
 		if (m)
-			_move = m;
+			choose(m, "lead: play for closed lead");
 	}
 
 	Move m = ai_play_20_40();
 	if (m)
 	{
-		_move = m;
+		choose(m, "lead: 20/40");
 		ai_test_close();
 		return;
 	}
@@ -1235,9 +1264,9 @@ void Engine::ai_move_lead()
 		Cards highest = highest_cards_in_hand();
 		highest -= trumps_in_hand();
 		highest.sort_by_value(false); // low->hi
-		if (highest.size() && highest[0].value() <= 3) // only cards up to king
+		if (highest.size() && highest[0].value() <= _params.lead_low) // only cards up to king
 		{
-			_move = find(highest[0], _ai.cards);
+			choose(find(highest[0], _ai.cards), "lead: low card of safe suite");
 			IMP("play card of suite player has no higher of: " << highest[0] << "\n");
 		}
 	}
@@ -1246,10 +1275,11 @@ void Engine::ai_move_lead()
 void Engine::ai_move_follow()
 {
 	// normal game, player has moved, ai to follow
+	DecisionScope scope(_decision);
 	Move m = winning_move_follow();
 	if (m)
 	{
-		_move = m;
+		choose(m, "follow: winning move");
 		return;
 	}
 
@@ -1260,7 +1290,7 @@ void Engine::ai_move_follow()
 		if (m)
 		{
 			IMP("ai_play_for_closed_lead suggested " << _ai.cards[m.value()]);
-			_move = m;
+			choose(m, "follow: play for closed lead");
 			return;
 		}
 	}
@@ -1283,21 +1313,22 @@ void Engine::ai_move_follow()
 		}
 		Move move = best_trick_card_or_no_move(_player.card, temp);
 		if (move)
-			_move = find(temp[move.value()], _ai.cards);
+			choose(find(temp[move.value()], _ai.cards), "follow: trick");
 		else
 		{
 			// another exception: do rather trick, than give away a high card
 			assert(_move);
-			if (_ai.cards[_move.value()].value() >= 10)
+			if (_ai.cards[_move.value()].value() >= _params.high_card)
 			{
 				Move move = find(tricks[best_trick_card(_player.card, tricks).value()], _ai.cards);
 				// Some pro/cons to tear a 20/40 rather than giving away a high cards...
 				int ai_score = _ai.score + _ai.pending + _ai.cards[move.value()].value() + _player.card.value();
 				int player_score = _player.score + _player.pending + _ai.cards[_move.value()].value() + _player.card.value();
-				if (player_score >= 46 || ai_score >= 46 || (s40.empty() && _ai.score < 33 && ai_score >= 33))
+				if (player_score >= _params.tear_marriage || ai_score >= _params.tear_marriage ||
+				    (s40.empty() && _ai.score < _params.safe_score && ai_score >= _params.safe_score))
 				{
 					IMP("Nevertheless trick, rather than giving away " << _ai.cards[_move.value()]);
-					_move = move;
+					choose(move, "follow: trick rather than give away");
 				}
 			}
 		}
@@ -1391,17 +1422,137 @@ Player Engine::check_trick(Player move_)
 	return _game.move;
 }
 
+void Engine::score_trick()
+{
+	// winner of trick (_game.move) takes the cards and scores
+	if (_game.move == PLAYER)
+	{
+		_player.deck.push_front(_ai.card);
+		_player.deck.push_front(_player.card);
+		_player.score += _player.card.value() + _ai.card.value() + _player.pending;
+		_player.pending = 0;
+	}
+	else
+	{
+		_ai.deck.push_back(_player.card);
+		_ai.deck.push_back(_ai.card);
+		_ai.score += _ai.card.value() + _player.card.value() + _ai.pending;
+		_ai.pending = 0;
+	}
+}
+
+Result Engine::test_end() const
+{
+	auto no_cards_in_play = [&]() -> bool
+	{
+		return _player.cards.empty() && _ai.cards.empty() && _player.move_state == NONE && _ai.move_state == NONE;
+	};
+
+	if (_game.closed == NOT || _game.closed == AUTO)
+	{
+		if (_game.move == PLAYER && _player.score >= 66)
+		{
+			return Result::PLAYER_WINS_BY_SCORE;
+		}
+		else if (_game.move == AI && _ai.score >= 66)
+		{
+			return Result::AI_WINS_BY_SCORE;
+		}
+		else if (no_cards_in_play())
+		{
+			if (_game.move == AI)
+			{
+				return Result::AI_WINS_BY_LAST_TRICK;
+			}
+			else
+			{
+				// _game.move = PLAYER
+				return Result::PLAYER_WINS_BY_LAST_TRICK;
+			}
+		}
+	}
+	else
+	{
+		// closed
+		if (_game.closed == BY_PLAYER && _game.move == PLAYER && _player.score >= 66)
+		{
+			return Result::PLAYER_WINS_CLOSED_GAME;
+		}
+		else if (_game.closed == BY_AI && _game.move == AI && _ai.score >= 66)
+		{
+			return Result::AI_WINS_CLOSED_GAME;
+		}
+		else if (no_cards_in_play())
+		{
+			// closed and last trick done
+			if (_game.closed == BY_PLAYER)
+			{
+				return Result::AI_WINS_PLAYER_CLOSED_NOT_ENOUGH;
+			}
+			else
+			{
+				// _game.closed = BY_AI
+				return Result::PLAYER_WINS_AI_CLOSED_NOT_ENOUGH;
+			}
+		}
+	}
+	return Result::NO_WIN;
+}
+
+std::pair<int, int> Engine::game_points(int strictness_) const
+{
+	// game points (player, ai) for the finished game
+	if (_game.closed != NOT && _game.closed != AUTO)
+	{
+		// game was closed, now the closer must have enough points
+		if (_game.closed == BY_PLAYER)
+		{
+			if (_player.score >= 66)
+			{
+				int score = strictness_ >= 1 ? _ai.score_closed : _ai.score;
+				return { score < 33 ? score == 0 ? 3 : 2 : 1, 0 };
+			}
+			// TODO: officially the points are counted at the moment of closing
+			return { 0, _player.score < 33 ? _player.score == 0 ? 3 : 2 : 2 };
+		}
+		// closed by AI
+		if (_ai.score >= 66)
+		{
+			int score = strictness_ >= 1 ? _player.score_closed : _player.score;
+			return { 0, score < 33 ? score == 0 ? 3 : 2 : 1 };
+		}
+		// TODO: officially the points are counted at the moment of closing
+		return { _ai.score < 33 ? _ai.score == 0 ? 3 : 2 : 2, 0 };
+	}
+	// normal game (not closed)
+	if (_game.move == PLAYER)
+	{
+		return { _ai.score < 33 ? _ai.score == 0 ? 3 : 2 : 1, 0 };
+	}
+	return { 0, _player.score < 33 ? _player.score == 0 ? 3 : 2 : 1 };
+}
+
 Move Engine::default_move(const Cards &cards_) const
 {
 	return lowest_card(cards_); // default move is the lowest card
 }
 
+void Engine::choose(const Move &move_, const char *branch_)
+{
+	_move = move_;
+	_decision.branch = branch_;
+}
+
 Move Engine::ai_move()
 {
+	TRACE("Engine::ai_move");
+	auto start = std::chrono::steady_clock::now();
+	size_t cards = Cards::constructed();
+	_decision = Decision();
 	_game.marriage = NO_MARRIAGE;
 	assert(_ai.cards.size());
 
-	_move = default_move();
+	choose(default_move(), "default: lowest card");
 	assert(_move);
 	DBG("default move: " << _ai.cards[_move.value()] << "\n");
 
@@ -1425,6 +1576,11 @@ Move Engine::ai_move()
 		}
 	}
 	assert(_move);
+	std::chrono::duration<double, std::micro> diff = std::chrono::steady_clock::now() - start;
+	_decision.us = diff.count();
+	_decision.cards = Cards::constructed() - cards;
+	DBG("decision: " << _decision.branch << " (" << (int)_decision.us << "us, " << _decision.cards
+	    << " Cards, " << _decision.calls << " calls, depth " << _decision.depth << ")\n");
 	_ai.card = _ai.cards[_move.value()];
 
 	_ai.cards.erase(_ai.cards.begin() + _move.value());
@@ -0,0 +1,72 @@
+//
+// Part of "Schnapsen for 2" card game.
+//
+// (c) 2026 Christian Grabner
+//
+// Tunable parameter profile of the AI engine.
+//
+
+#include "EngineParams.h"
+#include <cstdlib>
+#include <sstream>
+
+EngineParams::EngineParams() :
+	safe_score(33),
+	low_card(4),
+	pull_before_40(44),
+	pull_trump(10),
+	close_trick_gain(3),
+	closed_lead_danger(55),
+	high_card(10),
+	tear_marriage(46),
+	lead_low(3),
+	pull_value(10)
+{
+}
+
+/*static*/
+const std::vector<EngineParams::Param>& EngineParams::list()
+{
+	static const std::vector<Param> params = {
+		{ "safe-score",         &EngineParams::safe_score,          20, 45 },
+		{ "low-card",           &EngineParams::low_card,             2, 11 },
+		{ "pull-before-40",     &EngineParams::pull_before_40,      26, 66 },
+		{ "pull-trump",         &EngineParams::pull_trump,           2, 11 },
+		{ "close-trick-gain",   &EngineParams::close_trick_gain,     0, 11 },
+		{ "closed-lead-danger", &EngineParams::closed_lead_danger,  40, 66 },
+		{ "high-card",          &EngineParams::high_card,            3, 11 },
+		{ "tear-marriage",      &EngineParams::tear_marriage,       30, 66 },
+		{ "lead-low",           &EngineParams::lead_low,             2, 11 },
+		{ "pull-value",         &EngineParams::pull_value,           2, 11 }
+	};
+	return params;
+}
+
+void EngineParams::load(const string_map &values_)
+{
+	// NOTE: uses find() - may be called with the global config from any thread
+	for (auto &p : list())
+	{
+		auto it = values_.find(std::string("engine-") + p.name);
+		if (it == values_.end() || it->second.empty()) continue;
+		int value = atoi(it->second.c_str());
+		if (value >= p.min && value <= p.max)
+			this->*p.value = value;
+	}
+}
+
+void EngineParams::save(string_map &values_) const
+{
+	for (auto &p : list())
+		values_[std::string("engine-") + p.name] = std::to_string(this->*p.value);
+}
+
+std::string EngineParams::to_string() const
+{
+	std::ostringstream os;
+	for (auto &p : list())
+		os << p.name << "=" << this->*p.value << " ";
+	std::string res = os.str();
+	if (res.size()) res.pop_back();
+	return res;
+}
@@ -0,0 +1,85 @@
+//
+// Part of "Schnapsen for 2" card game.
+//
+// (c) 2026 Christian Grabner
+//
+// Decision statistics of the AI engine.
+//
+
+#include "EngineStats.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+/*static*/
+size_t EngineStats::bucket(double value_)
+{
+	// 0: < 1, 1: < 2, 2: < 4, ...
+	size_t b = 0;
+	while (value_ >= 1 && b < 15)
+	{
+		value_ /= 2;
+		b++;
+	}
+	return b;
+}
+
+void EngineStats::add(const Decision &d_)
+{
+	_decisions++;
+	_us += d_.us;
+	_cards += d_.cards;
+	_calls += d_.calls;
+	_max_depth = std::max(_max_depth, d_.depth);
+	_branches[d_.branch]++;
+	_time[bucket(d_.us)]++;
+	_alloc[bucket((double)d_.cards)]++;
+}
+
+void EngineStats::merge(const EngineStats &s_)
+{
+	_decisions += s_._decisions;
+	_us += s_._us;
+	_cards += s_._cards;
+	_calls += s_._calls;
+	_max_depth = std::max(_max_depth, s_._max_depth);
+	for (auto &[branch, count] : s_._branches)
+		_branches[branch] += count;
+	for (size_t i = 0; i < _time.size(); i++)
+	{
+		_time[i] += s_._time[i];
+		_alloc[i] += s_._alloc[i];
+	}
+}
+
+std::string EngineStats::to_string() const
+{
+	std::ostringstream os;
+	os << "decisions: " << _decisions << "\n";
+	if (!_decisions) return os.str();
+	os << std::fixed << std::setprecision(1);
+	os << "avg time: " << _us / _decisions << "us\n";
+	os << "avg Cards constructed: " << (double)_cards / _decisions << "\n";
+	os << "avg routine calls: " << (double)_calls / _decisions << ", max depth: " << _max_depth << "\n";
+
+	os << "branches:\n";
+	std::vector<std::pair<std::string, size_t>> branches(_branches.begin(), _branches.end());
+	std::sort(branches.begin(), branches.end(), [](auto &a_, auto &b_) { return a_.second > b_.second; });
+	for (auto &[branch, count] : branches)
+		os << "  " << count * 100. / _decisions << "%\t" << count << "\t" << branch << "\n";
+
+	auto histogram = [&](const char *title_, const std::array<size_t, 16> &h_)
+	{
+		os << title_ << ":\n";
+		for (size_t i = 0; i < h_.size(); i++)
+		{
+			if (!h_[i]) continue;
+			os << "  < " << (1 << i) << "\t" << h_[i] << "\t"
+			   << std::string(std::max<size_t>(1, h_[i] * 40 / _decisions), '#') << "\n";
+		}
+	};
+	histogram("time (us)", _time);
+	histogram("Cards constructed", _alloc);
+	return os.str();
+}
@@ -30,6 +30,7 @@ Fl_Font FontLoader::_index = FL_FREE_FONT;
 /*static*/
 Fl_Font FontLoader::load(const char* filePath_, const char* fontName_, Fl_Font defaultFont_/* = FL_HELVETICA*/)
 {
+	TRACE_DETAIL("FontLoader::load", filePath_);
 	bool success = false;
 	if (std::filesystem::exists(filePath_))
 	{
@@ -53,6 +54,7 @@ Fl_Font FontLoader::load(const char* filePath_, const char* fontName_, Fl_Font d
 /*static*/
 Fl_Font FontLoader::load(const unsigned char* data_, unsigned int len_, const char* fontName_, Fl_Font defaultFont_/* = FL_HELVETICA*/)
 {
+	TRACE_DETAIL("FontLoader::load", fontName_);
 	bool success = false;
 	LOG("Load embedded font '" << fontName_ << "'\n");
 #ifdef _WIN32
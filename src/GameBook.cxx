@@ -68,21 +68,10 @@ std::vector<std::pair<int, int>> GameBook::to_value(const std::string &str_)
 	return v;
 }
 
-GameBook& GameBook::history(const std::string &history_)
+GameBook& GameBook::history(const std::deque<std::vector<std::pair<int, int>>> &gamebooks_)
 {
-	size_t pos;
-	std::string h(history_);
-	_history.clear();
-	while ((pos = h.find(';')) != std::string::npos)
-	{
-		std::string hs = h.substr(0, pos);
-		h.erase(0, pos + 1);
-//		LOG("history: '" << hs << "'" << "\n");
-		_history.push_front(to_value(hs));
-	}
-//	LOG("history: '" << h << "'" << "\n");
-	if (h.size())
-		_history.push_front(to_value(h));
+	// gamebooks_ are oldest first, history is newest first
+	_history.assign(gamebooks_.rbegin(), gamebooks_.rend());
 	LOG("GameBook history size: " << _history.size() << "\n");
 	return *this;
 }
@@ -139,11 +128,11 @@ void GameBook::draw(Rect r_)
 	fl_font(FL_COURIER, H / 14);
 	X += W / 20;
 	Y += fl_descent() + fl_height();
-	Util::draw_color_text(Util::message(GAMEBOOK), X, Y);
+	Util::draw_string(Util::message(GAMEBOOK), X, Y);
 	fl_line_style(FL_SOLID, 2);
 	fl_line(X, Y + fl_descent(), X + W - W / 10, Y + fl_descent());
 	Y += H / 10;
-	Util::draw_color_text(Util::message(GB_HEADLINE), X, Y);
+	Util::draw_string(Util::message(GB_HEADLINE), X, Y);
 
 	// draw separation lines
 	int h = H - H / 5;
@@ -0,0 +1,211 @@
+//
+// Part of "Schnapsen for 2" card game.
+//
+// (c) 2026 Christian Grabner
+//
+// Load position files (.scg).
+//
+
+#include "GameFile.h"
+#include "debug.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+using enum Player;
+using enum CardState;
+using enum Closed;
+using enum Marriage;
+using enum CardSuite;
+
+// helper
+static Suites suites_from_string(std::string s_)
+{
+	size_t pos;
+	Suites suites;
+	if (s_.size() && s_[0] == '|')
+		s_.erase(0, 1);
+	while ((pos = s_.find('|')) != std::string::npos)
+	{
+		std::string suite_sym = s_.substr(0, pos);
+		s_.erase(0, pos + 1);
+		for (auto &[suite, sym] : ::suite_symbols)
+		{
+			if (sym == suite_sym)
+			{
+				suites.push_back(suite);
+				break;
+			}
+		}
+	}
+	return suites;
+}
+
+/*static*/
+bool GameFile::load(const std::string &name_, GameData &game_, PlayerData &player_, PlayerData &ai_,
+                    Annotation *annotation_/* = nullptr*/)
+{
+	TRACE_DETAIL("GameFile::load", name_);
+	//
+	// Load position into game_, player_ and ai_ (only the position
+	// related members are changed). Returns false for a missing or
+	// corrupt file.
+	//
+	std::string line;
+	std::string value;
+	auto parse = [&](const std::string &id_) -> bool
+	{
+		if (line.starts_with(id_ + ":"))
+		{
+			value = line.substr(id_.size() + 1);
+			value.erase(std::remove_if(value.begin(), value.end(), ::isspace), value.end());
+			return true;
+		}
+		return false;
+	};
+	auto cards = [&]() -> Cards
+	{
+		// accept "A♠" or "|A♠|K♠|"
+		return Cards(value.size() && value[0] == '|' ? value : "|" + value + "|");
+	};
+	std::string name(name_);
+	if (name.empty() || std::filesystem::exists(name) == false)
+	{
+		WNG("Not existing game file '" << name << "'!");
+		return false;
+	}
+	std::ifstream ifs(name.c_str(), std::ios::binary);
+	if (!ifs.is_open() || ifs.bad())
+	{
+		WNG("Bad game file '" << name << "'!");
+		return false;
+	}
+	// NOTE: can't use {} initialization, because games_won, matches_won in PlayerData!
+	for (PlayerData *p : { &player_, &ai_ })
+	{
+		p->cards.clear();
+		p->deck.clear();
+		p->s20_40.clear();
+		p->score = 0;
+		p->score_closed = 0;
+		p->pending = 0;
+		p->move_state = NONE;
+	}
+	game_.cards.clear();
+	game_.trump = NO_SUITE;
+	game_.closed = NOT;
+	game_.marriage = NO_MARRIAGE;
+	bool bad_file(false);
+	while (std::getline(ifs, line))
+	{
+		std::string orig_line = line;
+		line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());
+		if (line.empty()) continue; // all whitespace
+		else if (line[0] == '#' || line[0] == '/') // comment
+		{
+			IMP(orig_line);
+			continue;
+		}
+		else if (parse("player_cards")) player_.cards = value;
+		else if (parse("player_20_40")) player_.s20_40 = suites_from_string(value);
+		else if (parse("player_card"))
+		{
+			player_.card = Cards("|" + value + "|")[0];
+			player_.move_state = ON_TABLE;
+		}
+		else if (parse("player_deck")) player_.deck = value;
+		else if (parse("player_score")) player_.score = atoi(value.c_str());
+		else if (parse("player_pending")) player_.pending = atoi(value.c_str());
+		else if (parse("ai_cards")) ai_.cards = value;
+		else if (parse("ai_20_40")) ai_.s20_40 = suites_from_string(value);
+		else if (parse("ai_card"))
+		{
+			ai_.card = Cards("|" + value + "|")[0];
+			ai_.move_state = ON_TABLE;
+		}
+		else if (parse("ai_deck")) ai_.deck = value;
+		else if (parse("ai_score")) ai_.score = atoi(value.c_str());
+		else if (parse("ai_pending")) ai_.pending = atoi(value.c_str());
+		else if (parse("cards")) game_.cards = value;
+		else if (parse("closed")) game_.closed = static_cast<Closed>(atoi(value.c_str()));
+		else if (parse("ai_score_closed")) ai_.score_closed = atoi(value.c_str());
+		else if (parse("player_score_closed")) player_.score_closed = atoi(value.c_str());
+		else if (parse("trump")) game_.trump = Cards("|A" + value + "|")[0].suite();
+		else if (parse("move")) game_.move = static_cast<Player>(atoi(value.c_str()));
+		else if (parse("best_move")) { if (annotation_) annotation_->best = cards(); }
+		else if (parse("avoid_move")) { if (annotation_) annotation_->avoid = cards(); }
+		else { bad_file = true; break; }
+	}
+	if (game_.trump == NO_SUITE && game_.cards.size())
+	{
+		// if cards are specified, trump can be determined from back card
+		game_.trump = game_.cards.back().suite();
+	}
+	// Check cards for completeness
+	Cards c = player_.cards + player_.deck + ai_.cards + ai_.deck + game_.cards;
+	if (player_.move_state == ON_TABLE)
+		c += player_.card;
+	if (ai_.move_state == ON_TABLE)
+		c += ai_.card;
+	if (bad_file ||
+	    c.size() != 20 || c.check() == false ||
+		 (game_.trump == NO_SUITE) ||
+		 (game_.move != PLAYER && game_.move != AI) ||
+		 (game_.closed != NOT && game_.closed != BY_PLAYER && game_.closed != BY_AI && game_.closed != AUTO) ||
+	    (player_.move_state == ON_TABLE && game_.move == PLAYER) ||
+	    (ai_.move_state == ON_TABLE && game_.move == AI))
+	{
+		WNG("Corrupt game file '" << name << "'!");
+		return false;
+	}
+	return true;
+}
+
+/*static*/
+bool GameFile::save(const std::string &name_, const GameData &game_, const PlayerData &player_,
+                    const PlayerData &ai_)
+{
+	TRACE_DETAIL("GameFile::save", name_);
+	std::ofstream ofs(name_.c_str(), std::ios::binary);
+	if (!ofs.is_open())
+	{
+		WNG("Can't write game file '" << name_ << "'!");
+		return false;
+	}
+	auto suites = [&](const Suites &s20_40_)
+	{
+		ofs << "|";
+		for (auto &s : s20_40_)
+			ofs << Card::suite_symbol(s) << "|";
+		ofs << "\n";
+	};
+	ofs << "player_cards:" << player_.cards << "\n";
+	if (player_.s20_40.size())
+	{
+		ofs << "player_20_40:";
+		suites(player_.s20_40);
+	}
+	if (player_.move_state == ON_TABLE)
+		ofs << "player_card:" << player_.card << "\n";
+	ofs << "player_deck:" << player_.deck << "\n";
+	ofs << "player_score:" << player_.score << "\n";
+	ofs << "player_pending:" << player_.pending << "\n";
+	ofs << "ai_cards:" << ai_.cards << "\n";
+	if (ai_.s20_40.size())
+	{
+		ofs << "ai_20_40:";
+		suites(ai_.s20_40);
+	}
+	if (ai_.move_state == ON_TABLE)
+		ofs << "ai_card:" << ai_.card << "\n";
+	ofs << "ai_deck:" << ai_.deck << "\n";
+	ofs << "ai_score:" << ai_.score << "\n";
+	ofs << "ai_pending:" << ai_.pending << "\n";
+	ofs << "cards:" << game_.cards << "\n";
+	ofs << "closed:" << (int)game_.closed << "\n";
+	ofs << "ai_score_closed:" << ai_.score_closed << "\n";
+	ofs << "player_score_closed:" << player_.score_closed << "\n";
+	ofs << "trump:" << Card::suite_symbol(game_.trump) << "\n";
+	ofs << "move:" << (int)game_.move << "\n";
+	return ofs.good();
+}
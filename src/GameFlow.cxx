@@ -0,0 +1,359 @@
+//
+// Part of "Schnapsen for 2" card game.
+//
+// (c) 2026 Christian Grabner
+//
+// Flow of a game, independent of the UI.
+//
+
+#include "GameFlow.h"
+#include "debug.h"
+#include <cassert>
+#include <functional>
+
+using enum Player;
+using enum CardState;
+using enum Closed;
+using enum Marriage;
+using enum Result;
+
+GameFlow::GameFlow(GameData &game_, PlayerData &player_, PlayerData &ai_, Engine &engine_,
+                   GameLog &log_, std::vector<ReviewMove> &moves_, UI &ui_) :
+	_game(game_),
+	_player(player_),
+	_ai(ai_),
+	_engine(engine_),
+	_log(log_),
+	_moves(moves_),
+	_ui(ui_)
+{
+}
+
+void GameFlow::reset()
+{
+	_game.closed = NOT;
+	_game.marriage = NO_MARRIAGE;
+	_game.trump = NO_SUITE;
+	_player.s20_40.clear();
+	_ai.s20_40.clear();
+	_player.score = 0;
+	_player.score_closed = 0;
+	_player.pending = 0;
+	_ai.score = 0;
+	_ai.score_closed = 0;
+	_ai.pending = 0;
+	_ai.display_score = false;
+	_player.message = NO_MESSAGE;
+	_ai.message = NO_MESSAGE;
+	_player.move_state = NONE;
+	_ai.move_state = NONE;
+	_player.deck_info = false;
+	_ai.deck_info = false;
+}
+
+void GameFlow::collect()
+{
+	LOG("collect\n");
+	for (auto &c : _player.cards)
+		_game.cards.push_front(c);
+	for (auto &c : _player.deck)
+		_game.cards.push_front(c);
+	for (auto &c :_ai.cards)
+		_game.cards.push_front(c);
+	for (auto &c :_ai.deck)
+		_game.cards.push_front(c);
+	_player.cards.clear();
+	_ai.cards.clear();
+	_player.deck.clear();
+	_ai.deck.clear();
+	if (_player.move_state != NONE)
+		_game.cards.push_front(_player.card);
+	if (_ai.move_state != NONE)
+		_game.cards.push_front(_ai.card);
+	if (_game.cards.size() != 20)
+		DBG("#cards: " << _game.cards.size())
+	assert(_game.cards.size() == 20);
+	assert(_game.cards.check());
+}
+
+void GameFlow::give_cards(size_t cards_)
+{
+	// cards_ to the player to move, then cards_ to the other (animated together)
+	_ui.animate_deal_both(_game.move, cards_, 0.1);
+	for (size_t i = 0; i < cards_; i++)
+	{
+		Card c = _game.cards.front();
+		_game.cards.pop_front();
+		_game.move == PLAYER ? _player.cards.push_front(c) : _ai.cards.push_front(c);
+	}
+	for (size_t i = 0; i < cards_; i++)
+	{
+		Card c = _game.cards.front();
+		_game.cards.pop_front();
+		_game.move == PLAYER ? _ai.cards.push_front(c) : _player.cards.push_front(c);
+	}
+}
+
+void GameFlow::deal_cards()
+{
+	_ui.bell(SHUFFLE);
+	_ui.animate_shuffle();
+	_ui.update();
+
+	LOG("dealer is " << (_game.move == PLAYER ? "AI" : "PLAYER") << "\n");
+	give_cards(3);
+
+	// trump card
+	Card trump = _game.cards.front();
+	_game.cards.pop_front();
+	_game.cards.push_back(trump); // will be the last card (_game.cards.back())
+	_game.trump = trump.suite();
+	LOG("trump: " << Card::suite_symbol(_game.trump) << "\n");
+	_ui.update();
+
+	give_cards(2);
+}
+
+Flow::Task<> GameFlow::deal(Player playout_)
+{
+	DBG(std::string(80, '~') << "\n");
+	DBG("new game: " << (playout_ == PLAYER ? "PLAYER" : "AI") << " to lead\n");
+	_game.move = playout_;
+	collect();
+	reset();
+	_ui.message(PLAYER, NO_MESSAGE);
+	_ui.message(AI, NO_MESSAGE);
+	_game.cards.shuffle();
+	assert(_game.cards.size() == 20);
+	co_await _ui.run(std::bind_front(&GameFlow::deal_cards, this));
+	assert(_player.cards.size() == 5);
+	assert(_ai.cards.size() == 5);
+
+	if (Schnapsen::debug)
+	{
+		// TEST TEST
+		Suites res;
+		res = _engine.have_40(_player.cards);
+		if (res.size())
+			DBG("player cards contain 40!\n")
+		res = _engine.have_20(_player.cards);
+		if (res.size())
+			DBG("player cards contain " << res.size() << "x20!\n")
+		res = _engine.have_40(_ai.cards);
+		if (res.size())
+			DBG("AI cards contain 40!\n")
+		res = _engine.have_20(_ai.cards);
+		if (res.size())
+			DBG("AI cards contain " << res.size() << "x20!\n")
+		Move i = _engine.find(Card(JACK, _game.cards.back().suite()), _player.cards);
+		if (i)
+			DBG("player cards can change Jack!\n")
+		i = _engine.find(Card(JACK, _game.cards.back().suite()), _ai.cards);
+		if (i)
+			DBG("AI cards can change Jack!\n")
+	}
+	_engine.sort_cards(_player.cards)
+	       .sort_cards(_ai.cards);
+	_ui.update();
+}
+
+void GameFlow::fillup_cards()
+{
+	if (_game.closed == NOT && _player.cards.size() < 5 && _ai.cards.size() < 5)
+	{
+		_log.add(GameLog::Type::DRAW, _game.move);
+		// give cards from pack (both cards animated together)
+		Card first, second;
+		if (_game.cards.size())
+		{
+			first = _game.cards.front();
+			_game.cards.pop_front();
+			_game.move == AI ? _ai.last_drawn = first : _player.last_drawn = first;
+		}
+		if (_game.cards.size())
+		{
+			second = _game.cards.front();
+			_game.move == PLAYER ? _ai.last_drawn = second : _player.last_drawn = second;
+			_game.cards.pop_front();
+		}
+		if (second.face() != NO_FACE)
+			_ui.animate_deal_both(_game.move);
+		else if (first.face() != NO_FACE)
+			_ui.animate_deal(_game.move);
+
+		if (first.face() != NO_FACE)
+		{
+			if (_game.move == AI)
+				_ai.cards.push_front(first);
+			else
+				_player.cards.push_front(first);
+		}
+		if (second.face() != NO_FACE)
+		{
+			if (_game.move == AI)
+				_player.cards.push_front(second);
+			else
+				_ai.cards.push_front(second);
+		}
+		assert(_player.cards.size() == _ai.cards.size());
+		_engine.sort_cards(_player.cards)
+		       .sort_cards(_ai.cards);
+
+		if (_game.cards.empty())
+		{
+			_game.closed = AUTO; // same rules as closing now
+			LOG("*** pack cleared - end game ***\n");
+		}
+	}
+	_ui.update();
+}
+
+void GameFlow::check_trick(Player move_)
+{
+	_log.add(GameLog::Type::TRICK, move_);
+	_game.marriage = NO_MARRIAGE;
+	_game.move = _engine.check_trick(move_);
+	_engine.score_trick();
+
+	if (_game.move == PLAYER) // player won trick
+	{
+		_ui.message(PLAYER, YOUR_TRICK);
+		_ui.message(AI, NO_MESSAGE);
+	}
+	else
+	{
+		_ui.message(AI, AI_TRICK);
+		_ui.message(PLAYER, NO_MESSAGE);
+	}
+}
+
+void GameFlow::ai_move()
+{
+	Card trump_card = _game.cards.size() ? _game.cards.back() : Card();
+	Closed closed = _game.closed;
+	_engine.ai_move();
+	_log.add_move(AI, trump_card, closed, _game, _ai);
+}
+
+void GameFlow::record_move()
+{
+	// remember position before the move and card played for review
+	const Card &card = _game.move == PLAYER ? _player.card : _ai.card;
+	_moves.push_back({ Solver::position(_game, _player, _ai), Solver::index(card) });
+	if (_game.move == PLAYER)
+		_log.add(GameLog::Type::PLAY, PLAYER, GameLog::index(card));
+}
+
+Flow::Task<bool> GameFlow::check_end()
+{
+	Player winner = PLAYER;
+	Message loser_message = NO_MESSAGE;
+	switch (_engine.test_end())
+	{
+		case PLAYER_WINS_BY_SCORE:             LOG("Player wins!\n"); break;
+		case PLAYER_WINS_BY_LAST_TRICK:        LOG("Player wins by last trick!\n"); break;
+		case PLAYER_WINS_CLOSED_GAME:          LOG("Player wins closed game!\n"); break;
+		case PLAYER_WINS_AI_CLOSED_NOT_ENOUGH: LOG("Player wins because AI closed and has not enough!\n");
+		                                       loser_message = AI_NOT_ENOUGH; break;
+
+		case AI_WINS_BY_SCORE:                 LOG("AI wins!\n"); winner = AI; break;
+		case AI_WINS_BY_LAST_TRICK:            LOG("AI wins by last trick!\n"); winner = AI; break;
+		case AI_WINS_CLOSED_GAME:              LOG("AI wins closed game!\n"); winner = AI; break;
+		case AI_WINS_PLAYER_CLOSED_NOT_ENOUGH: LOG("AI wins because player closed and has not enough!\n");
+		                                       winner = AI; loser_message = YOU_NOT_ENOUGH; break;
+		default: co_return false;
+	}
+	_ui.message(winner, winner == PLAYER ? YOUR_GAME : AI_GAME, true);
+	_ui.message(winner == PLAYER ? AI : PLAYER, loser_message);
+	(winner == PLAYER ? _player : _ai).games_won++;
+	_ai.display_score = true;
+	_ui.game_won(winner);
+	co_await _ui.delay(2.0);
+	co_return true;
+}
+
+Flow::Task<bool> GameFlow::play()
+{
+	//
+	// Play the dealt game until it ends. Returns false, if it was
+	// abandoned (redeal or UI closed).
+	//
+	_log.start(_game, _player, _ai);
+
+	while (_ui.playing() && (_player.cards.size() || _ai.cards.size()))
+	{
+		if (_game.move == PLAYER)
+		{
+			_ui.message(AI, NO_MESSAGE);
+			_player.move_state = NONE;
+			if (co_await check_end()) break;
+			_ui.message(PLAYER, _ai.move_state == NONE ? YOU_LEAD : YOUR_TURN);
+			bool moved = co_await _ui.player_move();
+			if (_player.move_state == ON_TABLE) record_move();
+			_ui.message(AI, NO_MESSAGE);
+			if (!moved) co_return false;
+
+			if (co_await check_end()) break; // if enough from 20/40!!
+
+			if (!_ui.playing()) break;
+			if (_ai.move_state == ON_TABLE)
+			{
+				co_await _ui.delay(1.5);
+				co_await _ui.run(std::bind_front(&GameFlow::check_trick, this, AI));
+
+				if (co_await check_end()) break;
+
+				co_await _ui.run(std::bind_front(&GameFlow::fillup_cards, this));
+				co_await _ui.delay(1.5);
+			}
+			else
+			{
+				if (co_await check_end()) break;
+				_game.move = AI;
+			}
+		}
+
+		if (_game.move == AI)
+		{
+			_ui.message(PLAYER, NO_MESSAGE);
+			if (co_await check_end()) break;
+			_ai.move_state = MOVING;
+			_ui.message(AI, _player.move_state == NONE ? AI_LEADS : AI_TURN);
+			_ui.busy(true);
+			co_await _ui.delay(2.0);
+			if (!_ui.playing()) break;
+			co_await _ui.run(std::bind_front(&GameFlow::ai_move, this));
+			_ui.busy(false);
+			if (_ai.move_state == ON_TABLE) record_move();
+
+			if (co_await check_end()) break; // if enough from 20/40!!
+
+			if (_player.move_state == ON_TABLE)
+			{
+				co_await _ui.delay(1.5);
+				co_await _ui.run(std::bind_front(&GameFlow::check_trick, this, PLAYER));
+
+				if (co_await check_end()) break;
+
+				co_await _ui.run(std::bind_front(&GameFlow::fillup_cards, this));
+				co_await _ui.delay(1.5);
+			}
+			else
+			{
+				if (co_await check_end()) break;
+				_game.move = PLAYER;
+			}
+		}
+	}
+	if (!_ui.playing()) co_return false;
+
+	_game.marriage = NO_MARRIAGE;
+	co_await _ui.delay(2.0);
+	co_return true;
+}
+
+Flow::Task<bool> GameFlow::game(Player playout_)
+{
+	co_await deal(playout_);
+	co_return co_await play();
+}
@@ -0,0 +1,270 @@
+//
+// Part of "Schnapsen for 2" card game.
+//
+// (c) 2026 Christian Grabner
+//
+// Secondary index of the game records.
+//
+
+#include "GameIndex.h"
+#include "debug.h"
+#include <bit>
+#include <filesystem>
+
+using enum Player;
+using enum Closed;
+
+/*static*/
+GameIndex::Entry GameIndex::entry(const GameRecord &rec_, uint64_t offset_, uint32_t build_)
+{
+	//
+	// Keys are taken from the events, no replay needed.
+	//
+	Entry e{};
+	e.offset = offset_;
+	e.build = build_;
+	e.result = rec_.result;
+	e.closed = rec_.game.closed;
+	e.trump = rec_.game.trump;
+	for (auto s : rec_.player.s20_40)
+		e.s20_40 |= 1u << (int)s;
+	for (auto s : rec_.ai.s20_40)
+		e.s20_40 |= 1u << ((int)s + 4);
+	size_t drawn = 0;
+	for (auto &ev : rec_.events)
+	{
+		if (ev.type == GameLog::Type::CLOSE)
+			e.closed = Player(ev.side) == PLAYER ? BY_PLAYER : BY_AI;
+		else if (ev.type == GameLog::Type::DRAW)
+			drawn += 2;
+		else if (ev.type == GameLog::Type::MARRIAGE)
+			e.s20_40 |= 1u << (ev.value + 4 * ev.side);
+	}
+	if (e.closed == NOT && rec_.game.cards.size() && drawn >= rec_.game.cards.size())
+		e.closed = AUTO;	// pack exhausted
+	e.points[0] = (uint8_t)rec_.points[0];
+	e.points[1] = (uint8_t)rec_.points[1];
+	return e;
+}
+
+/*static*/
+uint32_t GameIndex::build(const EngineParams &params_)
+{
+	// FNV-1a hash of the engine profile
+	uint32_t h = 2166136261u;
+	for (char c : params_.to_string())
+		h = (h ^ (uint8_t)c) * 16777619u;
+	return h;
+}
+
+/*static*/
+bool GameIndex::append(const std::string &name_, const Entry &entry_)
+{
+	std::error_code ec;
+	bool empty = !std::filesystem::exists(name_, ec) || std::filesystem::file_size(name_, ec) == 0;
+	std::ofstream ofs(name_, std::ios::binary | std::ios::app);
+	if (!ofs.is_open())
+	{
+		WNG("Can't write game index file '" << name_ << "'!");
+		return false;
+	}
+	std::string buf;
+	if (empty)
+	{
+		buf.append(MAGIC, 4);
+		buf.push_back((char)VERSION);
+	}
+	auto put = [&](uint64_t value_, int bytes_)
+	{
+		for (int i = 0; i < bytes_; i++)
+			buf.push_back((char)(uint8_t)(value_ >> (8 * i)));
+	};
+	put(entry_.offset, 6);
+	put(entry_.build, 4);
+	put((unsigned)entry_.result, 1);
+	put((unsigned)entry_.closed, 1);
+	put((unsigned)entry_.trump, 1);
+	put(entry_.s20_40, 1);
+	put(entry_.points[0], 1);
+	put(entry_.points[1], 1);
+	ofs.write(buf.data(), buf.size());
+	return ofs.good();
+}
+
+/*static*/
+size_t GameIndex::rebuild(const std::string &rec_file_, uint32_t build_/* = 0*/)
+{
+	//
+	// Write a new index for all records of the record file (the
+	// build of the records is not known and set to build_).
+	//
+	std::string name = file(rec_file_);
+	std::error_code ec;
+	std::filesystem::remove(name, ec);
+	GameRecordReader reader(rec_file_);
+	GameRecord rec;
+	while (reader.next(rec))
+	{
+		if (!append(name, entry(rec, reader.offset(), build_))) break;
+	}
+	return reader.count();
+}
+
+/*static*/
+std::optional<int> GameIndex::key(const std::string &spec_)
+{
+	//
+	// Key from "name=value":
+	//   result=0..8, closed=not|pl|ai|auto, trump=c|d|h|s,
+	//   winner=pl|ai, 20=pl|ai, 40=pl|ai, points=pl|ai:1..3
+	//
+	size_t pos = spec_.find('=');
+	if (pos == std::string::npos) return {};
+	std::string name = spec_.substr(0, pos);
+	std::string value = spec_.substr(pos + 1);
+	int side = value == "pl" ? 0 : value == "ai" ? 1 : -1;
+	if (name == "result" && value.size() == 1 && value[0] >= '0' && value[0] <= '8')
+		return RESULT + (value[0] - '0');
+	if (name == "closed")
+	{
+		if (value == "not") return CLOSED + (int)NOT;
+		if (value == "auto") return CLOSED + (int)AUTO;
+		if (side >= 0) return CLOSED + (int)(side ? BY_AI : BY_PLAYER);
+	}
+	if (name == "trump" && value.size() == 1)
+	{
+		static const std::string suites("cdhs");	// CardSuite order
+		pos = suites.find(value[0]);
+		if (pos != std::string::npos) return TRUMP + (int)pos;
+	}
+	if (name == "points" && value.size() == 4 && value[2] == ':' && value[3] >= '1' && value[3] <= '3')
+	{
+		std::string who = value.substr(0, 2);
+		int points = value[3] - '0';
+		if (who == "pl") return PLAYER_POINTS + points - 1;
+		if (who == "ai") return AI_POINTS + points - 1;
+	}
+	if (side < 0) return {};
+	if (name == "winner") return PLAYER_WINS + side;
+	if (name == "20") return PLAYER_20 + side;
+	if (name == "40") return PLAYER_40 + side;
+	return {};
+}
+
+void GameIndex::add(size_t n_, const Entry &entry_)
+{
+	set(_keys[RESULT + (int)entry_.result], n_);
+	set(_keys[CLOSED + (int)entry_.closed], n_);
+	set(_keys[TRUMP + (int)entry_.trump], n_);
+	if (entry_.points[0]) set(_keys[PLAYER_WINS], n_);
+	if (entry_.points[1]) set(_keys[AI_WINS], n_);
+	if (entry_.points[0] >= 1 && entry_.points[0] <= 3) set(_keys[PLAYER_POINTS + entry_.points[0] - 1], n_);
+	if (entry_.points[1] >= 1 && entry_.points[1] <= 3) set(_keys[AI_POINTS + entry_.points[1] - 1], n_);
+	for (int side = 0; side < 2; side++)
+	{
+		for (int s = 0; s < 4; s++)
+		{
+			if (!(entry_.s20_40 & (1u << (s + 4 * side)))) continue;
+			set(_keys[(CardSuite(s) == entry_.trump ? PLAYER_40 : PLAYER_20) + side], n_);
+		}
+	}
+	auto it = _builds.find(entry_.build);
+	if (it == _builds.end())
+		it = _builds.emplace(entry_.build, Bitmap(_keys[0].size())).first;
+	set(it->second, n_);
+}
+
+bool GameIndex::load(const std::string &name_)
+{
+	_entries.clear();
+	_keys.clear();
+	_builds.clear();
+	std::ifstream ifs(name_, std::ios::binary);
+	char header[5] = {};
+	if (!ifs.read(header, sizeof(header)) ||
+	    std::string(header, 4) != MAGIC || (uint8_t)header[4] != VERSION)
+	{
+		WNG("'" << name_ << "' is not a game index file!");
+		return false;
+	}
+	std::error_code ec;
+	size_t n = (std::filesystem::file_size(name_, ec) - sizeof(header)) / ENTRY_SIZE;
+	_entries.reserve(n);
+	_keys.assign(KEYS, Bitmap((n + 63) / 64));
+	uint8_t buf[ENTRY_SIZE];
+	while (_entries.size() < n && ifs.read((char *)buf, sizeof(buf)))
+	{
+		const uint8_t *p = buf;
+		auto get = [&](int bytes_)
+		{
+			uint64_t res = 0;
+			for (int i = 0; i < bytes_; i++)
+				res |= (uint64_t)*p++ << (8 * i);
+			return res;
+		};
+		Entry e;
+		e.offset = get(6);
+		e.build = get(4);
+		e.result = Result(get(1));
+		e.closed = Closed(get(1));
+		e.trump = CardSuite(get(1));
+		e.s20_40 = get(1);
+		e.points[0] = get(1);
+		e.points[1] = get(1);
+		if ((int)e.result > 8 || (int)e.closed > 3 || (int)e.trump > 3)
+		{
+			WNG("Corrupt game index entry #" << _entries.size() + 1);
+			break;
+		}
+		add(_entries.size(), e);
+		_entries.push_back(e);
+	}
+	return true;
+}
+
+GameIndex::Bitmap GameIndex::select(const std::vector<int> &keys_, std::optional<uint32_t> build_/* = {}*/) const
+{
+	//
+	// Games matching all keys (and build).
+	//
+	Bitmap res((_entries.size() + 63) / 64, ~0ull);
+	if (_entries.size() % 64 && res.size())
+		res.back() = (1ull << (_entries.size() % 64)) - 1;
+	auto combine = [&](const Bitmap &bitmap_)
+	{
+		for (size_t i = 0; i < res.size(); i++)
+			res[i] &= bitmap_[i];
+	};
+	for (int k : keys_)
+	{
+		if (k >= 0 && k < KEYS)
+			combine(_keys[k]);
+	}
+	if (build_)
+	{
+		auto it = _builds.find(build_.value());
+		if (it == _builds.end())
+			res.assign(res.size(), 0);
+		else
+			combine(it->second);
+	}
+	return res;
+}
+
+GameIndex::Stats GameIndex::stats(const Bitmap &selection_) const
+{
+	Stats res;
+	for (size_t i = 0; i < selection_.size(); i++)
+	{
+		for (uint64_t m = selection_[i]; m; m &= m - 1)
+		{
+			const Entry &e = _entries[i * 64 + std::countr_zero(m)];
+			res.games++;
+			res.wins[0] += e.points[0] != 0;
+			res.wins[1] += e.points[1] != 0;
+			res.points[0] += e.points[0];
+			res.points[1] += e.points[1];
+		}
+	}
+	return res;
+}
@@ -0,0 +1,239 @@
+//
+// Part of "Schnapsen for 2" card game.
+//
+// (c) 2026 Christian Grabner
+//
+// Compact game log with replay.
+//
+
+#include "GameLog.h"
+#include "UI.h"
+#include "debug.h"
+
+using enum Player;
+using enum CardState;
+using enum Closed;
+using enum Marriage;
+
+/*static*/
+void GameLog::copy_position(GameData &to_, const GameData &from_)
+{
+	// NOTE: gamebook is not part of the position
+	to_.cards = from_.cards;
+	to_.trump = from_.trump;
+	to_.marriage = from_.marriage;
+	to_.closed = from_.closed;
+	to_.move = from_.move;
+}
+
+/*static*/
+void GameLog::copy_position(PlayerData &to_, const PlayerData &from_)
+{
+	// NOTE: games/matches won are not part of the position
+	to_.cards = from_.cards;
+	to_.deck = from_.deck;
+	to_.card = from_.card;
+	to_.score = from_.score;
+	to_.score_closed = from_.score_closed;
+	to_.pending = from_.pending;
+	to_.s20_40 = from_.s20_40;
+	to_.move_state = from_.move_state;
+	to_.last_drawn = from_.last_drawn;
+	to_.changed = from_.changed;
+}
+
+void GameLog::start(const GameData &game_, const PlayerData &player_, const PlayerData &ai_)
+{
+	copy_position(_game, game_);
+	copy_position(_player, player_);
+	copy_position(_ai, ai_);
+	_events.clear();
+	_ply = 0;
+}
+
+void GameLog::add(Type type_, Player side_, uint8_t value_/* = 0*/)
+{
+	// a new event after undo discards the redo events
+	_events.resize(_ply);
+	_events.push_back({ type_, (uint8_t)side_, value_ });
+	_ply = _events.size();
+}
+
+void GameLog::add_move(Player side_, const Card &trump_card_, Closed closed_,
+                       const GameData &game_, const PlayerData &pd_)
+{
+	//
+	// Log the events of an engine move, from trump card and closed
+	// state before the move and the position after it.
+	//
+	if (game_.cards.size() && index(game_.cards.back()) != index(trump_card_))
+		add(Type::EXCHANGE, side_);
+	bool closes = closed_ == NOT && (game_.closed == BY_PLAYER || game_.closed == BY_AI);
+	bool marriage = game_.marriage != NO_MARRIAGE;
+	// a 20/40 declared before closing is contained in the closing score
+	if (marriage && (!closes || pd_.score_closed == pd_.score))
+	{
+		add(Type::MARRIAGE, side_, (uint8_t)pd_.card.suite());
+		marriage = false;
+	}
+	if (closes)
+		add(Type::CLOSE, side_);
+	if (marriage)
+		add(Type::MARRIAGE, side_, (uint8_t)pd_.card.suite());
+	add(Type::PLAY, side_, index(pd_.card));
+}
+
+size_t GameLog::plays(size_t ply_) const
+{
+	size_t res = 0;
+	for (size_t i = 0; i < ply_ && i < _events.size(); i++)
+		res += _events[i].type == Type::PLAY;
+	return res;
+}
+
+std::optional<size_t> GameLog::turn_ply(size_t ply_) const
+{
+	// last player turn at or before ply_
+	for (size_t i = std::min(ply_, _events.size()); i-- > 0;)
+	{
+		if (_events[i].type == Type::TURN) return i + 1;
+	}
+	return {};
+}
+
+std::optional<size_t> GameLog::undo_ply() const
+{
+	// previous player turn (or the first one)
+	auto ply = _ply ? turn_ply(_ply - 1) : std::nullopt;
+	return ply ? ply : turn_ply(_ply);
+}
+
+std::optional<size_t> GameLog::redo_ply() const
+{
+	for (size_t i = _ply; i < _events.size(); i++)
+	{
+		if (_events[i].type == Type::TURN) return i + 1;
+	}
+	return {};
+}
+
+/*static*/
+void GameLog::apply(const Event &e_, GameData &game_, PlayerData &player_, PlayerData &ai_,
+                    Engine &engine_, UI &ui_)
+{
+	//
+	// Same state changes (and animations) as done by Deck (and SelfPlay)
+	// for the action.
+	//
+	Player side = Player(e_.side);
+	PlayerData &pd = side == PLAYER ? player_ : ai_;
+	PlayerData &opponent = side == PLAYER ? ai_ : player_;
+	switch (e_.type)
+	{
+		case Type::TURN:
+			break;
+		case Type::PLAY:
+		{
+			Card c = card(e_.value);
+			auto i = pd.cards.find_pos(c);
+			assert(i);
+			pd.cards.erase(pd.cards.begin() + i.value());
+			pd.card = c;
+			ui_.animate_move();
+			pd.move_state = ON_TABLE;
+			ui_.update();
+			if (opponent.move_state != ON_TABLE && engine_.test_end() == Result::NO_WIN)
+				game_.move = side == PLAYER ? AI : PLAYER;
+			break;
+		}
+		case Type::MARRIAGE:
+		{
+			CardSuite suite = CardSuite(e_.value);
+			int score = suite == game_.trump ? 40 : 20;
+			pd.s20_40.push_front(suite);
+			(pd.deck.empty() ? pd.pending : pd.score) += score;
+			game_.marriage = score == 40 ? MARRIAGE_40 : MARRIAGE_20;
+			ui_.update();
+			break;
+		}
+		case Type::EXCHANGE:
+		{
+			Card trump_card = game_.cards.back();
+			engine_.test_change(pd, true);
+			if (side == PLAYER)
+				pd.last_drawn = trump_card;
+			pd.move_state = NONE;
+			break;
+		}
+		case Type::CLOSE:
+			game_.move = side;
+			engine_.do_close(pd);
+			break;
+		case Type::TRICK:
+			game_.marriage = NO_MARRIAGE;
+			game_.move = engine_.check_trick(side);
+			engine_.score_trick();
+			break;
+		case Type::DRAW:
+		{
+			// winner of trick draws first
+			PlayerData &first = game_.move == PLAYER ? player_ : ai_;
+			PlayerData &second = game_.move == PLAYER ? ai_ : player_;
+			for (PlayerData *p : { &first, &second })
+			{
+				if (game_.cards.empty()) break;
+				p->last_drawn = game_.cards.front();
+				game_.cards.pop_front();
+				ui_.animate_deal(p == &player_ ? PLAYER : AI);
+				p->cards.push_front(p->last_drawn);
+			}
+			engine_.sort_cards(player_.cards)
+			       .sort_cards(ai_.cards);
+			if (game_.cards.empty())
+				game_.closed = AUTO;
+			ui_.update();
+			break;
+		}
+		case Type::CLAIM:
+			pd.score = 66;
+			break;
+	}
+}
+
+bool GameLog::replay(size_t ply_, GameData &game_, PlayerData &player_, PlayerData &ai_)
+{
+	//
+	// Restore the position after ply_ events.
+	//
+	if (ply_ > _events.size()) return false;
+	GameData game;
+	PlayerData player;
+	PlayerData ai;
+	copy_position(game, _game);
+	copy_position(player, _player);
+	copy_position(ai, _ai);
+	game.trump_sort = game_.trump_sort;
+	UI ui;
+	Engine engine(game, player, ai, ui);
+	bool quiet = Util::quiet();
+	Util::quiet() = true;
+	for (size_t i = 0; i < ply_; i++)
+		apply(_events[i], game, player, ai, engine, ui);
+	Util::quiet() = quiet;
+	copy_position(game_, game);
+	copy_position(player_, player);
+	copy_position(ai_, ai);
+	_ply = ply_;
+	return true;
+}
+
+bool GameLog::step(GameData &game_, PlayerData &player_, PlayerData &ai_, Engine &engine_, UI &ui_)
+{
+	//
+	// Apply the next event to the (live) position, with the UI
+	// animations. The engine must work on the same position.
+	//
+	if (_ply >= _events.size()) return false;
+	apply(_events[_ply++], game_, player_, ai_, engine_, ui_);
+	return true;
+}
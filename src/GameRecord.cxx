@@ -0,0 +1,564 @@
+//
+// Part of "Schnapsen for 2" card game.
+//
+// (c) 2026 Christian Grabner
+//
+// Binary game records (append-only file, streaming reader).
+//
+// Build the standalone record tool with:
+//   make GameRecord
+// Run with:
+//   ./GameRecord [file]                         summary of all records
+//   ./GameRecord export [file]                  one text line per event
+//   ./GameRecord replay [file]                  replay all records at maximum speed
+//   ./GameRecord to-scg file number [ply] name  position of a record as .scg
+//   ./GameRecord from-scg file name...          append .scg positions as records
+//   ./GameRecord index [file]                   rebuild index of the records
+//   ./GameRecord query [file] key=value... [-l] games matching all keys
+// Query keys are result=0..8, closed=not|pl|ai|auto, trump=c|d|h|s,
+// winner=pl|ai, 20=pl|ai, 40=pl|ai (declared), points=pl|ai:1..3 (game
+// points won) and build=<hex>.
+// The default file is the record file of the game ('fltk-schnapsen.rec'),
+// record number 0 is the last record.
+//
+
+#ifdef STANDALONE
+constexpr char APPLICATION[] = "fltk-schnapsen";
+#include "debug.h"
+#endif
+
+#include "GameRecord.h"
+#include "GameIndex.h"
+#include "debug.h"
+#include <filesystem>
+
+using enum CardState;
+
+static void rec_put(std::string &buf_, uint64_t value_, int bytes_)
+{
+	for (int i = 0; i < bytes_; i++)
+		buf_.push_back((char)(uint8_t)(value_ >> (8 * i)));
+}
+
+static uint64_t rec_get(const uint8_t *&data_, int bytes_)
+{
+	uint64_t res = 0;
+	for (int i = 0; i < bytes_; i++)
+		res |= (uint64_t)*data_++ << (8 * i);
+	return res;
+}
+
+void GameRecord::from_log(const GameLog &log_, Result result_, const std::pair<int, int> &points_)
+{
+	game = log_.start_game();
+	player = log_.start_player();
+	ai = log_.start_ai();
+	events.clear();
+	for (auto &e : log_.events())
+	{
+		// player turns are only stops for undo
+		if (e.type != GameLog::Type::TURN)
+			events.push_back(e);
+	}
+	result = result_;
+	points[0] = points_.first;
+	points[1] = points_.second;
+}
+
+void GameRecord::to_log(GameLog &log_) const
+{
+	log_.start(game, player, ai);
+	for (auto &e : events)
+		log_.add(e.type, Player(e.side), e.value);
+}
+
+bool GameRecord::replay(size_t ply_, GameData &game_, PlayerData &player_, PlayerData &ai_) const
+{
+	GameLog log;
+	to_log(log);
+	return log.replay(ply_, game_, player_, ai_);
+}
+
+/*static*/
+uint64_t GameRecord::rank(const std::vector<uint8_t> &perm_)
+{
+	// Lehmer code of the permutation (20! < 2^64)
+	uint64_t res = 0;
+	for (size_t i = 0; i < perm_.size(); i++)
+	{
+		uint64_t smaller = 0;
+		for (size_t j = i + 1; j < perm_.size(); j++)
+			smaller += perm_[j] < perm_[i];
+		res = res * (perm_.size() - i) + smaller;
+	}
+	return res;
+}
+
+/*static*/
+std::vector<uint8_t> GameRecord::unrank(uint64_t rank_, size_t n_)
+{
+	std::vector<uint8_t> digits(n_);
+	for (size_t i = n_; i-- > 0;)
+	{
+		digits[i] = (uint8_t)(rank_ % (n_ - i));
+		rank_ /= n_ - i;
+	}
+	std::vector<uint8_t> left;
+	for (size_t i = 0; i < n_; i++)
+		left.push_back((uint8_t)i);
+	std::vector<uint8_t> res;
+	for (auto d : digits)
+	{
+		res.push_back(left[d]);
+		left.erase(left.begin() + d);
+	}
+	return res;
+}
+
+void GameRecord::encode(std::string &buf_) const
+{
+	//
+	// The cards of all places in fixed order form a permutation of
+	// the 20 cards (cards not present are appended in index order).
+	//
+	bool on_table[2] = { player.move_state == ON_TABLE, ai.move_state == ON_TABLE };
+	std::vector<uint8_t> perm;
+	bool used[20] = {};
+	auto add = [&](const Card &c_)
+	{
+		uint8_t i = GameLog::index(c_);
+		if (i < 20 && !used[i])
+		{
+			used[i] = true;
+			perm.push_back(i);
+		}
+	};
+	size_t sizes[5];
+	const Cards *places[5] = { &player.cards, &player.deck, &ai.cards, &ai.deck, &game.cards };
+	for (int i = 0; i < 5; i++)
+	{
+		size_t n = perm.size();
+		for (auto &c : *places[i])
+			add(c);
+		sizes[i] = perm.size() - n;
+	}
+	if (on_table[0]) add(player.card);
+	if (on_table[1]) add(ai.card);
+	for (uint8_t i = 0; i < 20; i++)
+	{
+		if (!used[i]) perm.push_back(i);
+	}
+	rec_put(buf_, rank(perm), 8);
+	for (auto s : sizes)
+		rec_put(buf_, s, 1);
+	unsigned flags = (unsigned)game.trump |
+	                 (unsigned)game.closed << 3 |
+	                 (unsigned)game.move << 5 |
+	                 on_table[0] << 6 |
+	                 on_table[1] << 7 |
+	                 (unsigned)game.marriage << 8;
+	rec_put(buf_, flags, 2);
+	for (const PlayerData *pd : { &player, &ai })
+	{
+		rec_put(buf_, pd->score, 1);
+		rec_put(buf_, pd->score_closed, 1);
+		rec_put(buf_, pd->pending, 1);
+	}
+	// NOTE: order of declared 20/40 is not kept
+	unsigned s20_40 = 0;
+	for (auto s : player.s20_40)
+		s20_40 |= 1u << (int)s;
+	for (auto s : ai.s20_40)
+		s20_40 |= 1u << ((int)s + 4);
+	rec_put(buf_, s20_40, 1);
+	rec_put(buf_, (unsigned)result, 1);
+	rec_put(buf_, points[0], 1);
+	rec_put(buf_, points[1], 1);
+	rec_put(buf_, events.size(), 2);
+	for (auto &e : events)
+	{
+		rec_put(buf_, (unsigned)e.type | e.side << 4, 1);
+		rec_put(buf_, e.value, 1);
+	}
+}
+
+bool GameRecord::decode(const uint8_t *data_, size_t size_)
+{
+	constexpr size_t header = 8 + 5 + 2 + 6 + 1 + 1 + 2 + 2;
+	if (size_ < header) return false;
+	const uint8_t *p = data_;
+	uint64_t r = rec_get(p, 8);
+	size_t sizes[5];
+	size_t total = 0;
+	for (auto &s : sizes)
+		total += s = rec_get(p, 1);
+	unsigned flags = rec_get(p, 2);
+	bool on_table[2] = { (flags & 0x40) != 0, (flags & 0x80) != 0 };
+	total += on_table[0] + on_table[1];
+	if (total > 20 || (flags & 7) > 3 || (flags >> 8) > 2) return false;
+	// 20! - 1
+	if (r > 2432902008176639999ull) return false;
+	std::vector<uint8_t> perm = unrank(r, 20);
+
+	game = GameData();
+	player = PlayerData();
+	ai = PlayerData();
+	game.trump = CardSuite(flags & 7);
+	game.closed = Closed((flags >> 3) & 3);
+	game.move = Player((flags >> 5) & 1);
+	game.marriage = Marriage(flags >> 8);
+	Cards *places[5] = { &player.cards, &player.deck, &ai.cards, &ai.deck, &game.cards };
+	size_t n = 0;
+	for (int i = 0; i < 5; i++)
+	{
+		for (size_t j = 0; j < sizes[i]; j++)
+			places[i]->push_back(GameLog::card(perm[n++]));
+	}
+	if (on_table[0])
+	{
+		player.card = GameLog::card(perm[n++]);
+		player.move_state = ON_TABLE;
+	}
+	if (on_table[1])
+	{
+		ai.card = GameLog::card(perm[n++]);
+		ai.move_state = ON_TABLE;
+	}
+	for (PlayerData *pd : { &player, &ai })
+	{
+		pd->score = rec_get(p, 1);
+		pd->score_closed = rec_get(p, 1);
+		pd->pending = rec_get(p, 1);
+	}
+	unsigned s20_40 = rec_get(p, 1);
+	for (int s = 0; s < 4; s++)
+	{
+		if (s20_40 & (1u << s)) player.s20_40.push_back(CardSuite(s));
+		if (s20_40 & (1u << (s + 4))) ai.s20_40.push_back(CardSuite(s));
+	}
+	unsigned res = rec_get(p, 1);
+	if (res > (unsigned)Result::AI_WINS_PLAYER_CLOSED_NOT_ENOUGH) return false;
+	result = Result(res);
+	points[0] = rec_get(p, 1);
+	points[1] = rec_get(p, 1);
+	size_t count = rec_get(p, 2);
+	if (size_ != header + 2 * count) return false;
+	events.resize(count);
+	for (auto &e : events)
+	{
+		unsigned type = rec_get(p, 1);
+		e.value = rec_get(p, 1);
+		e.type = GameLog::Type(type & 0xf);
+		e.side = type >> 4;
+		if (e.type > GameLog::Type::CLAIM || e.side > 1) return false;
+		if (e.type == GameLog::Type::PLAY && e.value >= 20) return false;
+	}
+	return true;
+}
+
+bool GameRecordWriter::write(const GameRecord &rec_)
+{
+	TRACE("GameRecordWriter::write");
+	//
+	// Append one record (and its index entry). The file is opened for
+	// each record, so an abnormal end of the program cannot lose more
+	// than the current game.
+	//
+	std::error_code ec;
+	uint64_t offset = std::filesystem::exists(_name, ec) ? std::filesystem::file_size(_name, ec) : 0;
+	bool empty = offset == 0;
+	std::ofstream ofs(_name, std::ios::binary | std::ios::app);
+	if (!ofs.is_open())
+	{
+		WNG("Can't write game record file '" << _name << "'!");
+		return false;
+	}
+	_buf.clear();
+	if (empty)
+	{
+		_buf.append(GameRecord::MAGIC, 4);
+		rec_put(_buf, GameRecord::VERSION, 1);
+	}
+	size_t start = _buf.size();
+	rec_put(_buf, 0, 2);
+	rec_.encode(_buf);
+	size_t size = _buf.size() - start - 2;
+	_buf[start] = (char)(size & 0xff);
+	_buf[start + 1] = (char)(size >> 8);
+	ofs.write(_buf.data(), _buf.size());
+	ofs.flush();
+	if (!ofs.good()) return false;
+
+	// NOTE: a missing index of existing records is not continued
+	std::string index = GameIndex::file(_name);
+	if (empty || std::filesystem::exists(index, ec))
+		GameIndex::append(index, GameIndex::entry(rec_, offset + start, _build));
+	return true;
+}
+
+GameRecordReader::GameRecordReader(const std::string &name_) :
+	_ifs(name_, std::ios::binary),
+	_good(false),
+	_count(0),
+	_offset(0)
+{
+	char header[5] = {};
+	if (!_ifs.read(header, sizeof(header))) return;
+	_good = std::string(header, 4) == GameRecord::MAGIC && (uint8_t)header[4] == GameRecord::VERSION;
+	if (!_good)
+		WNG("'" << name_ << "' is not a game record file!");
+}
+
+bool GameRecordReader::next(GameRecord &rec_)
+{
+	//
+	// Read next record into the reused buffer. A truncated or corrupt
+	// record ends reading (e.g. the file of a crashed program).
+	//
+	if (!_good) return false;
+	_offset = _ifs.tellg();
+	uint8_t size[2];
+	if (!_ifs.read((char *)size, 2))
+	{
+		if (_ifs.gcount())
+			WNG("Truncated game record #" << _count + 1);
+		return _good = false;
+	}
+	_buf.resize(size[0] | size[1] << 8);
+	if (!_ifs.read((char *)_buf.data(), _buf.size()))
+	{
+		WNG("Truncated game record #" << _count + 1);
+		return _good = false;
+	}
+	if (!rec_.decode(_buf.data(), _buf.size()))
+	{
+		WNG("Corrupt game record #" << _count + 1);
+		return _good = false;
+	}
+	_count++;
+	return true;
+}
+
+bool GameRecordReader::read_at(uint64_t offset_, GameRecord &rec_)
+{
+	// record at offset (from index), record count is not changed
+	if (!_ifs.is_open()) return false;
+	_ifs.clear();
+	_ifs.seekg(offset_);
+	_good = true;
+	size_t count = _count;
+	bool res = next(rec_);
+	_count = count;
+	return res;
+}
+
+bool GameRecordReader::find(size_t number_, GameRecord &rec_)
+{
+	// record number_ (1..) or the last record (0)
+	GameRecord rec;
+	bool found = false;
+	while (next(rec))
+	{
+		std::swap(rec, rec_);
+		found = true;
+		if (_count == number_) return true;
+	}
+	return found && number_ == 0;
+}
+
+#ifdef STANDALONE
+#undef STANDALONE
+namespace Schnapsen
+{
+	int debug = 0;
+};
+#include "Util.cxx"
+#include "Config.cxx"
+#include "Log.cxx"
+#include "Trace.cxx"
+#include "Card.cxx"
+#include "CardImage.cxx"
+#include "Cards.cxx"
+#include "EngineParams.cxx"
+#include "EngineStats.cxx"
+#include "Engine.cxx"
+#include "GameLog.cxx"
+#include "GameFile.cxx"
+#include "GameIndex.cxx"
+#include "UI.h"
+#include <chrono>
+#include <map>
+
+static const char *type_name(GameLog::Type type_)
+{
+	static const char *names[] = { "turn", "play", "20/40", "exchange", "close", "trick", "draw", "claim" };
+	return names[(int)type_];
+}
+
+int main(int argc_, char *argv_[])
+{
+	std::vector<std::string> args(argv_ + 1, argv_ + argc_);
+	std::string cmd = args.size() && (args[0] == "export" || args[0] == "replay" ||
+	                                  args[0] == "to-scg" || args[0] == "from-scg" ||
+	                                  args[0] == "index" || args[0] == "query") ? args[0] : "";
+	if (cmd.size()) args.erase(args.begin());
+	bool has_file = args.size() && args[0].find('=') == std::string::npos && args[0][0] != '-';
+	std::string file = has_file ? args[0] : Util::rec_file();
+	GameRecord rec;
+
+	if (cmd == "from-scg")
+	{
+		GameRecordWriter writer(file);
+		for (size_t i = 1; i < args.size(); i++)
+		{
+			if (!GameFile::load(args[i], rec.game, rec.player, rec.ai))
+				return EXIT_FAILURE;
+			rec.events.clear();
+			rec.result = Result::NO_WIN;
+			rec.points[0] = rec.points[1] = 0;
+			if (!writer.write(rec)) return EXIT_FAILURE;
+			OUT("appended '" << args[i] << "'\n");
+		}
+		return EXIT_SUCCESS;
+	}
+
+	if (cmd == "index")
+	{
+		OUT(GameIndex::rebuild(file) << " records indexed\n");
+		return EXIT_SUCCESS;
+	}
+
+	if (cmd == "query")
+	{
+		// answered from the index only
+		GameIndex index;
+		if (!index.load(GameIndex::file(file)))
+			return EXIT_FAILURE;
+		std::vector<int> keys;
+		std::optional<uint32_t> build;
+		bool list = false;
+		for (size_t i = has_file; i < args.size(); i++)
+		{
+			if (args[i] == "-l")
+				list = true;
+			else if (args[i].starts_with("build="))
+				build = strtoul(args[i].substr(6).c_str(), nullptr, 16);
+			else if (auto key = GameIndex::key(args[i]))
+				keys.push_back(key.value());
+			else
+			{
+				WNG("Unknown query key '" << args[i] << "'");
+				return EXIT_FAILURE;
+			}
+		}
+		GameIndex::Bitmap selection = index.select(keys, build);
+		GameIndex::Stats stats = index.stats(selection);
+		auto rate = [&](size_t wins_) { return stats.games ? 100. * wins_ / stats.games : 0.; };
+		OUT(stats.games << "/" << index.size() << " games, PL wins " << stats.wins[0] << " (" << rate(stats.wins[0])
+		    << "%), AI wins " << stats.wins[1] << " (" << rate(stats.wins[1]) << "%), game points "
+		    << stats.points[0] << "/" << stats.points[1] << "\n");
+		for (size_t i = 0; list && i < index.size(); i++)
+		{
+			if (selection[i / 64] & (1ull << (i % 64)))
+				OUT(i + 1 << " ");
+		}
+		if (list) OUT("\n");
+		return EXIT_SUCCESS;
+	}
+
+	GameRecordReader reader(file);
+	if (!reader.good())
+	{
+		WNG("Can't read game records from '" << file << "'");
+		return EXIT_FAILURE;
+	}
+
+	if (cmd == "to-scg")
+	{
+		if (args.size() < 3)
+		{
+			WNG("usage: GameRecord to-scg file number [ply] name");
+			return EXIT_FAILURE;
+		}
+		size_t number = atoi(args[1].c_str());
+		std::optional<size_t> ply;
+		if (args.size() > 3) ply = atoi(args[2].c_str());
+		if (!reader.find(number, rec))
+		{
+			WNG("No record #" << number);
+			return EXIT_FAILURE;
+		}
+		GameData game;
+		PlayerData player;
+		PlayerData ai;
+		if (!rec.replay(ply.value_or(0), game, player, ai))
+		{
+			WNG("Record #" << reader.count() << " has only " << rec.events.size() << " events");
+			return EXIT_FAILURE;
+		}
+		return GameFile::save(args.back(), game, player, ai) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (cmd == "replay")
+	{
+		// headless replay of all records, check of the recorded results
+		size_t events = 0;
+		size_t differ = 0;
+		auto start = std::chrono::steady_clock::now();
+		while (reader.next(rec))
+		{
+			GameData game;
+			PlayerData player;
+			PlayerData ai;
+			rec.replay(rec.events.size(), game, player, ai);
+			UI ui;
+			Engine engine(game, player, ai, ui);
+			if (rec.events.size() && engine.test_end() != rec.result)
+			{
+				differ++;
+				WNG("Record #" << reader.count() << ": result " << (int)engine.test_end()
+				    << " instead of " << (int)rec.result << "\n");
+			}
+			events += rec.events.size();
+		}
+		std::chrono::duration<double> diff = std::chrono::steady_clock::now() - start;
+		size_t n = reader.count();
+		OUT(n << " games (" << events << " events) replayed in " << diff.count() << "s, "
+		    << (diff.count() > 0 ? n / diff.count() : 0.) << " games/s, " << differ << " with different result\n");
+		return differ ? EXIT_FAILURE : EXIT_SUCCESS;
+	}
+
+	if (cmd == "export")
+	{
+		// training data: record, ply, side, event, value, result, game points
+		while (reader.next(rec))
+		{
+			for (size_t i = 0; i < rec.events.size(); i++)
+			{
+				auto &e = rec.events[i];
+				OUT(reader.count() << "," << i + 1 << "," << (e.side ? "AI" : "PL") << ","
+				    << type_name(e.type) << "," << (int)e.value << "," << (int)rec.result << ","
+				    << rec.points[0] << "," << rec.points[1] << "\n");
+			}
+		}
+		return EXIT_SUCCESS;
+	}
+
+	size_t events = 0;
+	int points[2] = { 0, 0 };
+	std::map<int, size_t> results;
+	while (reader.next(rec))
+	{
+		events += rec.events.size();
+		points[0] += rec.points[0];
+		points[1] += rec.points[1];
+		results[(int)rec.result]++;
+	}
+	size_t n = reader.count();
+	OUT(n << " records, " << (n ? (double)events / n : 0.) << " events per game\n");
+	OUT("game points PL/AI: " << points[0] << "/" << points[1] << "\n");
+	for (auto &[result, count] : results)
+		OUT("result " << result << ": " << count << "\n");
+	return EXIT_SUCCESS;
+}
+#endif
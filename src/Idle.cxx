@@ -0,0 +1,119 @@
+//
+// Part of "Schnapsen for 2" card game.
+//
+// (c) 2026 Christian Grabner
+//
+// Suspend decorative timers while the player does not interact.
+//
+#include "Idle.h"
+#include "Config.h"
+#include <FL/Fl.H>
+#include <algorithm>
+
+std::list<Idle::Ticker> Idle::_tickers;
+Idle::Clock::time_point Idle::_last_input = Idle::Clock::now();
+Idle::Clock::time_point Idle::_rate_start = Idle::Clock::now();
+uint64_t Idle::_rate_wakeups = 0;
+Idle::Stats Idle::_stats;
+
+/*static*/
+void Idle::init()
+{
+	Fl::add_check(cb_check);
+}
+
+/*static*/
+void Idle::cb_check(void *)
+{
+	//
+	// Called by each pass of the event loop (before it waits again).
+	//
+	_stats.wakeups++;
+	_rate_wakeups++;
+	Clock::time_point now = Clock::now();
+	double elapsed = std::chrono::duration<double>(now - _rate_start).count();
+	if (elapsed >= 1.)
+	{
+		_stats.rate = _rate_wakeups / elapsed;
+		_stats.max_rate = std::max(_stats.max_rate, _stats.rate);
+		_rate_start = now;
+		_rate_wakeups = 0;
+	}
+}
+
+/*static*/
+void Idle::repeat(double interval_, Callback cb_, void *data_)
+{
+	// call cb_ every interval_ seconds (while not idle)
+	remove(cb_, data_);
+	_tickers.push_back({ cb_, data_, interval_, false });
+	Fl::add_timeout(interval_, cb_tick, &_tickers.back());
+}
+
+/*static*/
+void Idle::remove(Callback cb_, void *data_)
+{
+	for (auto it = _tickers.begin(); it != _tickers.end(); ++it)
+	{
+		if (it->cb != cb_ || it->data != data_) continue;
+		Fl::remove_timeout(cb_tick, &*it);
+		_tickers.erase(it);
+		break;
+	}
+}
+
+/*static*/
+bool Idle::has_repeat(Callback cb_, void *data_)
+{
+	return std::any_of(_tickers.begin(), _tickers.end(),
+		[&](const Ticker &t_) { return t_.cb == cb_ && t_.data == data_; });
+}
+
+/*static*/
+void Idle::cb_tick(void *d_)
+{
+	Ticker &t = *static_cast<Ticker *>(d_);
+	if (idle())
+	{
+		// stop until next input
+		t.suspended = true;
+		_stats.suspended++;
+		return;
+	}
+	Fl::repeat_timeout(t.interval, cb_tick, d_);
+	t.cb(t.data);	// (may remove ticker)
+}
+
+/*static*/
+void Idle::input()
+{
+	// user activity: restart suspended timers
+	_last_input = Clock::now();
+	for (Ticker &t : _tickers)
+	{
+		if (!t.suspended) continue;
+		t.suspended = false;
+		Fl::add_timeout(t.interval, cb_tick, &t);
+	}
+}
+
+/*static*/
+bool Idle::idle()
+{
+	int idle_time = Config::as_int(Config::IDLE_TIME);
+	return idle_time > 0 && Clock::now() - _last_input >= std::chrono::seconds(idle_time);
+}
+
+/*static*/
+const Idle::Stats &Idle::stats()
+{
+	return _stats;
+}
+
+/*static*/
+void Idle::reset_stats()
+{
+	_stats = {};
+	_rate_start = Clock::now();
+	_rate_wakeups = 0;
+}
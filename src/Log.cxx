@@ -0,0 +1,224 @@
+//
+// Part of "Schnapsen for 2" card game.
+//
+// (c) 2026 Christian Grabner
+//
+// Asynchronous log backend.
+//
+
+#include "Log.h"
+#include "debug.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+
+Log::Log(const std::string &name_) :
+	_head(0),
+	_tail(0),
+	_written(0),
+	_pending(0),
+	_stopping(false),
+	_stopped(false),
+	_name(name_)
+{
+	for (size_t i = 0; i < SLOTS; i++)
+		_slots[i].seq.store(i, std::memory_order_relaxed);
+	_thread = std::thread(&Log::run, this);
+}
+
+/*static*/
+Log &Log::instance()
+{
+	// created on first message, never destroyed (may be used by static destructors)
+	static Log *log = []()
+	{
+		Log *log = new Log(std::filesystem::temp_directory_path().string() + "/fltk-schnapsen.log");
+		_log.store(log, std::memory_order_release);
+		std::atexit([]() { _log.load()->stop(); });
+		return log;
+	}();
+	return *log;
+}
+
+/*static*/
+std::ostringstream &Log::buffer()
+{
+	static thread_local std::ostringstream os;
+	return os;
+}
+
+/*static*/
+std::ostream &Log::begin()
+{
+	std::ostringstream &os = buffer();
+	os.str(std::string());
+	return os;
+}
+
+/*static*/
+void Log::end(Level level_)
+{
+	instance().push(level_, std::move(buffer()).str());
+}
+
+/*static*/
+void Log::flush()
+{
+	//
+	// Wait until all messages logged so far are written
+	// (e.g. to keep the order with direct console output).
+	//
+	Log *log = _log.load(std::memory_order_acquire);
+	if (!log || log->_stopping) return;
+	uint64_t head = log->_head.load(std::memory_order_acquire);
+	uint64_t written = log->_written.load(std::memory_order_acquire);
+	while (written < head)
+	{
+		log->_pending.fetch_add(1, std::memory_order_release);
+		log->_pending.notify_one();
+		log->_written.wait(written, std::memory_order_acquire);
+		written = log->_written.load(std::memory_order_acquire);
+	}
+}
+
+void Log::push(Level level_, std::string &&text_)
+{
+	int loglevel = Config::as_int(Config::LOGLEVEL);
+	bool console = level_ <= loglevel;
+	bool file = level_ <= std::max(loglevel, Config::as_int(Config::LOGFILE));
+	if (_stopped)
+	{
+		// at exit (writer thread has finished): write directly
+		std::lock_guard<std::mutex> lock(_mutex);
+		write_slots();
+		write(level_, console, file, text_);
+		_ofs.flush();
+		return;
+	}
+
+	//
+	// Bounded multi producer queue: a slot is claimed by advancing
+	// _head, its sequence number tells if it is free (== pos) or
+	// still holds an unwritten message of the previous round.
+	//
+	uint64_t pos = _head.load(std::memory_order_relaxed);
+	Slot *slot;
+	for (;;)
+	{
+		slot = &_slots[pos & (SLOTS - 1)];
+		uint64_t seq = slot->seq.load(std::memory_order_acquire);
+		if (seq == pos)
+		{
+			if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (seq < pos)
+		{
+			// ring buffer full: let the writer catch up (no messages are lost)
+			if (_stopped)
+				drain();
+			_pending.fetch_add(1, std::memory_order_release);
+			_pending.notify_one();
+			std::this_thread::yield();
+			pos = _head.load(std::memory_order_relaxed);
+		}
+		else
+		{
+			pos = _head.load(std::memory_order_relaxed);
+		}
+	}
+	slot->level = level_;
+	slot->console = console;
+	slot->file = file;
+	slot->text = std::move(text_);
+	slot->seq.store(pos + 1);
+	if (_stopped)
+	{
+		// writer thread has finished meanwhile
+		drain();
+		return;
+	}
+	_pending.fetch_add(1, std::memory_order_release);
+	_pending.notify_one();
+}
+
+void Log::write(Level level_, bool console_, bool file_, const std::string &text_)
+{
+	if (file_)
+	{
+		if (!_ofs.is_open())
+			_ofs.open(_name, std::ios::binary);
+		if (level_ == WARNING)
+			_ofs << "!" << text_ << "\n";
+		else
+			_ofs << text_;
+	}
+	if (!console_) return;
+	if (level_ == WARNING)
+		std::cerr << WNG_PREFIX << text_ << RESET_ATTR << "\n";
+	else
+		std::cout << (level_ == INFO ? LOG_PREFIX : DBG_PREFIX) << text_ << RESET_ATTR;
+}
+
+uint64_t Log::write_slots()
+{
+	// write the published messages (by one consumer at a time)
+	uint64_t tail = _tail.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		Slot &slot = _slots[tail & (SLOTS - 1)];
+		if (slot.seq.load() != tail + 1) break;
+		write(slot.level, slot.console, slot.file, slot.text);
+		slot.text.clear();
+		slot.seq.store(tail + SLOTS, std::memory_order_release);
+		_tail.store(++tail, std::memory_order_relaxed);
+	}
+	return tail;
+}
+
+void Log::drain()
+{
+	//
+	// After the writer thread has finished, messages still in the
+	// ring buffer are written by stop() or the producer that
+	// published them last.
+	//
+	std::lock_guard<std::mutex> lock(_mutex);
+	write_slots();
+	_ofs.flush();
+	std::cout.flush();
+}
+
+void Log::run()
+{
+	//
+	// Writer thread: drain the ring buffer, then sleep until
+	// the next message is pushed.
+	//
+	for (;;)
+	{
+		uint32_t pending = _pending.load(std::memory_order_acquire);
+		uint64_t tail = write_slots();
+		if (tail != _written.load(std::memory_order_relaxed))
+		{
+			_ofs.flush();
+			std::cout.flush();
+			_written.store(tail, std::memory_order_release);
+			_written.notify_all();
+		}
+		if (_stopping && tail == _head.load(std::memory_order_acquire)) break;
+		_pending.wait(pending, std::memory_order_acquire);
+	}
+}
+
+void Log::stop()
+{
+	_stopping = true;
+	_pending.fetch_add(1, std::memory_order_release);
+	_pending.notify_one();
+	if (_thread.joinable())
+		_thread.join();
+	_stopped = true;
+	drain();	// (pushed while the writer finished)
+}
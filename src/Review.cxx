@@ -0,0 +1,115 @@
+//
+// Part of "Schnapsen for 2" card game.
+//
+// (c) 2026 Christian Grabner
+//
+// Post-game review of the moves played against the exact solver.
+//
+#include "Review.h"
+#include "Solver.h"
+#include "debug.h"
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+ReviewResult Review::analyze(const ReviewMove &move_) const
+{
+	ReviewResult res;
+	if (!Solver::solvable(move_.position)) return res; // hidden pack: not exact
+
+	Solver solver(_strictness);
+	res.values = solver.evaluate(move_.position);
+	if (res.values.empty()) return res;
+	auto played = std::find_if(res.values.begin(), res.values.end(),
+		[&](const auto &v_) { return v_.first == move_.card; });
+	if (move_.card >= 0 && played == res.values.end())
+	{
+		// log and position disagree: not a legal move here
+		WNG("Review: card " << Solver::card(move_.card) << " is not a legal move, skipped!");
+		res.values.clear();
+		return res;
+	}
+	res.analyzed = true;
+	auto best = std::max_element(res.values.begin(), res.values.end(),
+		[](const auto &a_, const auto &b_) { return a_.second < b_.second; });
+	res.best_card = best->first;
+	res.best = best->second;
+	res.played = played != res.values.end() ? played->second : res.best;
+	return res;
+}
+
+std::vector<ReviewResult> Review::run(const std::vector<ReviewMove> &moves_) const
+{
+	//
+	// Analyze all moves in parallel, each worker takes the next
+	// unanalyzed move until all are done.
+	//
+	std::vector<ReviewResult> results(moves_.size());
+	std::atomic<size_t> next(0);
+	auto worker = [&]()
+	{
+		for (size_t i = next++; i < moves_.size(); i = next++)
+			results[i] = analyze(moves_[i]);
+	};
+	size_t workers = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), moves_.size());
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < workers; i++)
+		threads.emplace_back(worker);
+	for (auto &t : threads)
+		t.join();
+	return results;
+}
+
+std::string Review::report(const std::vector<ReviewMove> &moves_, const std::vector<ReviewResult> &results_) const
+{
+	//
+	// Per-move error list and summary per side. For the AI side
+	// the summary shows how often the engine deviates from optimal.
+	//
+	std::ostringstream os;
+	int analyzed[2] = { 0, 0 };
+	int deviations[2] = { 0, 0 };
+	int lost[2] = { 0, 0 };
+	for (size_t i = 0; i < moves_.size(); i++)
+	{
+		const ReviewMove &m = moves_[i];
+		const ReviewResult &r = results_[i];
+		int side = (int)m.position.move;
+		os << (i + 1) << "\t" << (m.position.move == Player::PLAYER ? "PL" : "AI") << "\t";
+		if (m.card >= 0)
+			os << Solver::card(m.card);
+		else
+			os << "-";
+		if (!r.analyzed)
+		{
+			os << "\t(open)\n";
+			continue;
+		}
+		os << "\tbest: " << Solver::card(r.best_card) << " (" << r.best << ")";
+		if (m.card < 0)
+		{
+			for (auto &[card, value] : r.values)
+				os << " " << Solver::card(card) << ":" << value;
+		}
+		else
+		{
+			analyzed[side]++;
+			if (r.played < r.best)
+			{
+				deviations[side]++;
+				lost[side] += r.best - r.played;
+				os << "\tloss: " << (r.best - r.played);
+			}
+		}
+		os << "\n";
+	}
+	for (int side = 0; side < 2; side++)
+	{
+		if (!analyzed[side]) continue;
+		os << (side == (int)Player::PLAYER ? "PL" : "AI") << ": " << analyzed[side] << " moves analyzed, "
+		   << deviations[side] << " not optimal (" << deviations[side] * 100 / analyzed[side] << "%), "
+		   << lost[side] << " game points lost\n";
+	}
+	return os.str();
+}
@@ -189,6 +189,9 @@ void Selector::draw()
 #include "CardImage.cxx"
 #include "Card.cxx"
 #include "Util.cxx"
+#include "Config.cxx"
+#include "Log.cxx"
+#include "Trace.cxx"
 int main()
 {
 	Util::load_config();
@@ -0,0 +1,199 @@
+//
+// Part of "Schnapsen for 2" card game.
+//
+// (c) 2026 Christian Grabner
+//
+// Headless engine vs. engine games.
+//
+
+#include "SelfPlay.h"
+#include "Util.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+using enum Player;
+using enum CardState;
+using enum Closed;
+using enum Marriage;
+
+SelfPlay::SelfPlay(const EngineParams &player_, const EngineParams &ai_, int strictness_/* = 0*/) :
+	_player_engine(_game, _ai, _player, _ui),
+	_ai_engine(_game, _player, _ai, _ui),
+	_strictness(strictness_)
+{
+	_player_engine.params(player_);
+	_ai_engine.params(ai_);
+}
+
+void SelfPlay::mirror()
+{
+	// switch view between the two engines
+	_game.move = _game.move == PLAYER ? AI : PLAYER;
+	if (_game.closed == BY_PLAYER) _game.closed = BY_AI;
+	else if (_game.closed == BY_AI) _game.closed = BY_PLAYER;
+}
+
+void SelfPlay::deal()
+{
+	// same order as Deck::deal()
+	PlayerData &first = _game.move == PLAYER ? _player : _ai;
+	PlayerData &second = _game.move == PLAYER ? _ai : _player;
+	auto give = [&](PlayerData &player_, size_t n_)
+	{
+		for (size_t i = 0; i < n_; i++)
+		{
+			player_.cards.push_front(_game.cards.front());
+			_game.cards.pop_front();
+		}
+	};
+	give(first, 3);
+	give(second, 3);
+	Card trump = _game.cards.front();
+	_game.cards.pop_front();
+	_game.cards.push_back(trump);
+	_game.trump = trump.suite();
+	give(first, 2);
+	give(second, 2);
+	_ai_engine.sort_cards(_player.cards)
+	          .sort_cards(_ai.cards);
+}
+
+void SelfPlay::fillup_cards()
+{
+	// same order as Deck::fillup_cards(): winner of trick draws first
+	if (_game.closed != NOT || _player.cards.size() >= 5 || _ai.cards.size() >= 5) return;
+	_log.add(GameLog::Type::DRAW, _game.move);
+	PlayerData &first = _game.move == PLAYER ? _player : _ai;
+	PlayerData &second = _game.move == PLAYER ? _ai : _player;
+	for (PlayerData *p : { &first, &second })
+	{
+		if (_game.cards.empty()) break;
+		p->last_drawn = _game.cards.front();
+		p->cards.push_front(_game.cards.front());
+		_game.cards.pop_front();
+	}
+	_ai_engine.sort_cards(_player.cards)
+	          .sort_cards(_ai.cards);
+	if (_game.cards.empty())
+		_game.closed = AUTO;
+}
+
+void SelfPlay::move(Player side_)
+{
+	(side_ == PLAYER ? _player : _ai).move_state = MOVING;
+	Card trump_card = _game.cards.size() ? _game.cards.back() : Card();
+	Closed closed = _game.closed;
+	if (side_ == AI)
+	{
+		_ai_engine.ai_move();
+		_stats.add(_ai_engine.decision());
+	}
+	else
+	{
+		mirror();
+		_player_engine.ai_move();
+		_stats.add(_player_engine.decision());
+		mirror();
+	}
+	_log.add_move(side_, trump_card, closed, _game, side_ == PLAYER ? _player : _ai);
+}
+
+void SelfPlay::check_trick(Player lead_)
+{
+	// both engines gain their information from the trick
+	_game.marriage = NO_MARRIAGE;
+	_log.add(GameLog::Type::TRICK, lead_);
+	mirror();
+	_player_engine.check_trick(lead_ == PLAYER ? AI : PLAYER);
+	mirror();
+	_ai_engine.check_trick(lead_);
+	_ai_engine.score_trick();
+}
+
+std::pair<int, int> SelfPlay::game(uint64_t seed_, Player first_)
+{
+	//
+	// Play one game, return game points (player, ai).
+	//
+	Util::quiet() = true;
+	_game = GameData();
+	_player = PlayerData();
+	_ai = PlayerData();
+	_player_engine.init();
+	_ai_engine.init();
+	_game.cards = Cards::fullcards();
+	std::mt19937_64 gen(seed_);
+	std::shuffle(_game.cards.begin(), _game.cards.end(), gen);
+	_game.move = first_;
+	deal();
+	_log.start(_game, _player, _ai);
+
+	while (_player.cards.size() || _ai.cards.size())
+	{
+		Player side = _game.move;
+		move(side);
+		if (_ai_engine.test_end() != Result::NO_WIN) break; // enough from 20/40
+		PlayerData &opponent = side == PLAYER ? _ai : _player;
+		if (opponent.move_state == ON_TABLE)
+		{
+			check_trick(side == PLAYER ? AI : PLAYER);
+			if (_ai_engine.test_end() != Result::NO_WIN) break;
+			fillup_cards();
+		}
+		else
+		{
+			_game.move = side == PLAYER ? AI : PLAYER;
+		}
+	}
+	return _ai_engine.game_points(_strictness);
+}
+
+/*static*/
+SelfPlay::Match SelfPlay::match(const EngineParams &a_, const EngineParams &b_, size_t deals_,
+                                uint64_t seed_/* = 0*/, int strictness_/* = 0*/)
+{
+	//
+	// Play each deal twice with swapped sides (less variance),
+	// distributed over all cores.
+	//
+	Match res;
+	std::mutex mutex;
+	std::atomic<size_t> next(0);
+	auto worker = [&]()
+	{
+		SelfPlay ab(a_, b_, strictness_);
+		SelfPlay ba(b_, a_, strictness_);
+		Match m;
+		for (size_t i = next++; i < deals_; i = next++)
+		{
+			Player first = i % 2 ? AI : PLAYER;
+			auto [a1, b1] = ab.game(seed_ + i, first);
+			auto [b2, a2] = ba.game(seed_ + i, first);
+			m.points[0] += a1 + a2;
+			m.points[1] += b1 + b2;
+			m.games_won[0] += (a1 > 0) + (a2 > 0);
+			m.games_won[1] += (b1 > 0) + (b2 > 0);
+			m.deals++;
+		}
+		std::lock_guard<std::mutex> lock(mutex);
+		res.deals += m.deals;
+		res.stats.merge(ab.stats());
+		res.stats.merge(ba.stats());
+		for (int i = 0; i < 2; i++)
+		{
+			res.points[i] += m.points[i];
+			res.games_won[i] += m.games_won[i];
+		}
+	};
+	size_t workers = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), deals_);
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < workers; i++)
+		threads.emplace_back(worker);
+	for (auto &t : threads)
+		t.join();
+	return res;
+}
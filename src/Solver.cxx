@@ -0,0 +1,200 @@
+//
+// Part of "Schnapsen for 2" card game.
+//
+// (c) 2026 Christian Grabner
+//
+// Exact solver for end game positions (closed or pack exhausted).
+//
+#include "Solver.h"
+#include <algorithm>
+#include <bit>
+
+/*static*/
+Solver::Position Solver::position(const GameData &game_, const PlayerData &player_, const PlayerData &ai_)
+{
+	//
+	// Build solver position from game state. If the card of the
+	// side to move is already on table, the position *before* that
+	// move is returned (card back in hand, declared 20/40 undone).
+	//
+	Position pos{};
+	const PlayerData *pd[2] = { &player_, &ai_ };
+	for (int i = 0; i < 2; i++)
+	{
+		for (auto &c : pd[i]->cards)
+			pos.hand[i] |= 1u << index(c);
+		pos.score[i] = pd[i]->score;
+		pos.score_closed[i] = pd[i]->score_closed;
+		pos.pending[i] = pd[i]->pending;
+		pos.tricks[i] = !pd[i]->deck.empty();
+	}
+	pos.trump = game_.trump;
+	pos.closed = game_.closed;
+	pos.move = game_.move;
+	pos.table = -1;
+
+	int me = (int)game_.move;
+	const PlayerData &mover = *pd[me];
+	const PlayerData &opponent = *pd[1 - me];
+	if (opponent.move_state == CardState::ON_TABLE)
+		pos.table = index(opponent.card);
+	if (mover.move_state == CardState::ON_TABLE)
+	{
+		pos.hand[me] |= 1u << index(mover.card);
+		if (game_.marriage != Marriage::NO_MARRIAGE)
+		{
+			int score = game_.marriage == Marriage::MARRIAGE_40 ? 40 : 20;
+			(pos.tricks[me] ? pos.score[me] : pos.pending[me]) -= score;
+		}
+	}
+	return pos;
+}
+
+uint32_t Solver::legal_moves(const Position &pos_) const
+{
+	//
+	// Same rules as Engine::legal_moves() (closed state)
+	//
+	uint32_t hand = pos_.hand[(int)pos_.move];
+	if (pos_.table < 0) return hand;
+
+	CardSuite suite = CardSuite(pos_.table / 5);
+	uint32_t same = hand & suite_mask(suite);
+	uint32_t higher = 0;
+	for (uint32_t m = same; m; m &= m - 1)
+	{
+		int c = std::countr_zero(m);
+		if (value(c) > value(pos_.table))
+			higher |= 1u << c;
+	}
+	if (higher) return higher;
+	if (same) return same;
+	uint32_t trumps = hand & suite_mask(pos_.trump);
+	return trumps ? trumps : hand;
+}
+
+int Solver::result(const Position &pos_) const
+{
+	//
+	// Same rules as Deck::test_end() / Deck::update_gamebook().
+	// Returns game points (> 0 PLAYER wins, < 0 AI wins) or 0
+	// if game is not decided yet.
+	//
+	auto points = [](int score_) { return score_ < 33 ? score_ == 0 ? 3 : 2 : 1; };
+
+	int me = (int)pos_.move;
+	bool no_cards_in_play = !pos_.hand[0] && !pos_.hand[1] && pos_.table < 0;
+	int winner = -1;
+	int score = 0;
+	if (pos_.closed == Closed::NOT || pos_.closed == Closed::AUTO)
+	{
+		if (pos_.score[me] >= 66 || no_cards_in_play)
+		{
+			winner = me;
+			score = points(pos_.score[1 - me]);
+		}
+	}
+	else
+	{
+		int closer = pos_.closed == Closed::BY_PLAYER ? 0 : 1;
+		if (me == closer && pos_.score[me] >= 66)
+		{
+			winner = closer;
+			score = points(_strictness >= 1 ? pos_.score_closed[1 - me] : pos_.score[1 - me]);
+		}
+		else if (no_cards_in_play)
+		{
+			winner = 1 - closer;
+			score = pos_.score[closer] < 33 ? points(pos_.score[closer]) : 2;
+		}
+	}
+	if (winner < 0) return 0;
+	return winner == (int)Player::PLAYER ? score : -score;
+}
+
+int Solver::play(const Position &pos_, int card_, int alpha_, int beta_) const
+{
+	Position pos(pos_);
+	int me = (int)pos.move;
+	pos.hand[me] &= ~(1u << card_);
+	if (pos.table < 0)
+	{
+		// lead - declare 20/40 if possible
+		int face = card_ % 5;
+		if (face == (int)CardFace::QUEEN || face == (int)CardFace::KING)
+		{
+			int partner = card_ - face + (face == (int)CardFace::QUEEN ? (int)CardFace::KING : (int)CardFace::QUEEN);
+			if (pos.hand[me] & (1u << partner))
+			{
+				int score = CardSuite(card_ / 5) == pos.trump ? 40 : 20;
+				(pos.tricks[me] ? pos.score[me] : pos.pending[me]) += score;
+				if (int res = result(pos)) return res; // enough from 20/40
+			}
+		}
+		pos.table = card_;
+		pos.move = Player(1 - me);
+		return search(pos, alpha_, beta_);
+	}
+
+	// follow - trick is decided
+	int lead = pos.table;
+	bool tricks = (card_ / 5 == lead / 5 && value(card_) > value(lead)) ||
+	              (card_ / 5 != lead / 5 && CardSuite(card_ / 5) == pos.trump);
+	int winner = tricks ? me : 1 - me;
+	pos.score[winner] += value(card_) + value(lead) + pos.pending[winner];
+	pos.pending[winner] = 0;
+	pos.tricks[winner] = true;
+	pos.table = -1;
+	pos.move = Player(winner);
+	if (int res = result(pos)) return res;
+	return search(pos, alpha_, beta_);
+}
+
+int Solver::search(const Position &pos_, int alpha_, int beta_) const
+{
+	//
+	// Alpha-beta search, value from view of PLAYER.
+	//
+	_nodes++;
+	bool maximize = pos_.move == Player::PLAYER;
+	int best = maximize ? -4 : 4;
+	uint32_t moves = legal_moves(pos_);
+	for (uint32_t m = moves; m; m &= m - 1)
+	{
+		int res = play(pos_, std::countr_zero(m), alpha_, beta_);
+		if (maximize)
+		{
+			best = std::max(best, res);
+			alpha_ = std::max(alpha_, res);
+		}
+		else
+		{
+			best = std::min(best, res);
+			beta_ = std::min(beta_, res);
+		}
+		if (alpha_ >= beta_) break;
+	}
+	return best;
+}
+
+std::vector<std::pair<int, int>> Solver::evaluate(const Position &pos_) const
+{
+	//
+	// Exact value of each legal move for the side to move.
+	//
+	std::vector<std::pair<int, int>> res;
+	int sign = pos_.move == Player::PLAYER ? 1 : -1;
+	uint32_t moves = legal_moves(pos_);
+	for (uint32_t m = moves; m; m &= m - 1)
+	{
+		int c = std::countr_zero(m);
+		res.emplace_back(c, sign * play(pos_, c, -4, 4));
+	}
+	return res;
+}
+
+int Solver::solve(const Position &pos_) const
+{
+	int sign = pos_.move == Player::PLAYER ? 1 : -1;
+	return sign * search(pos_, -4, 4);
+}
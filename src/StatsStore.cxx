@@ -0,0 +1,192 @@
+//
+// Part of "Schnapsen for 2" card game.
+//
+// (c) 2026 Christian Grabner
+//
+// Journaled statistics store.
+//
+
+#include "StatsStore.h"
+#include "Util.h"
+#include "debug.h"
+#include <filesystem>
+#include <sstream>
+
+StatsStore::StatsStore(const std::string &name_) :
+	_name(name_),
+	_counters{},
+	_generation(0),
+	_journal_size(0)
+{
+}
+
+/*static*/
+const char *StatsStore::name(Counter counter_)
+{
+	static const char *names[] = { "player_games_won", "ai_games_won", "player_matches_won", "ai_matches_won" };
+	return names[counter_];
+}
+
+/*static*/
+std::string StatsStore::to_string(const Gamebook &gamebook_)
+{
+	std::ostringstream os;
+	for (auto &[player, ai] : gamebook_)
+		os << (os.tellp() ? "," : "") << player << " " << ai;
+	return os.str();
+}
+
+/*static*/
+StatsStore::Gamebook StatsStore::to_gamebook(const std::string &str_)
+{
+	std::istringstream is(str_);
+	Gamebook res;
+	int player = -1;
+	int ai = -1;
+	char c;
+	while (is >> player >> ai)
+	{
+		if (player < 0 || ai < 0) break;
+		res.emplace_back(player, ai);
+		if (!(is >> c) || c != ',') break;
+	}
+	return res;
+}
+
+bool StatsStore::apply(const std::string &line_)
+{
+	// journal entry "<counter>+=<n>" or "gamebook+=<gamebook>"
+	size_t pos = line_.find("+=");
+	if (pos == std::string::npos) return false;
+	std::string id = line_.substr(0, pos);
+	std::string value = line_.substr(pos + 2);
+	if (id == "gamebook")
+	{
+		Gamebook gamebook = to_gamebook(value);
+		if (gamebook.empty()) return false;
+		_gamebooks.push_back(gamebook);
+		if (_gamebooks.size() > GAMEBOOKS)
+			_gamebooks.pop_front();
+		return true;
+	}
+	for (int i = 0; i < COUNTERS; i++)
+	{
+		if (id != name(Counter(i))) continue;
+		_counters[i] += atoll(value.c_str());
+		return true;
+	}
+	return false;
+}
+
+bool StatsStore::load()
+{
+	TRACE("StatsStore::load");
+	//
+	// Snapshot (same format as former .sta file) plus journal
+	// of its generation.
+	//
+	string_map values;
+	std::ifstream ifs(_name);
+	Util::load_values_from_file(ifs, values, "stat");
+	for (int i = 0; i < COUNTERS; i++)
+		_counters[i] = atoll(values[name(Counter(i))].c_str());
+	_gamebooks.clear();
+	std::istringstream gamebooks(values["gamebook"]);
+	std::string gb;
+	while (std::getline(gamebooks, gb, ';'))
+	{
+		Gamebook gamebook = to_gamebook(gb);
+		if (gamebook.size())
+			_gamebooks.push_back(gamebook);
+		if (_gamebooks.size() > GAMEBOOKS)
+			_gamebooks.pop_front();
+	}
+	_generation = strtoull(values["generation"].c_str(), nullptr, 10);
+
+	// journal of previous generation is obsolete (compaction interrupted)
+	std::error_code ec;
+	if (_generation)
+		std::filesystem::remove(_name + "." + std::to_string(_generation - 1), ec);
+
+	_journal_size = 0;
+	std::ifstream journal_file(journal());
+	std::string line;
+	while (std::getline(journal_file, line))
+	{
+		// an incomplete last line is from an interrupted write
+		if (journal_file.eof()) break;
+		if (apply(line))
+			_journal_size++;
+		else
+			WNG("Invalid stats journal entry '" << line << "'");
+	}
+	DBG("[load stat] " << _journal_size << " journal entries\n");
+	if (_journal_size >= COMPACT)
+		compact();
+	return true;
+}
+
+bool StatsStore::compact()
+{
+	TRACE("StatsStore::compact");
+	//
+	// Write new snapshot to a temp. file and rename it (atomic),
+	// then the journal of the old generation can be removed.
+	//
+	std::string tmp = _name + ".tmp";
+	{
+		std::ofstream ofs(tmp, std::ios::binary);
+		for (int i = 0; i < COUNTERS; i++)
+			ofs << name(Counter(i)) << "=" << _counters[i] << "\n";
+		std::string gamebooks;
+		for (auto &gamebook : _gamebooks)
+			gamebooks += (gamebooks.size() ? ";" : "") + to_string(gamebook);
+		if (gamebooks.size())
+			ofs << "gamebook=" << gamebooks << "\n";
+		ofs << "generation=" << _generation + 1 << "\n";
+		ofs.flush();
+		if (!ofs.good())
+		{
+			WNG("Can't write statistics file '" << tmp << "'!");
+			return false;
+		}
+	}
+	std::error_code ec;
+	std::filesystem::rename(tmp, _name, ec);
+	if (ec)
+	{
+		WNG("Can't replace statistics file '" << _name << "': " << ec.message());
+		return false;
+	}
+	std::filesystem::remove(journal(), ec);
+	_generation++;
+	_journal_size = 0;
+	return true;
+}
+
+void StatsStore::append(const std::string &line_)
+{
+	TRACE("StatsStore::append");
+	std::ofstream ofs(journal(), std::ios::binary | std::ios::app);
+	ofs << line_ << "\n";
+	ofs.flush();
+	if (!ofs.good())
+		WNG("Can't write statistics journal '" << journal() << "'!");
+	if (++_journal_size >= COMPACT)
+		compact();
+}
+
+void StatsStore::add(Counter counter_, int64_t n_/* = 1*/)
+{
+	_counters[counter_] += n_;
+	append(std::string(name(counter_)) + "+=" + std::to_string(n_));
+}
+
+void StatsStore::add(const Gamebook &gamebook_)
+{
+	if (gamebook_.empty()) return;
+	_gamebooks.push_back(gamebook_);
+	if (_gamebooks.size() > GAMEBOOKS)
+		_gamebooks.pop_front();
+	append("gamebook+=" + to_string(gamebook_));
+}
@@ -0,0 +1,213 @@
+//
+// Part of "Schnapsen for 2" card game.
+//
+// (c) 2026 Christian Grabner
+//
+// Regression suite runner for the engine.
+//
+// Build the standalone runner with:
+//   make Suite
+// Run with:
+//   ./Suite [directory] [-b]
+// Option -b saves the results as new baseline ('suite.base').
+// The exit code is the number of regressions against the baseline.
+//
+
+#ifdef STANDALONE
+constexpr char APPLICATION[] = "fltk-schnapsen";
+#include "debug.h"
+#endif
+
+#include "Suite.h"
+#include "UI.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <sstream>
+#include <thread>
+
+using enum Player;
+using enum CardState;
+using enum Closed;
+
+size_t Suite::load(const std::string &dir_)
+{
+	std::vector<std::string> files;
+	for (auto const &dir_entry : std::filesystem::directory_iterator(dir_))
+	{
+		if (dir_entry.path().extension() == ".scg")
+			files.push_back(dir_entry.path().string());
+	}
+	std::sort(files.begin(), files.end());
+	for (auto &f : files)
+	{
+		SuiteEntry e;
+		e.name = Util::filename(f);
+		if (!GameFile::load(f, e.game, e.player, e.ai, &e.annotation)) continue;
+		if (e.annotation.best.empty() && e.annotation.avoid.empty())
+		{
+			WNG("No best_move/avoid_move in '" << f << "'");
+			continue;
+		}
+		if (e.game.move == PLAYER)
+		{
+			// engine always plays AI side: mirror position
+			std::swap(e.player, e.ai);
+			e.game.move = AI;
+			if (e.game.closed == BY_PLAYER) e.game.closed = BY_AI;
+			else if (e.game.closed == BY_AI) e.game.closed = BY_PLAYER;
+		}
+		_entries.push_back(e);
+	}
+	return _entries.size();
+}
+
+SuiteResult Suite::run(const SuiteEntry &entry_) const
+{
+	//
+	// Let engine find its move (best time of some runs).
+	//
+	SuiteResult res;
+	res.us = 1e9;
+	for (int i = 0; i < 5; i++)
+	{
+		GameData game(entry_.game);
+		PlayerData player(entry_.player);
+		PlayerData ai(entry_.ai);
+		UI ui;
+		Engine engine(game, player, ai, ui);
+		engine.params(_params);
+		ai.move_state = MOVING;
+		auto start = std::chrono::steady_clock::now();
+		engine.ai_move();
+		std::chrono::duration<double, std::micro> diff = std::chrono::steady_clock::now() - start;
+		res.us = std::min(res.us, diff.count());
+		res.move = ai.card;
+		res.decision = engine.decision();
+	}
+	const Annotation &a = entry_.annotation;
+	res.passed = (a.best.empty() || a.best.find(res.move)) && !a.avoid.find(res.move);
+	return res;
+}
+
+std::vector<SuiteResult> Suite::run() const
+{
+	std::vector<SuiteResult> results(_entries.size());
+	std::atomic<size_t> next(0);
+	auto worker = [&]()
+	{
+		Util::quiet() = true;
+		for (size_t i = next++; i < _entries.size(); i = next++)
+			results[i] = run(_entries[i]);
+	};
+	size_t workers = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), _entries.size());
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < workers; i++)
+		threads.emplace_back(worker);
+	for (auto &t : threads)
+		t.join();
+	return results;
+}
+
+std::string Suite::report(const std::vector<SuiteResult> &results_, const string_map &baseline_,
+                          int *regressions_/* = nullptr*/) const
+{
+	std::ostringstream os;
+	int passed = 0;
+	int regressions = 0;
+	int fixed = 0;
+	EngineStats stats;
+	double total_us = 0;
+	double max_us = 0;
+	for (size_t i = 0; i < _entries.size(); i++)
+	{
+		const SuiteEntry &e = _entries[i];
+		const SuiteResult &r = results_[i];
+		passed += r.passed;
+		total_us += r.us;
+		max_us = std::max(max_us, r.us);
+		stats.add(r.decision);
+		os << e.name << "\t";
+		r.move.printOn(os) << "\t" << (r.passed ? "ok" : "FAIL") << "\t" << (int)r.us << "us\t" << r.decision.branch;
+		auto it = baseline_.find(e.name);
+		if (it != baseline_.end())
+		{
+			bool was_passed = it->second == "1";
+			if (was_passed && !r.passed)
+			{
+				regressions++;
+				os << "\tREGRESSION";
+			}
+			else if (!was_passed && r.passed)
+			{
+				fixed++;
+				os << "\tfixed";
+			}
+		}
+		os << "\n";
+	}
+	if (_entries.size())
+	{
+		os << "passed " << passed << "/" << _entries.size() << " (" << passed * 100 / _entries.size() << "%), "
+		   << regressions << " regressions, " << fixed << " fixed, "
+		   << (int)(total_us / _entries.size()) << "us avg, " << (int)max_us << "us max\n";
+		os << stats.to_string();
+	}
+	if (regressions_) *regressions_ = regressions;
+	return os.str();
+}
+
+string_map Suite::baseline(const std::vector<SuiteResult> &results_) const
+{
+	string_map res;
+	for (size_t i = 0; i < _entries.size(); i++)
+		res[_entries[i].name] = results_[i].passed ? "1" : "0";
+	return res;
+}
+
+#ifdef STANDALONE
+#undef STANDALONE
+namespace Schnapsen
+{
+	int debug = 0;
+};
+#include "Util.cxx"
+#include "Config.cxx"
+#include "Log.cxx"
+#include "Trace.cxx"
+#include "Card.cxx"
+#include "CardImage.cxx"
+#include "Cards.cxx"
+#include "Solver.cxx"
+#include "EngineParams.cxx"
+#include "EngineStats.cxx"
+#include "Engine.cxx"
+#include "GameFile.cxx"
+int main(int argc_, char *argv_[])
+{
+	std::string dir = argc_ > 1 && argv_[1][0] != '-' ? argv_[1] : "suite";
+	bool save = argc_ > 1 && std::string(argv_[argc_ - 1]) == "-b";
+	Suite suite;
+	if (!suite.load(dir))
+	{
+		WNG("No positions in '" << dir << "'");
+		return EXIT_FAILURE;
+	}
+	std::vector<SuiteResult> results = suite.run();
+
+	std::string base_file = dir + "/suite.base";
+	string_map baseline;
+	std::ifstream ifs(base_file);
+	Util::load_values_from_file(ifs, baseline, "base");
+	int regressions = 0;
+	OUT(suite.report(results, baseline, &regressions));
+	if (save)
+	{
+		std::ofstream ofs(base_file, std::ios::binary);
+		Util::save_values_to_file(ofs, suite.baseline(results), "base");
+		OUT("baseline saved to '" << base_file << "'\n");
+	}
+	return regressions;
+}
+#endif
@@ -0,0 +1,108 @@
+//
+// Part of "Schnapsen for 2" card game.
+//
+// (c) 2026 Christian Grabner
+//
+// Event tracing (Chrome trace format).
+//
+
+#include "Trace.h"
+#include "debug.h"
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+
+namespace {
+
+std::mutex trace_mutex;
+std::ofstream trace_ofs;
+int64_t trace_origin = 0;
+
+int trace_tid()
+{
+	// small thread numbers instead of system thread ids
+	static std::atomic<int> next = 0;
+	static thread_local int tid = ++next;
+	return tid;
+}
+
+std::string trace_escape(const std::string &str_)
+{
+	std::string res;
+	for (char c : str_)
+	{
+		if (c == '"' || c == '\\')
+			res.push_back('\\');
+		if ((unsigned char)c < ' ')
+			continue;
+		res.push_back(c);
+	}
+	return res;
+}
+
+}; // namespace
+
+/*static*/
+bool Trace::start(const std::string &file_)
+{
+	//
+	// The events are streamed, a missing closing ']' (e.g. after
+	// a crash) is accepted by the trace viewers.
+	//
+	std::lock_guard<std::mutex> lock(trace_mutex);
+	if (enabled()) return true;
+	trace_ofs.open(file_, std::ios::binary);
+	if (!trace_ofs.is_open())
+	{
+		WNG("Can't write trace file '" << file_ << "'!");
+		return false;
+	}
+	trace_ofs << "[\n";
+	trace_ofs << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"" << APPLICATION << "\"}}";
+	trace_origin = now();
+	_enabled.store(true, std::memory_order_relaxed);
+	std::atexit(stop);
+	LOG("Tracing to '" << file_ << "'\n");
+	return true;
+}
+
+/*static*/
+void Trace::stop()
+{
+	std::lock_guard<std::mutex> lock(trace_mutex);
+	if (!enabled()) return;
+	_enabled.store(false, std::memory_order_relaxed);
+	trace_ofs << "\n]\n";
+	trace_ofs.close();
+}
+
+/*static*/
+void Trace::write(const char *ph_, const char *name_, int64_t ts_, int64_t dur_, const std::string &detail_)
+{
+	int tid = trace_tid();
+	std::lock_guard<std::mutex> lock(trace_mutex);
+	if (!enabled()) return;
+	trace_ofs << ",\n{\"name\":\"" << name_ << "\",\"ph\":\"" << ph_ << "\",\"pid\":1,\"tid\":" << tid
+	          << ",\"ts\":" << ts_ - trace_origin;
+	if (*ph_ == 'X')
+		trace_ofs << ",\"dur\":" << dur_;
+	else
+		trace_ofs << ",\"s\":\"t\"";
+	if (detail_.size())
+		trace_ofs << ",\"args\":{\"detail\":\"" << trace_escape(detail_) << "\"}";
+	trace_ofs << "}";
+}
+
+/*static*/
+void Trace::end(const char *name_, int64_t start_, const std::string &detail_)
+{
+	write("X", name_, start_, now() - start_, detail_);
+}
+
+/*static*/
+void Trace::instant(const char *name_)
+{
+	if (enabled())
+		write("i", name_, now(), 0, std::string());
+}
@@ -0,0 +1,127 @@
+//
+// Part of "Schnapsen for 2" card game.
+//
+// (c) 2026 Christian Grabner
+//
+// Self play parameter tuning (SPSA).
+//
+// Build the standalone tuner with:
+//   make Tuner
+// Run with:
+//   ./Tuner [iterations] [deals per match]
+// An improved profile is written to the config file of the game.
+//
+
+#ifdef STANDALONE
+constexpr char APPLICATION[] = "fltk-schnapsen";	// use config file of game
+#include "debug.h"
+#endif
+
+#include "Tuner.h"
+#include "SelfPlay.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+EngineParams Tuner::params(const std::vector<double> &theta_) const
+{
+	// map normalized parameter vector [0..1] to parameter values
+	EngineParams params(_base);
+	const auto &list = EngineParams::list();
+	for (size_t i = 0; i < list.size(); i++)
+		params.*list[i].value = list[i].min + (int)std::lround(theta_[i] * (list[i].max - list[i].min));
+	return params;
+}
+
+EngineParams Tuner::run(int iterations_, uint64_t seed_/* = 1*/)
+{
+	//
+	// SPSA: all parameters are perturbed at once by +/- c and the
+	// gradient is estimated from just two matches (against the base
+	// profile, both playing the same deals).
+	//
+	const auto &list = EngineParams::list();
+	std::vector<double> theta;
+	for (auto &p : list)
+		theta.push_back((double)(_base.*p.value - p.min) / (p.max - p.min));
+
+	const double a = 0.05;
+	const double c = 0.1;
+	const double A = iterations_ / 10. + 1;
+	std::mt19937_64 gen(seed_);
+	for (int k = 0; k < iterations_; k++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		double ak = a / std::pow(k + 1 + A, 0.602);
+		double ck = c / std::pow(k + 1, 0.101);
+		std::vector<double> ci(theta.size());
+		std::vector<double> delta(theta.size());
+		std::vector<double> plus(theta);
+		std::vector<double> minus(theta);
+		for (size_t i = 0; i < theta.size(); i++)
+		{
+			delta[i] = gen() & 1 ? 1. : -1.;
+			ci[i] = std::max(ck, 1. / (list[i].max - list[i].min)); // at least one step
+			plus[i] = std::clamp(theta[i] + ci[i] * delta[i], 0., 1.);
+			minus[i] = std::clamp(theta[i] - ci[i] * delta[i], 0., 1.);
+		}
+		uint64_t seed = gen();
+		double f_plus = SelfPlay::match(params(plus), _base, _deals, seed, _strictness).score();
+		double f_minus = SelfPlay::match(params(minus), _base, _deals, seed, _strictness).score();
+		for (size_t i = 0; i < theta.size(); i++)
+		{
+			double g = (f_plus - f_minus) / (2 * ci[i] * delta[i]);
+			theta[i] = std::clamp(theta[i] + ak * g, 0., 1.);
+		}
+		std::chrono::duration<double> diff = std::chrono::steady_clock::now() - start;
+		OUT("[" << k + 1 << "/" << iterations_ << "] " << f_plus << " / " << f_minus
+		    << " (" << diff.count() << "s): " << params(theta).to_string() << "\n");
+	}
+	return params(theta);
+}
+
+#ifdef STANDALONE
+#undef STANDALONE
+namespace Schnapsen
+{
+	int debug = 0;
+};
+#include "Util.cxx"
+#include "Config.cxx"
+#include "Log.cxx"
+#include "Trace.cxx"
+#include "Card.cxx"
+#include "CardImage.cxx"
+#include "Cards.cxx"
+#include "Solver.cxx"
+#include "EngineParams.cxx"
+#include "EngineStats.cxx"
+#include "Engine.cxx"
+#include "GameLog.cxx"
+#include "SelfPlay.cxx"
+int main(int argc_, char *argv_[])
+{
+	int iterations = argc_ > 1 ? atoi(argv_[1]) : 100;
+	size_t deals = argc_ > 2 ? atoi(argv_[2]) : 1000;
+	Util::load_config();
+	EngineParams base(Util::config());
+	OUT("base: " << base.to_string() << "\n");
+	Tuner tuner(base, deals, Config::as_int(Config::STRICT));
+	EngineParams best = tuner.run(iterations);
+
+	// verify with independent deals
+	SelfPlay::Match m = SelfPlay::match(best, base, deals * 4, 0x5eed, Config::as_int(Config::STRICT));
+	OUT("best: " << best.to_string() << "\n");
+	OUT("game points " << m.points[0] << " : " << m.points[1] << " (" << m.score() << " per game)\n");
+	OUT(m.stats.to_string());
+	if (m.score() > 0 && !(best == base))
+	{
+		best.save(Util::config());
+		Util::save_config();
+		OUT("profile written to " << Util::cfg_file() << "\n");
+	}
+}
+#endif
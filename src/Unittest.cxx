@@ -3,7 +3,14 @@
 //
 // (c) 2026 Christian Grabner
 //
-// Make some basic "unit tests".
+// Unit tests, randomized property tests and benchmarks
+// of the engine primitives.
+//
+// Build the standalone test executable with:
+//   make Unittest
+// Run with:
+//   ./Unittest [iterations] [-b]
+// Option -b runs the benchmarks. The exit code is 0 if all tests pass.
 //
 
 #ifdef STANDALONE
@@ -13,10 +20,33 @@ constexpr char APPLICATION[] = "Unittest";
 
 #include "Unittest.h"
 #include "Engine.h"
+#include "Solver.h"
+#include "SelfPlay.h"
+#include "GameLog.h"
+#include "GameRecord.h"
+#include "GameIndex.h"
+#include "GameFlow.h"
+#include "StatsStore.h"
 #include "Cards.h"
 #include "Card.h"
+#include "CardImage.h"
+#include "Animator.h"
+#include "Flow.h"
+#include "Log.h"
+#include "AnimText.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
 
-#include <cassert>
+// unlike assert() also active in release builds
+#define CHECK(expr_) check((expr_), #expr_, __LINE__)
 
 using enum Player;
 using enum CardState;
@@ -27,6 +57,65 @@ using enum Marriage;
 using enum CardSuite;
 using enum CardFace;
 
+namespace
+{
+	//
+	// UI without a window for GameFlow: delays advance a virtual
+	// clock and suspend on an injected resumer, the player plays
+	// the first valid card.
+	//
+	class HeadlessUI : public UI
+	{
+	public:
+		HeadlessUI(Flow::Resumer &resumer_, GameData &game_, PlayerData &player_, PlayerData &ai_) :
+			_resumer(resumer_), _game(game_), _player(player_), _ai(ai_),
+			_engine(game_, player_, ai_, *this), _clock(0.), _tricks(0), _winner(NO_WINNER)
+		{
+		}
+		Engine &engine() { return _engine; }
+		double clock() const { return _clock; }
+		size_t tricks() const { return _tricks; }
+		int winner() const { return _winner; }
+		void animate_trick() override { _tricks++; }
+		void game_won(Player winner_) override { _winner = (int)winner_; }
+		Flow::Task<> delay(double s_) override
+		{
+			_clock += s_;
+			co_await _resumer.wait();
+		}
+		Flow::Task<bool> player_move() override
+		{
+			co_await delay(1.);
+			Cards valid = _game.closed != NOT && _ai.move_state == ON_TABLE ?
+				_engine.legal_moves(_player.cards, _ai.card) : _player.cards;
+			_player.card = valid[0];
+			_player.cards.erase(_player.cards.begin() + _player.cards.find_pos(_player.card).value());
+			_player.move_state = ON_TABLE;
+			co_return true;
+		}
+		static constexpr int NO_WINNER = -1;
+	private:
+		Flow::Resumer &_resumer;
+		GameData &_game;
+		PlayerData &_player;
+		PlayerData &_ai;
+		Engine _engine;
+		double _clock;
+		size_t _tricks;
+		int _winner;
+	};
+}; // namespace
+
+bool Unittest::check(bool ok_, const char *expr_, int line_)
+{
+	if (!ok_)
+	{
+		_failed++;
+		WNG("FAILED (line " << line_ << "): " << expr_);
+	}
+	return ok_;
+}
+
 bool Unittest::run()
 {
 	CardSuite trump = _game.trump;
@@ -37,36 +126,36 @@ bool Unittest::run()
 	temp.push_front(Card(TEN, CLUB));
 	temp.push_front(Card(ACE, SPADE));
 	Card c(ACE, CLUB);
-	assert(_engine.can_trick_with_suite(c, temp) == false);
-	assert(_engine.can_trick(c, temp) == true);
+	CHECK(_engine.can_trick_with_suite(c, temp) == false);
+	CHECK(_engine.can_trick(c, temp) == true);
 	Cards res(_game.cards);
 	res += _game.cards;
-	assert(res.size() == 40);
+	CHECK(res.size() == 40);
 	res -= _game.cards;
-	assert(res.size() == 20);
+	CHECK(res.size() == 20);
 	res = _game.cards + _game.cards;
-	assert(res.size() == 40);
+	CHECK(res.size() == 40);
 	Cards c2("|Q♠|K♥|");
 	res = _game.cards - c2;
-	assert(res.size() == 18);
+	CHECK(res.size() == 18);
 	temp = "|K♣|Q♣|T♣|K♥|A♠|";
 	temp.sort();
-	assert(temp[0] == Card(ACE, SPADE));
-	assert(temp[1] == Card(KING, HEART));
-	assert(temp[2] == Card(TEN, CLUB));
-	assert(temp[3] == Card(KING, CLUB));
-	assert(temp[4] == Card(QUEEN, CLUB));
+	CHECK(temp[0] == Card(ACE, SPADE));
+	CHECK(temp[1] == Card(KING, HEART));
+	CHECK(temp[2] == Card(TEN, CLUB));
+	CHECK(temp[3] == Card(KING, CLUB));
+	CHECK(temp[4] == Card(QUEEN, CLUB));
 	Cards clubs = _engine.suites_in_hand(CLUB, temp);
-	assert(clubs[0] == Card(QUEEN, CLUB)); // lowest first!
-	assert(_engine.lowest_card_that_tricks(Card(JACK, CLUB), temp) == 4); // 4=QUEEN/CLUB
-	assert(_engine.highest_card_that_tricks(Card(JACK, CLUB), temp) == 0); // 0=ACE/SPADE (_game.trump=SPADE)
-	assert(_engine.have_20(temp)[0] == CLUB);
+	CHECK(clubs[0] == Card(QUEEN, CLUB)); // lowest first!
+	CHECK(_engine.lowest_card_that_tricks(Card(JACK, CLUB), temp) == 4); // 4=QUEEN/CLUB
+	CHECK(_engine.highest_card_that_tricks(Card(JACK, CLUB), temp) == 0); // 0=ACE/SPADE (_game.trump=SPADE)
+	CHECK(_engine.have_20(temp)[0] == CLUB);
 	_game.trump = CLUB;
-	assert(_engine.have_40(temp)[0] == CLUB);
+	CHECK(_engine.have_40(temp)[0] == CLUB);
 	_game.trump = HEART;
-	assert(_engine.highest_card_that_tricks(Card(JACK, CLUB), temp) == 2); // 2=TEN/CLUB (_game.trump=HEART)
+	CHECK(_engine.highest_card_that_tricks(Card(JACK, CLUB), temp) == 2); // 2=TEN/CLUB (_game.trump=HEART)
 	_game.trump = DIAMOND;
-	assert(_engine.highest_card_that_tricks(Card(JACK, CLUB), temp) == 2); // 2=TEN/CLUB (_game.trump=DIAMOND)
+	CHECK(_engine.highest_card_that_tricks(Card(JACK, CLUB), temp) == 2); // 2=TEN/CLUB (_game.trump=DIAMOND)
 
 	temp = _game.cards;
 	_game.cards.clear();
@@ -74,10 +163,10 @@ bool Unittest::run()
 	_player.deck = "|T♣|";
 	_ai.deck = "|A♣|";
 	res = _engine.highest_cards_of_suite_in_hand(c3, CLUB);
-	assert(res.size() == 2 && (res[0] == Card(KING, CLUB)) && (res[1] == Card(QUEEN, CLUB)));
+	CHECK(res.size() == 2 && (res[0] == Card(KING, CLUB)) && (res[1] == Card(QUEEN, CLUB)));
 	_ai.deck.clear();
 	res = _engine.highest_cards_of_suite_in_hand(c3, CLUB);
-	assert(res.size() == 0);
+	CHECK(res.size() == 0);
 	_player.deck.clear();
 
 	Cards c4("|A♦|T♦|K♦|Q♦|J♦|");
@@ -85,7 +174,7 @@ bool Unittest::run()
 	_ai.deck = "|T♣|K♣|K♥|Q♥|";
 	_game.cards.clear();
 	res = _engine.highest_cards_in_hand(c4);
-	assert(res.size() == 5);
+	CHECK(res.size() == 5);
 	_ai.deck.clear();
 	_player.deck.clear();
 
@@ -95,7 +184,7 @@ bool Unittest::run()
 	_game.trump = HEART;
 	_game.cards = "|J♣|A♥|"; // game trump is Ace of hearts, so player hold highest hearts too
 	res = _engine.highest_cards_in_hand(c5);
-	assert(res == "|T♥|K♥|K♣|Q♣|");
+	CHECK(res == "|T♥|K♥|K♣|Q♣|");
 	_ai.deck.clear();
 	_player.deck.clear();
 	_game.cards = temp;
@@ -106,69 +195,925 @@ bool Unittest::run()
 	Cards p1("|A♠|Q♥|Q♦|Q♣|J♣|");
 	Cards a1("|K♠|Q♠|K♥|K♦|A♣|");
 	Cards pull = _engine.pull_trump_cards(a1, p1);
-	assert(pull.size() == 0);
+	CHECK(pull.size() == 0);
 	_game.trump = HEART;
 	p1 = "|K♠|T♥|K♥|Q♥|K♦|";
 	a1 = "|Q♠|A♥|J♥|A♦|T♣|";
 	pull = _engine.pull_trump_cards(a1, p1);
-	assert(pull == "|T♣|");
+	CHECK(pull == "|T♣|");
 	p1 = "|J♠|T♥|K♥|Q♥|K♦|";
 	a1 = "|Q♠|A♥|J♥|A♦|T♣|";
 	pull = _engine.pull_trump_cards(a1, p1);
-	assert(pull == "|T♣|");
+	CHECK(pull == "|T♣|");
 	p1 = "|J♠|T♥|K♥|Q♥|K♣|";
 	a1 = "|Q♠|A♥|J♥|A♦|T♣|";
 	pull = _engine.pull_trump_cards(a1, p1);
-	assert(pull == "|A♦|");
+	CHECK(pull == "|A♦|");
 	_game.cards = temp;
 
 	_game.trump = SPADE;
 	Cards p2("|A♠|Q♥|Q♦|Q♣|J♣|");
-	assert(_engine.lowest_card(p2, true) == 4);
+	CHECK(_engine.lowest_card(p2, true) == 4);
 	p2 = "|J♠|Q♥|Q♦|Q♣|J♣|";
-	assert(_engine.lowest_card(p2, true) == 4);
+	CHECK(_engine.lowest_card(p2, true) == 4);
 	p2 = "|J♠|Q♥|Q♦|Q♣|K♣|";
-	assert(_engine.lowest_card(p2, false) == 0);
+	CHECK(_engine.lowest_card(p2, false) == 0);
 	_game.cards = temp;
 
-	assert(_engine.cards_to_claim(Cards("|T♥|K♥|Q♣|"), Cards("|A♠|T♠|K♠|Q♠|A♥|T♦|A♣|T♣|K♣|J♣|"), CLUB) == Cards());
-	assert(_engine.cards_to_claim(Cards("|T♥|K♥|Q♣|"), Cards("|A♠|T♠|K♠|Q♠|A♥|T♦|J♣|"), CLUB) == Cards("|Q♣|"));
-	assert(_engine.cards_to_claim(Cards("|T♥|K♥|A♣|Q♣|"), Cards("|A♠|T♠|K♠|Q♠|A♥|T♦|K♣|J♣|"), CLUB) == Cards("|A♣|"));
-	assert(_engine.cards_to_claim(Cards("|T♥|K♥|Q♣|A♣|"), Cards("|A♠|T♠|K♠|Q♠|A♥|T♦|K♣|J♣|"), CLUB) == Cards("|A♣|"));
-	assert(_engine.cards_to_claim(Cards("|T♥|K♥|A♣|K♣|"), Cards("|A♠|T♠|K♠|Q♠|A♥|T♦|J♣|"), CLUB) == Cards("|A♣|"));
-	assert(_engine.cards_to_claim(Cards("|T♥|A♥|A♣|K♣|"), Cards("|A♠|K♠|Q♠|Q♥|T♦|J♣|")) == Cards("|A♥|A♣|"));
-	assert(_engine.cards_to_claim(Cards("|T♥|A♦|A♣|K♣|"), Cards("|A♠|K♠|Q♠|Q♥|T♦|J♣|")) == Cards("|A♦|A♣|T♥|"));
-//	assert(_engine.cards_to_claim(Cards("|A♠|Q♠|A♥|T♥|Q♥|"), Cards("|K♠|J♠|T♦|A♣|T♣|K♣|Q♣|J♣|")) == Cards("|A♠|Q♠|")); // WRONG
-	assert(_engine.cards_to_claim(Cards("|A♠|Q♠|A♥|T♥|Q♥|"), Cards("|K♠|J♠|T♦|A♣|T♣|K♣|Q♣|J♣|")) == Cards("|A♠|"));	// OK
-	assert(_engine.cards_to_claim(Cards("|T♠|Q♠|A♣|"), Cards("|A♠|K♠|Q♥|")) == Cards());
+	CHECK(_engine.cards_to_claim(Cards("|T♥|K♥|Q♣|"), Cards("|A♠|T♠|K♠|Q♠|A♥|T♦|A♣|T♣|K♣|J♣|"), CLUB) == Cards());
+	CHECK(_engine.cards_to_claim(Cards("|T♥|K♥|Q♣|"), Cards("|A♠|T♠|K♠|Q♠|A♥|T♦|J♣|"), CLUB) == Cards("|Q♣|"));
+	CHECK(_engine.cards_to_claim(Cards("|T♥|K♥|A♣|Q♣|"), Cards("|A♠|T♠|K♠|Q♠|A♥|T♦|K♣|J♣|"), CLUB) == Cards("|A♣|"));
+	CHECK(_engine.cards_to_claim(Cards("|T♥|K♥|Q♣|A♣|"), Cards("|A♠|T♠|K♠|Q♠|A♥|T♦|K♣|J♣|"), CLUB) == Cards("|A♣|"));
+	CHECK(_engine.cards_to_claim(Cards("|T♥|K♥|A♣|K♣|"), Cards("|A♠|T♠|K♠|Q♠|A♥|T♦|J♣|"), CLUB) == Cards("|A♣|"));
+	CHECK(_engine.cards_to_claim(Cards("|T♥|A♥|A♣|K♣|"), Cards("|A♠|K♠|Q♠|Q♥|T♦|J♣|")) == Cards("|A♥|A♣|"));
+	CHECK(_engine.cards_to_claim(Cards("|T♥|A♦|A♣|K♣|"), Cards("|A♠|K♠|Q♠|Q♥|T♦|J♣|")) == Cards("|A♦|A♣|T♥|"));
+//	CHECK(_engine.cards_to_claim(Cards("|A♠|Q♠|A♥|T♥|Q♥|"), Cards("|K♠|J♠|T♦|A♣|T♣|K♣|Q♣|J♣|")) == Cards("|A♠|Q♠|")); // WRONG
+	CHECK(_engine.cards_to_claim(Cards("|A♠|Q♠|A♥|T♥|Q♥|"), Cards("|K♠|J♠|T♦|A♣|T♣|K♣|Q♣|J♣|")) == Cards("|A♠|"));	// OK
+	CHECK(_engine.cards_to_claim(Cards("|T♠|Q♠|A♣|"), Cards("|A♠|K♠|Q♥|")) == Cards());
 
 	_game.trump = SPADE;
 	Cards acards("|T♦|K♦|J♦|T♣|K♣|");
 	Cards pcards("|A♦|Q♦|T♥|A♣|J♣|");
 	Cards move = _engine.closed_lead_no_trick(acards, pcards);
-	assert(move == "|K♦|K♣|");
+	CHECK(move == "|K♦|K♣|");
 	pcards = "|A♦|Q♦|T♥|A♥|J♣|";
 	move = _engine.closed_lead_no_trick(acards, pcards);
-	assert(move == "|K♦|");
+	CHECK(move == "|K♦|");
 	pcards = "|A♦|Q♦|T♥|Q♣|J♣|"; // not allowed because trick possible
 	move = _engine.closed_lead_no_trick(acards, pcards);
-	assert(move == "|K♦|K♣|");	// nevertheless ok
+	CHECK(move == "|K♦|K♣|");	// nevertheless ok
 
 	Cards tcards("|T♦|K♦|J♦|T♣|K♦|K♣|");
 	tcards &= Card(KING, DIAMOND); // remove (all instances of this) card from set
-	assert(tcards == "|T♦|J♦|T♣|K♣|");
+	CHECK(tcards == "|T♦|J♦|T♣|K♣|");
 
 	tcards = "|T♦|K♦|J♦|T♣|K♦|T♣|K♣|";
 	tcards &= Cards("|K♦|T♣|"); // remove (all instances of this) cards from set
-	assert(tcards == "|T♦|J♦|K♣|");
+	CHECK(tcards == "|T♦|J♦|K♣|");
 
 	tcards = "|T♦|J♦|K♦|T♣|K♣|";
 	tcards -= Cards("|K♦|T♣|"); // remove single cards from set
-	assert(tcards == "|T♦|J♦|K♣|");
+	CHECK(tcards == "|T♦|J♦|K♣|");
+
+	// end game solver
+	{
+		GameData game;
+		PlayerData player;
+		PlayerData ai;
+		game.trump = SPADE;
+		game.closed = AUTO;
+		game.move = PLAYER;
+		player.cards = "|A♣|J♥|";
+		player.deck = "|T♦|K♦|";
+		player.score = 60;
+		ai.cards = "|K♥|Q♥|";
+		ai.deck = "|T♣|K♣|";
+		ai.score = 40;
+		Solver solver;
+		Solver::Position pos = Solver::position(game, player, ai);
+		CHECK(solver.solve(pos) == 1);
+		for (auto &[card, value] : solver.evaluate(pos))
+			CHECK(value == (card == Solver::index(Card(ACE, CLUB)) ? 1 : -1));
+
+		game.closed = BY_PLAYER;
+		player.cards = "|J♣|";
+		player.score = 50;
+		ai.cards = "|Q♣|";
+		pos = Solver::position(game, player, ai);
+		CHECK(solver.solve(pos) == -2);	// closed and not enough
+
+		// position before a played 20
+		game.closed = AUTO;
+		game.marriage = MARRIAGE_20;
+		player.cards = "|K♥|T♣|";
+		player.card = Card(QUEEN, HEART);
+		player.move_state = ON_TABLE;
+		player.score = 30;
+		ai.cards = "|A♣|J♣|T♥|";
+		pos = Solver::position(game, player, ai);
+		CHECK(pos.score[0] == 10 && pos.table == -1);
+		CHECK(pos.hand[0] == ((1u << Solver::index(Card(QUEEN, HEART))) |
+		                       (1u << Solver::index(Card(KING, HEART))) |
+		                       (1u << Solver::index(Card(TEN, CLUB)))));
+	}
+
+	{
+		// statistics store: journal, compaction, interrupted writes
+		std::string name = (std::filesystem::temp_directory_path() / "Unittest.sta").string();
+		std::error_code ec;
+		for (int g = 0; g < 4; g++)
+			std::filesystem::remove(name + "." + std::to_string(g), ec);
+		std::filesystem::remove(name, ec);
+		StatsStore stats(name);
+		CHECK(stats.load() && stats.counter(StatsStore::AI_GAMES_WON) == 0);
+		for (size_t i = 0; i < StatsStore::COMPACT + 2; i++)
+			stats.add(StatsStore::AI_GAMES_WON);
+		for (int i = 0; i < 12; i++)
+			stats.add({ { i, 0 }, { 1, 2 } });
+		CHECK(stats.journal_size() == 14 && stats.gamebooks().size() == StatsStore::GAMEBOOKS);
+		{
+			// incomplete last entry (crash while writing)
+			std::ofstream ofs(name + ".1", std::ios::binary | std::ios::app);
+			ofs << "ai_games_won+=1";
+		}
+		StatsStore reloaded(name);
+		CHECK(reloaded.load() && reloaded.counter(StatsStore::AI_GAMES_WON) == (int64_t)StatsStore::COMPACT + 2);
+		CHECK(reloaded.gamebooks() == stats.gamebooks() && reloaded.gamebooks().front()[0].first == 2);
+		CHECK(reloaded.compact() && reloaded.journal_size() == 0 && !std::filesystem::exists(name + ".1"));
+		StatsStore compacted(name);
+		CHECK(compacted.load() && compacted.counter(StatsStore::AI_GAMES_WON) == (int64_t)StatsStore::COMPACT + 2);
+		CHECK(compacted.gamebooks() == stats.gamebooks());
+		std::filesystem::remove(name, ec);
+		std::filesystem::remove(name + ".2", ec);
+	}
+
+	{
+		// game record index: queries and statistics of a small archive, index file round trip
+		std::string name = (std::filesystem::temp_directory_path() / "Unittest.rec").string();
+		std::string idx = GameIndex::file(name);
+		std::error_code ec;
+		std::filesystem::remove(name, ec);
+		std::filesystem::remove(idx, ec);
+		struct Game
+		{
+			Result result;
+			Closed closed;
+			int points[2];
+			CardSuite trump;
+			std::vector<GameLog::Event> events;
+		};
+		const GameLog::Event ai_closes{ GameLog::Type::CLOSE, (uint8_t)AI, 0 };
+		const Game games[] =
+		{
+			{ Result::PLAYER_WINS_AI_CLOSED_NOT_ENOUGH, BY_AI, { 2, 0 }, HEART,
+			  { { GameLog::Type::MARRIAGE, (uint8_t)PLAYER, (uint8_t)HEART }, ai_closes } },
+			{ Result::AI_WINS_CLOSED_GAME, BY_AI, { 0, 1 }, SPADE, { ai_closes } },
+			{ Result::PLAYER_WINS_AI_CLOSED_NOT_ENOUGH, BY_AI, { 3, 0 }, CLUB, { ai_closes } },
+			{ Result::AI_WINS_BY_SCORE, NOT, { 0, 2 }, HEART,
+			  { { GameLog::Type::MARRIAGE, (uint8_t)PLAYER, (uint8_t)HEART } } },
+			{ Result::PLAYER_WINS_CLOSED_GAME, BY_PLAYER, { 1, 0 }, DIAMOND,
+			  { { GameLog::Type::MARRIAGE, (uint8_t)AI, (uint8_t)SPADE },
+			    { GameLog::Type::CLOSE, (uint8_t)PLAYER, 0 } } }
+		};
+		for (size_t i = 0; i < std::size(games); i++)
+		{
+			GameRecord rec;
+			rec.game.cards = Cards::fullcards();
+			rec.game.trump = games[i].trump;
+			rec.events = games[i].events;
+			rec.result = games[i].result;
+			rec.points[0] = games[i].points[0];
+			rec.points[1] = games[i].points[1];
+			CHECK(GameRecordWriter(name, i < 4 ? 7 : 9).write(rec));
+		}
+		GameIndex index;
+		CHECK(index.load(idx) && index.size() == std::size(games));
+		auto keys = [](std::initializer_list<const char *> specs_)
+		{
+			std::vector<int> res;
+			for (const char *spec : specs_)
+				res.push_back(GameIndex::key(spec).value_or(-1));
+			return res;
+		};
+		CHECK(!GameIndex::key("closed=maybe") && !GameIndex::key("winner") && !GameIndex::key("result=9"));
+		CHECK(!GameIndex::key("points=pl:4") && !GameIndex::key("points=pl") && !GameIndex::key("points=xx:1"));
+		// "AI lost after closing"
+		GameIndex::Bitmap sel = index.select(keys({ "closed=ai", "winner=pl" }));
+		GameIndex::Stats stats = index.stats(sel);
+		CHECK(sel.size() == 1 && sel[0] == 0b101);
+		CHECK(stats.games == 2 && stats.wins[0] == 2 && stats.wins[1] == 0 && stats.points[0] == 5);
+		// "win rate when holding 40"
+		stats = index.stats(index.select(keys({ "40=pl" })));
+		CHECK(stats.games == 2 && stats.wins[0] == 1 && stats.points[0] == 2 && stats.points[1] == 2);
+		CHECK(index.select(keys({ "20=ai" }))[0] == 0b10000);
+		CHECK(index.select(keys({ "20=pl" }))[0] == 0);
+		CHECK(index.select(keys({ "trump=h", "result=4" }))[0] == 0);
+		CHECK(index.select(keys({ "trump=h", "result=2" }))[0] == 0b1000);
+		CHECK(index.select(keys({ "closed=not" }))[0] == 0b1000);
+		// "games won with 3 points" (and the other point keys)
+		CHECK(index.select(keys({ "points=pl:3" }))[0] == 0b100);
+		CHECK(index.select(keys({ "points=pl:2" }))[0] == 0b1 && index.select(keys({ "points=pl:1" }))[0] == 0b10000);
+		CHECK(index.select(keys({ "points=ai:1" }))[0] == 0b10 && index.select(keys({ "points=ai:2" }))[0] == 0b1000);
+		CHECK(index.select(keys({ "points=ai:3" }))[0] == 0);
+		stats = index.stats(index.select(keys({ "points=pl:2", "closed=ai" })));
+		CHECK(stats.games == 1 && stats.points[0] == 2);
+		CHECK(index.select({}, 9)[0] == 0b10000 && index.select({}, 8)[0] == 0);
+		stats = index.stats(index.select({}));
+		CHECK(stats.games == 5 && stats.wins[0] == 3 && stats.wins[1] == 2);
+
+		// entries locate their records
+		GameRecordReader reader(name);
+		for (size_t i = 0; i < index.size(); i++)
+		{
+			GameRecord rec;
+			CHECK(reader.read_at(index[i].offset, rec) && rec.result == games[i].result &&
+			      rec.points[0] == games[i].points[0] && rec.game.trump == games[i].trump);
+		}
+
+		// store and load, rebuild from the records
+		std::string copy = idx + ".copy";
+		std::filesystem::remove(copy, ec);
+		for (size_t i = 0; i < index.size(); i++)
+			CHECK(GameIndex::append(copy, index[i]));
+		GameIndex loaded;
+		CHECK(loaded.load(copy) && loaded.size() == index.size());
+		CHECK(GameIndex::rebuild(name, 7) == std::size(games));
+		GameIndex rebuilt;
+		CHECK(rebuilt.load(idx) && rebuilt.size() == index.size());
+		for (size_t i = 0; i < index.size(); i++)
+		{
+			const GameIndex::Entry &e = index[i];
+			for (const GameIndex::Entry *x : { &loaded[i], &rebuilt[i] })
+			{
+				CHECK(x->offset == e.offset && x->result == e.result && x->closed == e.closed &&
+				      x->trump == e.trump && x->s20_40 == e.s20_40 &&
+				      x->points[0] == e.points[0] && x->points[1] == e.points[1]);
+			}
+			CHECK(loaded[i].build == e.build && rebuilt[i].build == 7);
+		}
+		CHECK(rebuilt.select({}, 9)[0] == 0);
+		std::filesystem::remove(copy, ec);
+		std::filesystem::remove(idx, ec);
+		std::filesystem::remove(name, ec);
+	}
+
+	{
+		// image rotation kernel against per pixel rotation (RGB, RGBA, odd sizes, line stride)
+		std::mt19937 gen(42);
+		const int sizes[][2] = { { 1, 1 }, { 5, 3 }, { 8, 8 }, { 37, 53 }, { 64, 96 }, { 75, 112 } };
+		for (int d = 3; d <= 4; d++)
+		{
+			for (auto [w, h] : sizes)
+			{
+				std::vector<uint8_t> src(w * h * d);
+				for (auto &b : src)
+					b = gen();
+				std::vector<uint8_t> expected, rotated(w * h * d);
+				rotate_pixelwise(src, expected, w, h, d);
+				CardImage::rotate_90_CCW(src.data(), rotated.data(), w, h, d);
+				CHECK(rotated == expected);
+				std::vector<uint8_t> padded((w * d + 5) * h);
+				for (int y = 0; y < h; y++)
+					std::copy_n(&src[y * w * d], w * d, &padded[y * (w * d + 5)]);
+				std::fill(rotated.begin(), rotated.end(), 0);
+				CardImage::rotate_90_CCW(padded.data(), rotated.data(), w, h, d, w * d + 5);
+				CHECK(rotated == expected);
+			}
+		}
+	}
+
+	{
+		// animation scheduler: easing, concurrent animations, skipped frames
+		for (auto e : { Animator::Easing::LINEAR, Animator::Easing::EASE_IN_OUT, Animator::Easing::EASE_OUT })
+		{
+			CHECK(Animator::ease(e, 0.) == 0. && Animator::ease(e, 1.) == 1.);
+			for (int i = 0; i < 10; i++)
+				CHECK(Animator::ease(e, i / 10.) <= Animator::ease(e, (i + 1) / 10.));
+		}
+		Animator animator(0.01);
+		Animator::Clock::time_point t0 = Animator::Clock::now();
+		size_t a = animator.add(t0, 0.1, Animator::Easing::LINEAR);
+		size_t b = animator.add(t0, 0.1, Animator::Easing::LINEAR, 0.05);
+		auto at = [&](double s_) { return t0 + std::chrono::duration_cast<Animator::Clock::duration>(std::chrono::duration<double>(s_)); };
+		animator.frame(at(0.));
+		CHECK(animator.running() && animator.progress(a) == 0. && animator.progress(b) == 0.);
+		animator.frame(at(0.01));
+		animator.frame(at(0.06));	// slow frame: 4 frames skipped
+		CHECK(animator.progress(a) > 0.5 && animator.progress(a) < 0.7 && animator.progress(b) < 0.2);
+		CHECK(animator.stats().frames == 3 && animator.stats().skipped == 4);
+		animator.frame(at(0.2));
+		CHECK(!animator.running() && animator.progress(a) == 1. && animator.progress(b) == 1.);
+		animator.frame(at(0.21));
+		CHECK(animator.stats().frames == 4);
+	}
+
+	{
+		// game flow coroutines: nested tasks, driven headless by resuming
+		Flow::Resumer resumer;
+		Flow::Task<int> flow = flow_steps(resumer, 1000);
+		flow.start();
+		int resumed = 0;
+		while (!flow.done())
+		{
+			CHECK(resumer.waiting());
+			resumer.resume();
+			resumed++;
+		}
+		CHECK(resumed == 1000 && !resumer.waiting() && flow.result() == 999000);
+		Flow::Task<int> fail = flow_steps(resumer, -1);
+		fail.start();
+		bool thrown = false;
+		try { fail.result(); } catch (const std::runtime_error &) { thrown = true; }
+		CHECK(fail.done() && thrown);
+	}
+
+	{
+		// fiber: synchronous code strictly alternating with the flow, which awaits its tasks
+		Flow::Resumer resumer;
+		Flow::Fiber fiber;
+		std::vector<int> order;
+		bool inside = true;
+		auto steps = [&]()
+		{
+			inside = inside && fiber.inside();
+			for (int i = 0; i < 3; i++)
+			{
+				order.push_back(i);
+				fiber.suspend([&, i]() -> Flow::Task<>
+				{
+					inside = inside && !fiber.inside();
+					co_await resumer.wait();
+					order.push_back(10 + i);
+				});
+			}
+		};
+		Flow::Task<> flow = fiber.run(steps);
+		flow.start();
+		while (!flow.done() && resumer.waiting())
+			resumer.resume();
+		CHECK(flow.done() && inside && !fiber.inside());
+		CHECK(order == std::vector<int>({ 0, 10, 1, 11, 2, 12 }));
+
+		// exception of a task is thrown in the fiber, exception of the fiber in the flow
+		bool caught = false;
+		Flow::Task<> fail = fiber.run([&]()
+		{
+			try
+			{
+				fiber.suspend([]() -> Flow::Task<> { throw std::runtime_error("task"); co_return; });
+			}
+			catch (const std::runtime_error &)
+			{
+				caught = true;
+			}
+			throw std::logic_error("fiber");
+		});
+		fail.start();
+		bool thrown = false;
+		try { fail.result(); } catch (const std::logic_error &) { thrown = true; }
+		CHECK(fail.done() && caught && thrown);
+
+		// flow destroyed while awaiting a task: fiber is cancelled and joined
+		bool continued = false;
+		{
+			Flow::Task<> cancel = fiber.run([&]()
+			{
+				fiber.suspend([&]() -> Flow::Task<> { co_await resumer.wait(); });
+				continued = true;
+			});
+			cancel.start();
+			CHECK(!cancel.done() && resumer.waiting());
+		}
+		CHECK(!continued && !fiber.inside());
+	}
+
+	{
+		// game flow headless: a full game through the UI interface (injected resumer/clock)
+		Flow::Resumer resumer;
+		GameData game;
+		game.cards = Cards::fullcards();
+		PlayerData player;
+		PlayerData ai;
+		HeadlessUI ui(resumer, game, player, ai);
+		GameLog log;
+		std::vector<ReviewMove> moves;
+		GameFlow flow(game, player, ai, ui.engine(), log, moves, ui);
+		for (Player first : { PLAYER, AI })
+		{
+			ui.engine().init();
+			moves.clear();
+			int player_won = player.games_won;
+			int ai_won = ai.games_won;
+			size_t tricks = ui.tricks();
+			Flow::Task<bool> task = flow.game(first);
+			task.start();
+			int resumed = 0;
+			while (!task.done() && resumer.waiting() && resumed < 1000)
+			{
+				resumer.resume();
+				resumed++;
+			}
+			CHECK(task.done() && task.result() && resumed > 10);
+			Result res = ui.engine().test_end();
+			CHECK(res != Result::NO_WIN && player.games_won + ai.games_won == player_won + ai_won + 1);
+			CHECK(ui.winner() == (int)(player.games_won > player_won ? PLAYER : AI));
+			size_t logged = std::count_if(log.events().begin(), log.events().end(),
+				[](const GameLog::Event &e_) { return e_.type == GameLog::Type::TRICK; });
+			CHECK(ui.tricks() - tricks == logged && logged >= 3 && moves.size() >= 2 * logged);
+			CHECK(player.cards.size() + player.deck.size() + ai.cards.size() + ai.deck.size() +
+			      game.cards.size() + (player.move_state != NONE) + (ai.move_state != NONE) == 20);
+		}
+		CHECK(ui.clock() > 0);
+	}
+
+	{
+		// asynchronous log: concurrent producers (ring buffer wraps), stop while pushing,
+		// every message written once and in order per thread
+		std::string name = (std::filesystem::temp_directory_path() / "Unittest.log").string();
+		std::string loglevel = Util::config("loglevel");
+		std::string logfile = Util::config("logfile");
+		Util::config("loglevel", "0");	// (log file only)
+		Util::config("logfile", "2");
+		const int producers = 4;
+		const int messages = 3000;
+		for (int round = 0; round < 10; round++)
+		{
+			{
+				auto log = std::make_unique<Log>(name);
+				std::vector<std::thread> threads;
+				for (int t = 0; t < producers; t++)
+				{
+					threads.emplace_back([&log, t]()
+					{
+						for (int i = 0; i < messages; i++)
+							log->push(Log::DEBUG, std::to_string(t) + " " + std::to_string(i) + "\n");
+					});
+				}
+				if (round % 2)
+					std::this_thread::sleep_for(std::chrono::microseconds(100 * round));
+				log->stop();
+				for (auto &t : threads)
+					t.join();
+			}
+			std::ifstream ifs(name);
+			std::vector<int> next(producers);
+			bool ordered = true;
+			int t, i;
+			while (ifs >> t >> i)
+			{
+				if (t < 0 || t >= producers || next[t] != i)
+					ordered = false;
+				else
+					next[t]++;
+			}
+			CHECK(ordered && std::count(next.begin(), next.end(), messages) == producers);
+		}
+		Util::config("loglevel", loglevel);
+		Util::config("logfile", logfile);
+		std::error_code ec;
+		std::filesystem::remove(name, ec);
+	}
+
+	{
+		// appearing text: byte lengths by display length as the former text(),
+		// for markup, incomplete markup and multibyte UTF-8
+		UI ui;
+		std::mt19937 gen(50);
+		std::vector<std::string> texts = {
+			"", "Das ist ein Test", "Das ist ein ^|Test", "Das ^bist^@ ein Test ^",
+			"Das ist ein Test ^|1234|", "👍Das ist ein 😴 Test",
+			"Das ist ^|9999| ein Test ^|1234|", "^|a|^bx", "^", "^|", "^|ä|ä^ä",
+			"Ümläute 😄" };
+		const char *parts[] = { "a", " ", "^", "|", "^|", "^|x|", "^b", "ä", "♥", "😄" };
+		for (int i = 0; i < 500; i++)
+		{
+			std::string m;
+			for (int n = gen() % 12; n > 0; n--)
+				m += parts[gen() % std::size(parts)];
+			texts.push_back(m);
+		}
+		bool same = true;
+		for (const std::string &m : texts)
+		{
+			AnimText text(m, ui);
+			const std::vector<size_t> &offsets = text.offsets();
+			for (size_t len = 0; len <= offsets.size(); len++)
+			{
+				if (offsets[std::min(len, offsets.size() - 1)] != anim_text_length(m, len))
+					same = false;
+			}
+		}
+		CHECK(same);
+		AnimText text("Ü^|123|x^b😄", ui);
+		CHECK(text.offsets() == std::vector<size_t>({ 0, 8, 11, 15 }));
+	}
+
+	_game.trump = trump;
+	if (_failed == 0)
+		LOG("Unittests run successfully.\n");
+	return _failed == 0;
+}
+
+/*static*/
+void Unittest::random_end_game(std::mt19937 &gen_, GameData &game_, PlayerData &player_, PlayerData &ai_)
+{
+	//
+	// Random position with pack exhausted, AI to move (lead or follow).
+	//
+	Cards cards = Cards::fullcards();
+	std::shuffle(cards.begin(), cards.end(), gen_);
+	size_t hand = 1 + gen_() % 5;
+	player_ = PlayerData();
+	ai_ = PlayerData();
+	game_.cards.clear();
+	game_.trump = CardSuite(gen_() % 4);
+	game_.closed = AUTO;
+	game_.marriage = NO_MARRIAGE;
+	game_.move = AI;
+	for (size_t i = 0; i < hand; i++)
+	{
+		player_.cards.push_back(cards[i]);
+		ai_.cards.push_back(cards[hand + i]);
+	}
+	for (size_t i = 2 * hand; i < cards.size(); i += 2)
+	{
+		PlayerData &winner = gen_() % 2 ? player_ : ai_;
+		winner.deck.push_back(cards[i]);
+		winner.deck.push_back(cards[i + 1]);
+	}
+	player_.score = player_.deck.value();
+	ai_.score = ai_.deck.value();
+	if (gen_() % 2)
+	{
+		// player has led
+		player_.card = player_.cards.back();
+		player_.cards.pop_back();
+		player_.move_state = ON_TABLE;
+	}
+	ai_.move_state = MOVING;
+}
+
+bool Unittest::properties(size_t iterations_)
+{
+	//
+	// Randomized tests against straightforward reference implementations
+	// of the rules. Each test stops at its first failure.
+	//
+	std::mt19937 gen(20260101);
+	const Cards all = Cards::fullcards();
+	CardSuite trump = _game.trump;
+	int failed = _failed;
+	auto rank = [](const Card &c_) -> int
+	{
+		switch (c_.face())
+		{
+			case JACK:  return 0;
+			case QUEEN: return 1;
+			case KING:  return 2;
+			case TEN:   return 3;
+			default:    return 4;
+		}
+	};
+	auto count = [](const Cards &cards_, const Card &c_) -> int
+	{
+		return std::count_if(cards_.begin(), cards_.end(),
+			[&](const Card &c) { return c.face() == c_.face() && c.suite() == c_.suite(); });
+	};
+	auto random_cards = [&](size_t max_) -> Cards
+	{
+		// may contain duplicates
+		Cards res;
+		for (size_t n = gen() % (max_ + 1); n; n--)
+			res.push_back(all[gen() % all.size()]);
+		return res;
+	};
+
+	// Cards algebra (multiset semantics)
+	for (size_t i = 0; i < iterations_ / 10 && _failed == failed; i++)
+	{
+		Cards a = random_cards(10);
+		Cards b = random_cards(10);
+		Cards sum = a + b;
+		Cards diff = a - b;
+		Cards removed(a);
+		removed &= b;
+		Cards merged(a);
+		merged |= b;
+		CHECK(sum.size() == a.size() + b.size());
+		CHECK(sum.value() == a.value() + b.value());
+		CHECK((a - a).empty());
+		for (auto &c : all)
+		{
+			CHECK(count(sum, c) == count(a, c) + count(b, c));
+			CHECK(count(diff, c) == std::max(0, count(a, c) - count(b, c)));
+			CHECK(count(removed, c) == (count(b, c) ? 0 : count(a, c)));
+			CHECK(count(merged, c) == (count(b, c) ? 1 : count(a, c)));
+		}
+		Cards sorted(a);
+		sorted.sort();
+		Cards twice(sorted);
+		twice.sort();
+		CHECK(sorted.size() == a.size() && sorted == twice);
+		if (a.size())
+		{
+			std::ostringstream os;
+			a.printOn(os);
+			CHECK(Cards(os.str()) == a);
+		}
+	}
+
+	// legal moves (closed state) against the rules
+	for (size_t i = 0; i < iterations_ && _failed == failed; i++)
+	{
+		Cards deck(all);
+		std::shuffle(deck.begin(), deck.end(), gen);
+		_game.trump = CardSuite(gen() % 4);
+		const Card &lead = deck[0];
+		Cards hand(Cards_(deck.begin() + 1, deck.begin() + 2 + gen() % 5));
+		bool has_suite = false;
+		bool has_higher = false;
+		bool has_trump = false;
+		for (auto &c : hand)
+		{
+			has_suite |= c.suite() == lead.suite();
+			has_higher |= c.suite() == lead.suite() && rank(c) > rank(lead);
+			has_trump |= c.suite() == _game.trump;
+		}
+		Cards moves = _engine.legal_moves(hand, lead);
+		for (auto &c : moves)
+			CHECK(count(hand, c) == 1);
+		for (auto &c : hand)
+		{
+			bool legal = true;
+			if (has_higher) legal = c.suite() == lead.suite() && rank(c) > rank(lead);
+			else if (has_suite) legal = c.suite() == lead.suite();
+			else if (has_trump) legal = c.suite() == _game.trump;
+			CHECK(count(moves, c) == (legal ? 1 : 0));
+		}
+	}
+
+	// trick resolution, also against the solver
+	Solver solver;
+	for (size_t i = 0; i < iterations_ && _failed == failed; i++)
+	{
+		_game.trump = CardSuite(gen() % 4);
+		size_t l = gen() % all.size();
+		size_t f = (l + 1 + gen() % (all.size() - 1)) % all.size();
+		const Card &lead = all[l];
+		const Card &follow = all[f];
+		bool follow_wins = follow.suite() == lead.suite() ? rank(follow) > rank(lead) : follow.suite() == _game.trump;
+		CHECK(_engine.card_tricks(follow, lead) == follow_wins);
+		CHECK(!(_engine.card_tricks(follow, lead) && _engine.card_tricks(lead, follow)));
+
+		// last trick: the solver's game result tells the winner of the trick
+		Solver::Position pos{};
+		pos.hand[(int)AI] = 1u << Solver::index(follow);
+		pos.trump = _game.trump;
+		pos.closed = AUTO;
+		pos.move = AI;
+		pos.table = Solver::index(lead);
+		CHECK((solver.solve(pos) > 0) == follow_wins);
+	}
+
+	// engine plays a legal card from its hand
+	for (size_t i = 0; i < iterations_ / 100 && _failed == failed; i++)
+	{
+		GameData game;
+		PlayerData player;
+		PlayerData ai;
+		random_end_game(gen, game, player, ai);
+		UI ui;
+		Engine engine(game, player, ai, ui);
+		Cards hand = ai.cards;
+		Cards moves = player.move_state == ON_TABLE ? engine.legal_moves(hand, player.card) : hand;
+		engine.ai_move();
+		CHECK(ai.move_state == ON_TABLE && ai.cards.size() + 1 == hand.size());
+		CHECK(count(moves, ai.card) == 1);
+	}
+
+	// game log replays self played games
+	SelfPlay self_play{ EngineParams(), EngineParams() };
+	for (size_t i = 0; i < iterations_ / 1000 && _failed == failed; i++)
+	{
+		self_play.game(i, i % 2 ? AI : PLAYER);
+		Util::quiet() = false;
+		GameLog log(self_play.log());
+		GameData game;
+		PlayerData player;
+		PlayerData ai;
+		CHECK(log.replay(log.size(), game, player, ai));
+		const GameData &g = self_play.game();
+		const PlayerData &p = self_play.player();
+		const PlayerData &a = self_play.ai();
+		CHECK(game.cards == g.cards && game.trump == g.trump && game.closed == g.closed && game.move == g.move);
+		CHECK(player.cards == p.cards && player.deck == p.deck && player.s20_40 == p.s20_40);
+		CHECK(player.score == p.score && player.pending == p.pending && player.score_closed == p.score_closed);
+		CHECK(ai.cards == a.cards && ai.deck == a.deck && ai.s20_40 == a.s20_40);
+		CHECK(ai.score == a.score && ai.pending == a.pending && ai.score_closed == a.score_closed);
+		size_t ply = gen() % (log.size() + 1);
+		CHECK(log.replay(ply, game, player, ai) && log.ply() == ply);
+		size_t cards = game.cards.size() + player.cards.size() + player.deck.size() + ai.cards.size() + ai.deck.size() +
+		               (player.move_state == ON_TABLE) + (ai.move_state == ON_TABLE);
+		CHECK(cards == 20);
+
+		// ... also from a binary game record
+		GameRecord rec;
+		rec.from_log(log, Result(i % 9), { i % 4, 0 });
+		CHECK(GameIndex::entry(rec, 0, 0).closed == g.closed);
+		std::string buf;
+		rec.encode(buf);
+		GameRecord dec;
+		CHECK(dec.decode((const uint8_t *)buf.data(), buf.size()));
+		CHECK(dec.result == rec.result && dec.points[0] == rec.points[0] && dec.events.size() == rec.events.size());
+		GameData game2;
+		PlayerData player2;
+		PlayerData ai2;
+		CHECK(dec.replay(dec.events.size(), game2, player2, ai2));
+		CHECK(game2.cards == g.cards && game2.closed == g.closed && game2.move == g.move);
+		CHECK(player2.deck == p.deck && player2.score == p.score && player2.s20_40 == p.s20_40);
+		CHECK(ai2.deck == a.deck && ai2.score == a.score && ai2.s20_40 == a.s20_40);
+
+		// position of any ply encodes and decodes unchanged
+		rec.game = game;
+		rec.player = player;
+		rec.ai = ai;
+		buf.clear();
+		rec.encode(buf);
+		CHECK(dec.decode((const uint8_t *)buf.data(), buf.size()));
+		CHECK(dec.game.cards == game.cards && dec.game.trump == game.trump && dec.game.marriage == game.marriage);
+		CHECK(dec.player.cards == player.cards && dec.player.deck == player.deck && dec.player.pending == player.pending);
+		CHECK(dec.ai.cards == ai.cards && dec.ai.deck == ai.deck && dec.ai.score_closed == ai.score_closed);
+		CHECK(dec.player.move_state == player.move_state && dec.ai.move_state == ai.move_state);
+		CHECK(player.move_state != ON_TABLE || dec.player.card == player.card);
+		CHECK(ai.move_state != ON_TABLE || dec.ai.card == ai.card);
+
+		// ... also step by step (as in replay mode)
+		CHECK(log.replay(0, game, player, ai));
+		UI ui;
+		Engine engine(game, player, ai, ui);
+		Util::quiet() = true;
+		while (log.step(game, player, ai, engine, ui));
+		Util::quiet() = false;
+		CHECK(log.ply() == log.size() && game.cards == g.cards && game.move == g.move);
+		CHECK(player.deck == p.deck && player.score == p.score && ai.deck == a.deck && ai.score == a.score);
+	}
 
 	_game.trump = trump;
-	LOG("Unittests run successfully.\n");
-	return true;
+	if (_failed == failed)
+		LOG("Property tests run successfully (" << iterations_ << " iterations).\n");
+	return _failed == failed;
+}
+
+/*static*/
+Flow::Task<int> Unittest::flow_step(Flow::Resumer &resumer_, int value_)
+{
+	co_await resumer_.wait();
+	co_return value_ * 2;
+}
+
+/*static*/
+Flow::Task<int> Unittest::flow_steps(Flow::Resumer &resumer_, int n_)
+{
+	if (n_ < 0)
+		throw std::runtime_error("invalid steps");
+	int sum = 0;
+	for (int i = 0; i < n_; i++)
+		sum += co_await flow_step(resumer_, i);
+	co_return sum;
+}
+
+/*static*/
+size_t Unittest::anim_text_length(const std::string &m_, size_t display_len_)
+{
+	// reference: the former byte length computation of AnimText::text()
+	std::string m(m_);
+	size_t pos = m.find("^|");
+	while (pos != std::string::npos)
+	{
+		size_t end = m.find('|', pos + 2);
+		if (end == std::string::npos)
+		{
+			m.erase(pos);
+		}
+		else
+		{
+			m.erase(pos, end - pos + 1);
+			m.insert(pos, std::string(end - pos + 1, '~'));
+		}
+		pos = m.find("^|");
+	}
+	pos = m.find('^');
+	while (pos != std::string::npos)
+	{
+		if (pos + 1 == m.size())
+			m.erase(pos);
+		else
+		{
+			m[pos] = '~';
+			m[pos + 1] = '~';
+		}
+		pos = m.find('^');
+	}
+	size_t utf8_len = 0;
+	size_t len = display_len_;
+	while (len > 0 && utf8_len < m.size())
+	{
+		utf8_len += fl_utf8len1(m[utf8_len]);
+		while (m[utf8_len] == '~')
+			utf8_len++;
+		len--;
+	}
+	while (m[utf8_len] == '~')
+		utf8_len++;
+	return utf8_len;
+}
+
+/*static*/
+void Unittest::rotate_pixelwise(const std::vector<uint8_t> &src_, std::vector<uint8_t> &dst_, int w_, int h_, int d_)
+{
+	// reference: the former per pixel rotation of rotate_90_CCW()
+	dst_.resize(src_.size());
+	uint8_t alpha = 0;
+	for (int y = 0; y < h_; y++)
+	{
+		for (int x = 0; x < w_; x++)
+		{
+			auto get_offset = [](int w, [[maybe_unused]]int h, int x, int y, int d) -> size_t
+			{
+				return w * y * d + x * d;
+			};
+			size_t offset = get_offset(w_, h_, x, y, d_);
+			uint8_t r = src_[offset];
+			uint8_t g = src_[offset + 1];
+			uint8_t b = src_[offset + 2];
+			if (d_ > 3)
+				alpha = src_[offset + 3];
+
+			offset = get_offset(h_, w_, h_ - y - 1, x, d_);
+			dst_[offset]     = r;
+			dst_[offset + 1] = g;
+			dst_[offset + 2] = b;
+			if (d_ > 3)
+				dst_[offset + 3] = alpha;
+		}
+	}
+}
+
+void Unittest::benchmarks()
+{
+	//
+	// Micro benchmarks of the engine primitives.
+	//
+	std::mt19937 gen(4711);
+	size_t sink = 0;	// keep results alive
+	auto bench = [&](const char *name_, size_t n_, auto f_)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < n_; i++)
+			f_(i);
+		std::chrono::duration<double, std::nano> diff = std::chrono::steady_clock::now() - start;
+		OUT(name_ << ": " << diff.count() / n_ << "ns\n");
+	};
+	const Cards all = Cards::fullcards();
+	std::vector<Cards> hands;
+	for (int i = 0; i < 64; i++)
+	{
+		Cards deck(all);
+		std::shuffle(deck.begin(), deck.end(), gen);
+		hands.push_back(Cards_(deck.begin(), deck.begin() + 5));
+	}
+	struct Position
+	{
+		GameData game;
+		PlayerData player;
+		PlayerData ai;
+	};
+	std::vector<Position> positions(64);
+	for (auto &p : positions)
+		random_end_game(gen, p.game, p.player, p.ai);
+
+	CardSuite trump = _game.trump;
+	_game.trump = HEART;
+	bench("Card::value", 10000000, [&](size_t i_) { sink += all[i_ % 20].value(); });
+	bench("Engine::card_tricks", 10000000, [&](size_t i_) { sink += _engine.card_tricks(all[i_ % 20], all[(i_ * 7 + 3) % 20]); });
+	bench("Cards copy", 1000000, [&](size_t i_) { Cards c(hands[i_ % 64]); sink += c.size(); });
+	bench("Cards operator -", 1000000, [&](size_t i_) { sink += (all - hands[i_ % 64]).size(); });
+	bench("Cards::sort", 1000000, [&](size_t i_) { Cards c(hands[i_ % 64]); sink += c.sort().size(); });
+	bench("Engine::legal_moves", 1000000, [&](size_t i_) { sink += _engine.legal_moves(hands[i_ % 64], all[i_ % 20]).size(); });
+	bench("Engine::cards_to_claim", 100000, [&](size_t i_) { sink += _engine.cards_to_claim(hands[i_ % 64], all - hands[i_ % 64]).size(); });
+	_game.trump = trump;
+	bench("Engine::ai_move (end game)", 100000, [&](size_t i_)
+	{
+		Position p(positions[i_ % 64]);
+		UI ui;
+		Engine engine(p.game, p.player, p.ai, ui);
+		sink += engine.ai_move().value();
+	});
+	bench("Solver::solve (end game)", 10000, [&](size_t i_)
+	{
+		const Position &p = positions[i_ % 64];
+		Solver solver;
+		sink += solver.solve(Solver::position(p.game, p.player, p.ai)) + 4;
+	});
+
+	//
+	// Image rotation at card sizes (per pixel vs. blocked kernel).
+	//
+	for (int d = 4; d >= 3; d--)
+	{
+		for (int w : { 75, 150, 300, 600 })
+		{
+			int h = w * 3 / 2;
+			std::vector<uint8_t> src(w * h * d), dst(w * h * d);
+			for (auto &b : src)
+				b = gen();
+			std::string name = "rotate " + std::to_string(w) + "x" + std::to_string(h) + (d == 4 ? " RGBA" : " RGB");
+			size_t n = 20000000 / (w * h) + 1;
+			bench((name + " (per pixel)").c_str(), n, [&](size_t) { rotate_pixelwise(src, dst, w, h, d); sink += dst[0]; });
+			bench((name + " (kernel)").c_str(), n, [&](size_t) { CardImage::rotate_90_CCW(src.data(), dst.data(), w, h, d); sink += dst[0]; });
+		}
+	}
+	OUT("(checksum " << sink << ")\n");
 }
 
 #ifdef STANDALONE
@@ -178,13 +1123,29 @@ namespace Schnapsen
 	int debug = 0;
 };
 #include "Util.cxx"
+#include "Config.cxx"
+#include "Log.cxx"
+#include "Trace.cxx"
+#include "Animator.cxx"
+#include "AnimText.cxx"
 #include "Card.cxx"
 #include "CardImage.cxx"
 #include "Cards.cxx"
+#include "EngineParams.cxx"
+#include "EngineStats.cxx"
 #include "Engine.cxx"
+#include "GameLog.cxx"
+#include "GameRecord.cxx"
+#include "GameIndex.cxx"
+#include "StatsStore.cxx"
+#include "SelfPlay.cxx"
+#include "Solver.cxx"
+#include "GameFlow.cxx"
 #include "UI.h"
-int main()
+int main(int argc_, char *argv_[])
 {
+	size_t iterations = argc_ > 1 && argv_[1][0] != '-' ? atoi(argv_[1]) : 1000000;
+	bool bench = argc_ > 1 && std::string(argv_[argc_ - 1]) == "-b";
 	PlayerData player;
 	PlayerData ai;
 	GameData game;
@@ -193,6 +1154,15 @@ int main()
 	Engine engine(game, player, ai, ui);
 	Unittest ut(game, player, ai, engine);
 	ut.run();
+	ut.properties(iterations);
+	if (ut.failed())
+	{
+		OUT(APPLICATION << ": " << ut.failed() << " FAILED\n");
+		return EXIT_FAILURE;
+	}
 	OUT(APPLICATION << ": SUCCESS\n");
+	if (bench)
+		ut.benchmarks();
+	return EXIT_SUCCESS;
 }
 #endif
@@ -14,6 +14,7 @@ constexpr char APPLICATION[] = "DrawTest";
 #include <FL/filename.H>
 #include <FL/fl_draw.H>
 #include <FL/Fl_Shared_Image.H>
+#include <FL/Fl_SVG_Image.H>
 #include <FL/Fl_Window.H>
 #include <FL/Fl.H>
 
@@ -25,13 +26,15 @@ constexpr char APPLICATION[] = "DrawTest";
 #include <stdexcept>
 #include <cstdlib> // atoi(), getenv()
 #include <cmath>
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <string_view>
+#include <vector>
 
 // config values (from fltk-schnapsen.cfg)
 string_map config = {};
 
-// statistic values (from fltk-schnapsen.sta)
-string_map stats = {};
-
 
 /*static*/
 const std::string& Util::home_dir()
@@ -105,6 +108,12 @@ std::string Util::sta_file()
 	return home_dir() + APPLICATION + ".sta";
 };
 
+/*static*/
+std::string Util::rec_file()
+{
+	return home_dir() + APPLICATION + ".rec";
+};
+
 /*static*/
 std::string Util::cardset_dir(std::string name_/* = "*/)
 {
@@ -125,12 +134,6 @@ string_map& Util::config()
 	return ::config;
 }
 
-/*static*/
-string_map& Util::stats()
-{
-	return ::stats;
-}
-
 /*static*/
 const std::string& Util::config(const std::string &id_)
 {
@@ -157,24 +160,16 @@ void Util::config(const std::string &id_, const std::string &value_)
 		config().erase(id_);
 	else
 		config()[id_] = value_;
+	Config::update(id_);
 }
 
-const std::string& Util::stats(const std::string &id_)
-{
-	return stats()[id_];
-}
-
-int Util::stats_as_int(const std::string &id_)
-{
-	return atoi(stats()[id_].c_str());
-}
 
-void Util::stats(const std::string &id_, const std::string &value_)
+/*static*/
+bool& Util::quiet()
 {
-	if (value_.empty())
-		stats().erase(id_);
-	else
-		stats()[id_] = value_;
+	// suppress logging of the calling thread (e.g. for headless self play)
+	static thread_local bool quiet = false;
+	return quiet;
 }
 
 void Util::load_values_from_file(std::ifstream &if_, string_map &values_, const std::string& id_)
@@ -200,14 +195,10 @@ void Util::load_values_from_file(std::ifstream &if_, string_map &values_, const
 
 void Util::load_config()
 {
+	TRACE("Util::load_config");
 	std::ifstream cfg(cfg_file());
 	load_values_from_file(cfg, ::config, "cfg");
-}
-
-void Util::load_stats()
-{
-	std::ifstream stat(sta_file());
-	load_values_from_file(stat, ::stats, "stat");
+	Config::sync();
 }
 
 void Util::save_values_to_file(std::ofstream &of_, const string_map &values_, const std::string &id_)
@@ -222,17 +213,12 @@ void Util::save_values_to_file(std::ofstream &of_, const string_map &values_, co
 
 void Util::save_config()
 {
+	TRACE("Util::save_config");
 	Util::config("cards", std::string()); // don't save cards string!
 	std::ofstream cfg(cfg_file(), std::ios::binary);
 	save_values_to_file(cfg, ::config, "cfg");
 }
 
-void Util::save_stats()
-{
-	std::ofstream stat(sta_file(), std::ios::binary);
-	save_values_to_file(stat, ::stats, "stat");
-}
-
 const std::string& Util::message(const Message m_)
 {
 #ifdef _WIN32
@@ -251,7 +237,7 @@ const std::string& Util::message(const Message m_)
 	};
 #endif
 
-	std::string lang = ::config["lang"];
+	const std::string &lang = Config::as_string(Config::LANG);
 	if (lang.empty())
 	{
 		static std::string locale_name;
@@ -282,214 +268,494 @@ const std::string& Util::message(const Message m_)
 			}
 			DBG("locale_name: '" << locale_name << "'\n");
 		}
-		lang = locale_name;
-		config("lang", lang);
+		config("lang", locale_name);
 	}
 	auto &m = lang.empty() || lang == "de" ? messages_de : messages_en;
 	return m[m_];
 }
 
-/*static*/
-void Util::draw_color_text(const std::string &text_, int x_, int y_,
-                           [[maybe_unused]]bool shadow_/* = false*/,
-                           const std::map<char, Fl_Color> &colors_/* = text_colors*/)
+static int is_mono_font()
+{
+	if (fl_width(' ') == fl_width('M'))
+		return ceil(fl_width(' '));
+	return 0;
+}
+
+static void draw_text(const char *text_, int x_, int y_, [[maybe_unused]]Fl_Color def_color_,
+                      [[maybe_unused]]bool shadow_)
 {
-	Fl_Color def_color = fl_color();
-	auto draw_text = [&](const char *text_, int x_, int y_) -> void
-	{
 #if defined(_WIN32) || defined(USE_IMAGE_TEXT)
-		if (shadow_)
+	if (shadow_)
+	{
+		// not suitable when emojis are in the text string!
+		bool text_shadow = Config::as_bool(Config::TEXT_SHADOW);
+		uchar r, g, b;
+		Fl::get_color(def_color_, r, g, b);
+		// no shadow with too dark colors (looks bad)
+		if (text_shadow && (r > 64 || g > 64 || b > 64))
 		{
-			// not suitable when emojis are in the text string!
-			static const bool text_shadow = atoi(::config["text-shadow"].c_str());
-			uchar r, g, b;
-			Fl::get_color(def_color, r, g, b);
-			// no shadow with too dark colors (looks bad)
-			if (text_shadow && (r > 64 || g > 64 || b > 64))
-			{
-				// draws a text "shadow" by drawing text with offset first in GRAY
-				int delta = fl_height() / 30 + 1;
-				Fl_Color save = fl_color();
-				fl_color(fl_rgb_color(64, 64, 64));
-				fl_draw(text_, x_ + delta, y_ + delta);
-				fl_color(save);
-			}
+			// draws a text "shadow" by drawing text with offset first in GRAY
+			int delta = fl_height() / 30 + 1;
+			Fl_Color save = fl_color();
+			fl_color(fl_rgb_color(64, 64, 64));
+			fl_draw(text_, x_ + delta, y_ + delta);
+			fl_color(save);
 		}
+	}
 #endif
-		fl_draw(text_, x_, y_);
+	fl_draw(text_, x_, y_);
+}
+
+namespace {
+
+//
+// Symbol images of the text markup (^|name| for rsc/name.svg).
+// They are rasterized into one strip image per symbol size (atlas),
+// drawing blits the part of the symbol. Each symbol is rasterized
+// once per size, when it is drawn first in this size. The atlases of
+// the last few sizes are kept.
+//
+struct SymbolAtlas
+{
+	struct Cell
+	{
+		int x = 0;
+		int w = 0;		// 0 = not yet rasterized
 	};
-	std::string text(text_);
-	while (text.size())
+	int sw;			// size of symbol box (from font height)
+	int sh;
+	int width = 0;
+	std::vector<uchar> pixels;	// RGBA, width x sh
+	std::vector<Cell> cells;	// by symbol id
+	Fl_RGB_Image *image = nullptr;
+	SymbolAtlas(int sw_, int sh_) : sw(sw_), sh(sh_) {}
+	~SymbolAtlas() { delete image; }
+	SymbolAtlas(const SymbolAtlas &) = delete;
+	SymbolAtlas &operator = (const SymbolAtlas &) = delete;
+};
+
+struct Symbols
+{
+	static constexpr size_t SIZES = 4;
+	std::unordered_map<std::string, int> ids;
+	std::vector<std::unique_ptr<Fl_SVG_Image>> sources;	// by id (nullptr: not found)
+	std::list<SymbolAtlas> atlases;				// most recently used first
+	Util::SymbolStats stats;
+
+	int id(const std::string &name_)
 	{
-		size_t pos = text.find('^');
-		if (pos != std::string::npos)
+		// symbol id (-1 if there is no image)
+		auto it = ids.find(name_);
+		if (it == ids.end())
 		{
-			std::string t = text.substr(0, pos);
-			if (t.size())
-			{
-				draw_text(t.c_str(), x_, y_);
-				x_ += fl_width(t.c_str());
-			}
-			if (pos + 1 >= text.size()) break;
-			char c = text[pos + 1];
-			auto it = colors_.find(c);
-			if (it == colors_.end())
-				fl_color(def_color);
-			else
-				fl_color(it->second);
-			text = text.substr(pos + 2);
+			std::unique_ptr<Fl_SVG_Image> svg(new Fl_SVG_Image((Util::rsc_dir() + name_ + ".svg").c_str()));
+			if (svg->fail() || svg->w() <= 0 || svg->h() <= 0)
+				svg.reset();
+			it = ids.emplace(name_, (int)sources.size()).first;
+			sources.push_back(std::move(svg));
 		}
-		else
+		return sources[it->second] ? it->second : -1;
+	}
+
+	void size(int id_, int sw_, int sh_, int &w_, int &h_) const
+	{
+		// fit into box keeping aspect ratio (as Fl_Image::scale())
+		const Fl_SVG_Image &svg = *sources[id_];
+		float f = std::max(svg.data_w() / (float)sw_, svg.data_h() / (float)sh_);
+		w_ = std::max((int)(svg.data_w() / f), 1);
+		h_ = std::max((int)(svg.data_h() / f), 1);
+	}
+
+	SymbolAtlas &atlas(int sw_, int sh_)
+	{
+		for (auto it = atlases.begin(); it != atlases.end(); ++it)
 		{
-			draw_text(text.c_str(), x_, y_);
-			break;
+			if (it->sw != sw_ || it->sh != sh_) continue;
+			if (it != atlases.begin())
+				atlases.splice(atlases.begin(), atlases, it);
+			return atlases.front();
 		}
+		atlases.emplace_front(sw_, sh_);
+		if (atlases.size() > SIZES)
+			atlases.pop_back();
+		return atlases.front();
 	}
-}
 
-static int is_mono_font()
-{
-	if (fl_width(' ') == fl_width('M'))
-		return ceil(fl_width(' '));
-	return 0;
-}
+	void add(SymbolAtlas &atlas_, int id_)
+	{
+		//
+		// Rasterize symbol and append it to the strip.
+		//
+		int w, h;
+		size(id_, atlas_.sw, atlas_.sh, w, h);
+		Fl_SVG_Image *svg = static_cast<Fl_SVG_Image *>(sources[id_]->copy());
+		svg->proportional = false;
+		svg->resize(w, h);
+		svg->normalize();
+		int width = atlas_.width + w;
+		std::vector<uchar> pixels((size_t)width * atlas_.sh * 4);
+		const uchar *src = (const uchar *)svg->data()[0];
+		int d = svg->d();
+		int ld = svg->ld() ? svg->ld() : w * d;
+		for (int y = 0; y < atlas_.sh; y++)
+		{
+			uchar *row = &pixels[(size_t)y * width * 4];
+			if (atlas_.width)
+				std::copy_n(&atlas_.pixels[(size_t)y * atlas_.width * 4], atlas_.width * 4, row);
+			if (y >= h) continue;
+			uchar *dst = row + atlas_.width * 4;
+			for (int x = 0; x < w; x++, dst += 4)
+			{
+				const uchar *p = src + y * ld + x * d;
+				dst[0] = p[0];
+				dst[1] = d > 1 ? p[1] : p[0];
+				dst[2] = d > 2 ? p[2] : p[0];
+				dst[3] = d == 4 ? p[3] : d == 2 ? p[1] : 0xff;
+			}
+		}
+		delete svg;
+		if (atlas_.cells.size() <= (size_t)id_)
+			atlas_.cells.resize(id_ + 1);
+		atlas_.cells[id_] = { atlas_.width, w };
+		atlas_.width = width;
+		atlas_.pixels = std::move(pixels);
+		delete atlas_.image;
+		atlas_.image = new Fl_RGB_Image(atlas_.pixels.data(), atlas_.width, atlas_.sh, 4);
+		stats.rasterized++;
+	}
 
-/*static*/
-void Util::draw_string(int w_, const std::string &text_, int x_, int y_, bool shadow_/*= false*/)
+	void draw(int id_, int sw_, int sh_, int x_, int y_)
+	{
+		SymbolAtlas &a = atlas(sw_, sh_);
+		if (a.cells.size() <= (size_t)id_ || a.cells[id_].w == 0)
+			add(a, id_);
+		int w, h;
+		size(id_, sw_, sh_, w, h);
+		a.image->draw(x_, y_, w, h, a.cells[id_].x, 0);
+	}
+};
+
+Symbols symbols;
+
+//
+// Text with color (^c) and image (^|name|) markup laid out for the
+// current font: split into runs with their offsets and the images
+// looked up, so drawing needs no parsing or measuring.
+// Colors change the current color like fl_color(), an unknown color
+// restores the color at begin of the segment (text between images).
+//
+struct TextRun
+{
+	enum Type : uint8_t { SEGMENT, TEXT, COLOR, RESET, IMAGE };
+	explicit TextRun(Type type_, int x_ = 0, int y_ = 0) : type(type_), x(x_), y(y_) {}
+	Type type;
+	int x;					// offset from origin (TEXT, IMAGE)
+	int y;
+	Fl_Color color = 0;			// (COLOR)
+	std::string text;			// (TEXT)
+	int symbol = -1;			// (IMAGE)
+	int sw = 0, sh = 0;			// symbol box size
+};
+
+struct TextLayout
 {
-	draw_string(text_, x_ + (w_ - string_width(text_)) / 2, y_, shadow_);
-}
+	std::vector<TextRun> runs;
+	int w = 0;
+	int h = 0;
+	void layout(const std::string &text_);
+	void draw(int x_, int y_, bool shadow_) const;
+};
 
-/*static*/
-void Util::draw_string(const std::string &text_, int x_, int y_, bool shadow_/*= false*/)
+struct TextKey
 {
-	// NOTE: fl_draw(str, x, y) does not handle control characters under WIN32
-	//       so we need to split lines at '\n' ourselves...
+	std::string_view text;
+	Fl_Font font;
+	Fl_Fontsize size;
+};
 
-	auto draw_line = [&](std::string line) -> void
+void TextLayout::layout(const std::string &text_)
+{
+	//
+	// Positions are accumulated as by drawing piece by piece, the
+	// width is measured over the whole line (see Util::string_size()).
+	//
+	int mono_width = is_mono_font();
+	auto layout_segment = [&](const std::string &text_, int x_, int y_)
+	{
+		runs.emplace_back(TextRun::SEGMENT);
+		std::string text(text_);
+		while (text.size())
+		{
+			size_t pos = text.find('^');
+			std::string t = text.substr(0, pos);
+			if (t.size())
+			{
+				runs.emplace_back(TextRun::TEXT, x_, y_);
+				runs.back().text = t;
+				x_ += fl_width(t.c_str());
+			}
+			if (pos == std::string::npos || pos + 1 >= text.size()) break;
+			auto it = text_colors.find(text[pos + 1]);
+			runs.emplace_back(it == text_colors.end() ? TextRun::RESET : TextRun::COLOR);
+			if (it != text_colors.end())
+				runs.back().color = it->second;
+			text = text.substr(pos + 2);
+		}
+	};
+	auto strip = [](std::string text_)
+	{
+		size_t pos;
+		while ((pos = text_.find('^')) != std::string::npos)
+			text_.erase(pos, 2);
+		return text_;
+	};
+	auto layout_line = [&](std::string line_, int y_) -> int
 	{
-		size_t image_pos;
 		int dx = 0;
-		int mono_width = is_mono_font();
-		while ((image_pos = line.find("^|")) != std::string::npos)
+		int lw = 0;
+		std::string measure;
+		size_t image_pos;
+		while ((image_pos = line_.find("^|")) != std::string::npos)
 		{
-			std::string sub = line.substr(0, image_pos);
-			draw_color_text(sub, x_ + dx, y_, shadow_);
-			size_t pos;
-			while ((pos = sub.find('^')) != std::string::npos)
-				sub.erase(pos, 2);
-			dx += fl_width(sub.c_str());
-			line.erase(0, image_pos + 2);
-			size_t end_image = line.find('|');
+			std::string sub = line_.substr(0, image_pos);
+			layout_segment(sub, dx, y_);
+			measure += sub;
+			dx += fl_width(strip(sub).c_str());
+			line_.erase(0, image_pos + 2);
+			size_t end_image = line_.find('|');
 			if (end_image == std::string::npos) continue;
-			std::string image_name = line.substr(0, end_image);
-			image_name += ".svg";
-			Fl_Image *img = get_shared_image(image_name, fl_height() - fl_descent() / 2, fl_height() - fl_descent(), true);
-			if (img != nullptr)
+			std::string image_name = line_.substr(0, end_image);
+			int sw = fl_height() - fl_descent() / 2;
+			int sh = fl_height() - fl_descent();
+			int symbol = symbols.id(image_name);
+			if (symbol >= 0)
 			{
-//				DBG("Symbol " << image_name << ": " << img->w() << "x" << img->h() << " fl_height=" << fl_height() << ", fl_descent=" << fl_descent() << "\n");
-				img->draw(x_ + dx, y_ - fl_height() + (fl_height() - img->h()) / 2 + fl_descent());
-				int w = img->w();
+				int w, h;
+				symbols.size(symbol, sw, sh, w, h);
+				TextRun run(TextRun::IMAGE, dx, y_ - fl_height() + (fl_height() - h) / 2 + fl_descent());
+				run.symbol = symbol;
+				run.sw = sw;
+				run.sh = sh;
+				runs.push_back(run);
 				if (mono_width)
 				{
 					w += mono_width - 1;
 					w = (w / mono_width) * mono_width;
 				}
 				dx += w;
+				lw += w;
 			}
-			line.erase(0, end_image + 1);
-		}
-		if (line.size())
-		{
-			draw_color_text(line, x_ + dx, y_, shadow_);
+			line_.erase(0, end_image + 1);
 		}
+		if (line_.size())
+			layout_segment(line_, dx, y_);
+		measure += line_;
+		return lw + fl_width(strip(measure).c_str());
 	};
 
 	size_t pos;
+	int y = 0;
 	std::string text(text_);
 	while ((pos = text.find('\n')) != std::string::npos)
 	{
-		draw_line(text.substr(0, pos));
+		w = std::max(w, layout_line(text.substr(0, pos), y));
 		text.erase(0, pos + 1);
-		y_ += fl_height();
+		y += fl_height();
+		h += fl_height();
 	}
 	if (text.size())
 	{
-		draw_line(text.c_str());
+		w = std::max(w, layout_line(text, y));
+		h += fl_height();
 	}
 }
 
-/*static*/
-int Util::string_size(const std::string &text_, int &w_, int &h_)
+void TextLayout::draw(int x_, int y_, bool shadow_) const
 {
-	w_ = 0;
-	h_ = 0;
-	auto parse_line = [&](std::string line) -> int
+	Fl_Color def_color = fl_color();
+	for (const TextRun &run : runs)
+	{
+		switch (run.type)
+		{
+			case TextRun::SEGMENT:
+				def_color = fl_color();
+				break;
+			case TextRun::TEXT:
+				draw_text(run.text.c_str(), x_ + run.x, y_ + run.y, def_color, shadow_);
+				break;
+			case TextRun::COLOR:
+				fl_color(run.color);
+				break;
+			case TextRun::RESET:
+				fl_color(def_color);
+				break;
+			case TextRun::IMAGE:
+				symbols.draw(run.symbol, run.sw, run.sh, x_ + run.x, y_ + run.y);
+				break;
+		}
+	}
+}
+
+//
+// Layouts by (text, font, size). When the current generation is full
+// it becomes the previous one and the layouts not used since are
+// dropped, so transient texts (e.g. of AnimText) do not accumulate.
+//
+struct TextLayoutCache
+{
+	static constexpr size_t GENERATION = 256;
+	struct Key
 	{
-		size_t image_pos;
-		int w = 0;
-		int mono_width = is_mono_font();
 		std::string text;
-		while ((image_pos = line.find("^|")) != std::string::npos)
+		Fl_Font font;
+		Fl_Fontsize size;
+	};
+	struct Hash
+	{
+		typedef void is_transparent;
+		size_t operator () (const TextKey &k_) const
 		{
-			text += line.substr(0, image_pos);
-			line.erase(0, image_pos + 2);
-			size_t end_image = line.find('|');
-			if (end_image == std::string::npos) continue;
-			std::string image_name = line.substr(0, end_image);
-			image_name += ".svg";
-			Fl_Image *img = get_shared_image(image_name, fl_height() - fl_descent() / 2, fl_height() - fl_descent(), true);
-			if (img != nullptr)
-			{
-				int dx = img->w();
-				if (mono_width)
-				{
-					dx += mono_width - 1;
-					dx = (dx / mono_width) * mono_width;
-				}
-				w += dx;
-			}
-			line.erase(0, end_image + 1);
+			return std::hash<std::string_view>()(k_.text) ^ ((size_t)k_.font << 16 | (size_t)k_.size) * 0x9E3779B97F4A7C15ull;
+		}
+		size_t operator () (const Key &k_) const { return (*this)(TextKey{ k_.text, k_.font, k_.size }); }
+	};
+	struct Equal
+	{
+		typedef void is_transparent;
+		static TextKey view(const Key &k_) { return { k_.text, k_.font, k_.size }; }
+		static TextKey view(const TextKey &k_) { return k_; }
+		template <typename A, typename B>
+		bool operator () (const A &a_, const B &b_) const
+		{
+			TextKey a = view(a_);
+			TextKey b = view(b_);
+			return a.font == b.font && a.size == b.size && a.text == b.text;
 		}
-		text += line;
-		size_t pos;
-		while ((pos = text.find('^')) != std::string::npos)
-			text.erase(pos, 2);
-		w += fl_width(text.c_str());
-		return w;
 	};
+	typedef std::unordered_map<Key, TextLayout, Hash, Equal> Map;
+	Map current;
+	Map previous;
+	Util::TextCacheStats stats;
 
-	size_t pos;
-	std::string text(text_);
-	while ((pos = text.find('\n')) != std::string::npos)
+	const TextLayout &get(const std::string &text_)
 	{
-		int w = parse_line(text.substr(0, pos));
-		if (w > w_) w_ = w;
-		text.erase(0, pos + 1);
-		h_ += fl_height();
+		TextKey key{ text_, fl_font(), fl_size() };
+		auto it = current.find(key);
+		if (it != current.end())
+		{
+			stats.hits++;
+			return it->second;
+		}
+		if (current.size() >= GENERATION)
+		{
+			previous = std::move(current);
+			current.clear();
+		}
+		auto prev = previous.find(key);
+		if (prev != previous.end())
+		{
+			stats.hits++;
+			return current.insert(previous.extract(prev)).position->second;
+		}
+		stats.misses++;
+		TextLayout &layout = current[Key{ text_, key.font, key.size }];
+		layout.layout(text_);
+		return layout;
 	}
-	if (text.size())
+};
+
+TextLayoutCache text_layouts;
+
+}; // namespace
+
+/*static*/
+void Util::draw_color_text(const std::string &text_, int x_, int y_,
+                           bool shadow_/* = false*/,
+                           const std::map<char, Fl_Color> &colors_/* = text_colors*/)
+{
+	Fl_Color def_color = fl_color();
+	std::string text(text_);
+	while (text.size())
 	{
-		int w = parse_line(text.c_str());
-		if (w > w_) w_ = w;
-		h_ += fl_height();
+		size_t pos = text.find('^');
+		if (pos != std::string::npos)
+		{
+			std::string t = text.substr(0, pos);
+			if (t.size())
+			{
+				draw_text(t.c_str(), x_, y_, def_color, shadow_);
+				x_ += fl_width(t.c_str());
+			}
+			if (pos + 1 >= text.size()) break;
+			char c = text[pos + 1];
+			auto it = colors_.find(c);
+			if (it == colors_.end())
+				fl_color(def_color);
+			else
+				fl_color(it->second);
+			text = text.substr(pos + 2);
+		}
+		else
+		{
+			draw_text(text.c_str(), x_, y_, def_color, shadow_);
+			break;
+		}
 	}
+}
+
+/*static*/
+void Util::draw_string(int w_, const std::string &text_, int x_, int y_, bool shadow_/*= false*/)
+{
+	const TextLayout &layout = text_layouts.get(text_);
+	layout.draw(x_ + (w_ - layout.w) / 2, y_, shadow_);
+}
+
+/*static*/
+void Util::draw_string(const std::string &text_, int x_, int y_, bool shadow_/*= false*/)
+{
+	// NOTE: fl_draw(str, x, y) does not handle control characters under WIN32
+	//       so lines are split at '\n' by the layout.
+	text_layouts.get(text_).draw(x_, y_, shadow_);
+}
+
+/*static*/
+int Util::string_size(const std::string &text_, int &w_, int &h_)
+{
+	const TextLayout &layout = text_layouts.get(text_);
+	w_ = layout.w;
+	h_ = layout.h;
 	return w_;
 }
 
 /*static*/
 int Util::string_width(const std::string &text_)
 {
-	int W, H;
-	return string_size(text_, W, H);
+	return text_layouts.get(text_).w;
+}
+
+/*static*/
+void Util::clear_text_cache()
+{
+	// (after a font was changed)
+	text_layouts.current.clear();
+	text_layouts.previous.clear();
+}
+
+/*static*/
+const Util::SymbolStats &Util::symbol_stats()
+{
+	symbols.stats.sizes = symbols.atlases.size();
+	symbols.stats.bytes = 0;
+	for (const SymbolAtlas &a : symbols.atlases)
+		symbols.stats.bytes += a.pixels.size();
+	return symbols.stats;
 }
 
 /*static*/
-std::ostream& Util::logstream()
+const Util::TextCacheStats &Util::text_cache_stats()
 {
-	static std::ofstream ofs((std::filesystem::temp_directory_path().string() +
-	                          "/fltk-schnapsen.log").c_str(), std::ios::binary);
-	return ofs;
+	text_layouts.stats.entries = text_layouts.current.size() + text_layouts.previous.size();
+	return text_layouts.stats;
 }
 
 /*static*/
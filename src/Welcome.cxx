@@ -16,6 +16,7 @@ Fl_Font CustomFont = FL_HELVETICA;
 #include "Util.h"
 #include "Card.h"
 #include "AnimText.h"
+#include "Idle.h"
 
 #include <FL/Fl.H>
 #include <FL/fl_draw.H>
@@ -29,7 +30,7 @@ extern std::map<CardSuite, std::string> suite_symbols;
 static std::vector<std::string> load_texts(const std::string& name_)
 {
 	std::vector<std::string> texts;
-	std::ifstream ifs(Util::rsc_dir() + name_ + "_" + Util::config("lang") + ".txt", std::ios::binary);
+	std::ifstream ifs(Util::rsc_dir() + name_ + "_" + Config::as_string(Config::LANG) + ".txt", std::ios::binary);
 	std::string text;
 	while (std::getline(ifs, text))
 	{
@@ -54,7 +55,7 @@ Welcome::Welcome(int w_, int h_, bool saying_/* = true_*/) : Fl_Double_Window(w_
 	set_modal();
 	box(FL_UP_BOX);
 	color(FL_WHITE);
-	redraw_timer(this);
+	Idle::repeat(0.2, redraw_timer, this);
 
 	static std::vector<std::string> sayings{load_texts("sayings")};
 	if (sayings.size() && saying_)
@@ -68,7 +69,7 @@ Welcome::Welcome(int w_, int h_, bool saying_/* = true_*/) : Fl_Double_Window(w_
 Welcome::~Welcome()
 {
 	delete _saying;
-	Fl::remove_timeout(redraw_timer, this);
+	Idle::remove(redraw_timer, this);
 }
 
 void Welcome::update()
@@ -80,12 +81,13 @@ void Welcome::update()
 void Welcome::redraw_timer(void *d_)
 {
 	(static_cast<Welcome *>(d_))->redraw();
-	Fl::add_timeout(0.2, redraw_timer, d_);
 }
 
 int Welcome::handle(int e_)
 {
 	if (e_ == FL_NO_EVENT) return 1;
+	if (e_ == FL_MOVE)
+		Idle::input();
 	if (e_ == FL_PUSH || e_ == FL_KEYDOWN)
 	{
 		hide();
@@ -212,6 +214,10 @@ void Welcome::draw()
 #include "CardImage.cxx"
 #include "Card.cxx"
 #include "Util.cxx"
+#include "Config.cxx"
+#include "Log.cxx"
+#include "Trace.cxx"
+#include "Idle.cxx"
 #include "AnimText.cxx"
 int main(int argc_, char *argv_[])
 {